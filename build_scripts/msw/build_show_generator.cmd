@@ -0,0 +1,6 @@
+cd ..
+cd ..
+cd show_generator
+
+cmake -S. -Bcmake_vs -G"Visual Studio 17 2022"
+cmake --build cmake_vs --config Release
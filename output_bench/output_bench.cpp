@@ -0,0 +1,653 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+// Listens for E1.31, ArtNet and DDP on the local machine, reassembles the frames
+// xLights (or xlDo) sends, optionally checks them against the .fseq they came from
+// and reports packet rates, frame completeness, frame jitter and sync timing.
+// Point the controllers in a show at 127.0.0.1 to measure the output path without
+// any real hardware.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <spdlog/fmt/fmt.h>
+
+#include "spdlog/spdlog.h"
+#include <argparse/argparse.hpp>
+
+#include "git_version.h"
+
+#include "outputs/SocketAbstraction.h"
+#include "render/FSEQFile.h"
+#include "utils/FastHash.h"
+
+#ifndef _WIN32
+#include <sys/select.h>
+#endif
+
+#define E131_PORT 5568
+#define ARTNET_PORT 6454
+#define DDP_PORT 4048
+
+#define E131_HEADERLEN 126
+#define ARTNET_HEADERLEN 18
+#define DDP_HEADERLEN 10
+
+using Clock = std::chrono::steady_clock;
+
+static std::atomic_bool stopRequested = false;
+
+static void OnSignal(int) {
+    stopRequested = true;
+}
+
+enum class Protocol {
+    E131 = 0,
+    ARTNET = 1,
+    DDP = 2
+};
+static const char* ProtocolNames[] = { "e131", "artnet", "ddp" };
+
+struct ProtocolStats {
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    uint64_t syncPackets = 0;
+    uint64_t ignored = 0; // malformed or not mapped to any channel
+    uint64_t sequenceErrors = 0;
+    std::map<uint32_t, uint8_t> lastSequence;
+};
+
+// Keeps every sample so exact percentiles can be reported. Runs are short enough for this to be fine.
+struct Samples {
+    std::vector<int64_t> values;
+
+    void Add(int64_t v) { values.push_back(v); }
+    bool Empty() const { return values.empty(); }
+
+    int64_t Percentile(double pct) {
+        if (values.empty()) return 0;
+        std::sort(values.begin(), values.end());
+        size_t idx = (size_t)((pct / 100.0) * (values.size() - 1) + 0.5);
+        return values[std::min(idx, values.size() - 1)];
+    }
+    double Mean() const {
+        if (values.empty()) return 0;
+        double total = 0;
+        for (auto v : values) total += v;
+        return total / values.size();
+    }
+    std::string ToJSON() {
+        return fmt::format("{{\"count\": {}, \"meanUs\": {:.1f}, \"p50Us\": {}, \"p99Us\": {}, \"maxUs\": {}}}",
+                           values.size(), Mean(), Percentile(50), Percentile(99), Percentile(100));
+    }
+    std::string ToString() {
+        return fmt::format("mean {:.1f}us p50 {}us p99 {}us max {}us ({} samples)",
+                           Mean(), Percentile(50), Percentile(99), Percentile(100), values.size());
+    }
+};
+
+// Random access to the reference sequence with a small cache as most lookups are the
+// frame just matched or the one after it. Every frame is hashed up front so a frame
+// that is out of order can be found without comparing it against the whole sequence.
+class ReferenceSequence {
+public:
+    bool Open(const std::string& filename) {
+        _fseq.reset(FSEQFile::openFSEQFile(filename));
+        if (_fseq == nullptr) return false;
+        std::vector<std::pair<uint32_t, uint32_t>> ranges;
+        ranges.emplace_back(0, (uint32_t)_fseq->getChannelCount());
+        _fseq->prepareRead(ranges);
+        BuildIndex();
+        return true;
+    }
+
+    bool IsOpen() const { return _fseq != nullptr; }
+    uint32_t NumFrames() const { return _fseq ? (uint32_t)_fseq->getNumFrames() : 0; }
+    uint32_t ChannelCount() const { return _fseq ? (uint32_t)_fseq->getChannelCount() : 0; }
+    int StepTime() const { return _fseq ? _fseq->getStepTime() : 0; }
+
+    const std::vector<uint8_t>& GetFrame(uint32_t frame) {
+        auto it = _cache.find(frame);
+        if (it != _cache.end()) return it->second;
+
+        if (_cache.size() >= 8) {
+            _cache.erase(_cache.begin());
+        }
+        auto& buf = _cache[frame];
+        buf.resize(ChannelCount());
+        FSEQFile::FrameData* fd = _fseq->getFrame(frame);
+        if (fd != nullptr) {
+            fd->readFrame(buf.data(), (uint32_t)buf.size());
+            delete fd;
+        }
+        return buf;
+    }
+
+    // Frames whose hash matches, the caller still has to compare the data
+    auto FindFrames(uint64_t hash) const { return _index.equal_range(hash); }
+
+private:
+    void BuildIndex() {
+        _index.clear();
+        _index.reserve(NumFrames());
+        std::vector<uint8_t> buf(ChannelCount());
+        for (uint32_t frame = 0; frame < NumFrames(); frame++) {
+            std::fill(buf.begin(), buf.end(), 0);
+            FSEQFile::FrameData* fd = _fseq->getFrame(frame);
+            if (fd != nullptr) {
+                fd->readFrame(buf.data(), (uint32_t)buf.size());
+                delete fd;
+            }
+            _index.emplace(FastHash::Hash64(buf.data(), buf.size()), frame);
+        }
+    }
+
+    std::unique_ptr<FSEQFile> _fseq;
+    std::map<uint32_t, std::vector<uint8_t>> _cache;
+    std::unordered_multimap<uint64_t, uint32_t> _index;
+};
+
+class FrameAssembler {
+public:
+    FrameAssembler(ReferenceSequence& reference, int stepTimeMS) :
+        _reference(reference), _stepTimeMS(stepTimeMS) {}
+
+    // key identifies the universe/packet slot; seeing it twice means the frame is over
+    void AddData(uint32_t key, uint32_t offset, const uint8_t* data, size_t length, Clock::time_point now) {
+        if (_keys.count(key) != 0) {
+            CloseFrame(now, false);
+        }
+        if (_keys.empty()) {
+            _firstPacket = now;
+        }
+        _keys.insert(key);
+        _lastPacket = now;
+
+        if (offset + length > _data.size()) {
+            _data.resize(offset + length);
+        }
+        memcpy(&_data[offset], data, length);
+        _ranges.emplace_back(offset, (uint32_t)length);
+        _highestChannel = std::max(_highestChannel, (uint32_t)(offset + length));
+    }
+
+    void Sync(Clock::time_point now) {
+        if (!_keys.empty()) {
+            _syncLag.Add(std::chrono::duration_cast<std::chrono::microseconds>(now - _lastPacket).count());
+        }
+        if (_haveLastSync) {
+            _syncInterval.Add(std::chrono::duration_cast<std::chrono::microseconds>(now - _lastSync).count());
+        }
+        _lastSync = now;
+        _haveLastSync = true;
+        CloseFrame(now, true);
+    }
+
+    void Finish(Clock::time_point now) {
+        CloseFrame(now, false);
+    }
+
+    uint64_t Frames() const { return _frames; }
+    uint64_t CompleteFrames() const { return _completeFrames; }
+    uint64_t VerifiedFrames() const { return _verifiedFrames; }
+    uint64_t MismatchedFrames() const { return _mismatchedFrames; }
+    uint64_t UnverifiedFrames() const { return _unverifiedFrames; }
+    uint64_t SyncedFrames() const { return _syncedFrames; }
+    uint32_t ExpectedChannels() const { return _reference.IsOpen() ? _reference.ChannelCount() : _highestChannel; }
+    double MeanCompleteness() const { return _frames == 0 ? 0.0 : _completenessTotal / _frames; }
+    Samples& FrameInterval() { return _frameInterval; }
+    Samples& FrameJitter() { return _frameJitter; }
+    Samples& FrameSpread() { return _frameSpread; }
+    Samples& SyncLag() { return _syncLag; }
+    Samples& SyncInterval() { return _syncInterval; }
+
+private:
+    uint32_t CountReceived() {
+        std::sort(_ranges.begin(), _ranges.end());
+        uint32_t total = 0;
+        uint32_t end = 0;
+        for (const auto& r : _ranges) {
+            uint32_t s = std::max(r.first, end);
+            uint32_t e = r.first + r.second;
+            if (e > s) {
+                total += e - s;
+                end = e;
+            }
+        }
+        return total;
+    }
+
+    // true if the received ranges leave no gap below channel count. Anything in a gap
+    // would be left over from an earlier frame so such a frame cannot be verified.
+    bool Covers(uint32_t channels) const {
+        uint32_t end = 0;
+        for (const auto& r : _ranges) {
+            if (r.first > end) return false;
+            end = std::max(end, r.first + r.second);
+            if (end >= channels) return true;
+        }
+        return end >= channels;
+    }
+
+    bool Matches(uint32_t frame) {
+        const auto& ref = _reference.GetFrame(frame);
+        return memcmp(_data.data(), ref.data(), ref.size()) == 0;
+    }
+
+    void Verify() {
+        uint32_t const numFrames = _reference.NumFrames();
+        if (numFrames == 0) return;
+
+        // CountReceived has already sorted the ranges
+        if (!Covers(_reference.ChannelCount())) {
+            _unverifiedFrames++;
+            return;
+        }
+
+        // most of the time it is the next frame, or the same one again when paused
+        if (_lastMatched >= 0) {
+            for (int32_t candidate : { _lastMatched + 1, _lastMatched, _lastMatched + 2 }) {
+                if (candidate >= 0 && candidate < (int32_t)numFrames && Matches(candidate)) {
+                    _lastMatched = candidate;
+                    _verifiedFrames++;
+                    return;
+                }
+            }
+        }
+        auto candidates = _reference.FindFrames(FastHash::Hash64(_data.data(), _reference.ChannelCount()));
+        for (auto it = candidates.first; it != candidates.second; ++it) {
+            if (Matches(it->second)) {
+                _lastMatched = it->second;
+                _verifiedFrames++;
+                return;
+            }
+        }
+        _mismatchedFrames++;
+        if (_mismatchedFrames <= 5) {
+            spdlog::warn("Frame {} did not match any frame in the sequence.", _frames);
+        }
+    }
+
+    void CloseFrame(Clock::time_point now, bool synced) {
+        if (_keys.empty()) return;
+
+        _frames++;
+        if (synced) _syncedFrames++;
+
+        uint32_t const expected = ExpectedChannels();
+        uint32_t const received = CountReceived();
+        double const completeness = expected == 0 ? 1.0 : std::min(1.0, (double)received / expected);
+        _completenessTotal += completeness;
+        if (received >= expected) _completeFrames++;
+
+        if (_haveLastFrame) {
+            auto interval = std::chrono::duration_cast<std::chrono::microseconds>(_firstPacket - _lastFrameStart).count();
+            _frameInterval.Add(interval);
+            if (_stepTimeMS > 0) {
+                _frameJitter.Add(std::abs(interval - (int64_t)_stepTimeMS * 1000));
+            }
+        }
+        _frameSpread.Add(std::chrono::duration_cast<std::chrono::microseconds>(_lastPacket - _firstPacket).count());
+        _lastFrameStart = _firstPacket;
+        _haveLastFrame = true;
+
+        if (_reference.IsOpen()) {
+            Verify();
+        }
+
+        _keys.clear();
+        _ranges.clear();
+    }
+
+    ReferenceSequence& _reference;
+    int _stepTimeMS = 0;
+
+    std::vector<uint8_t> _data;
+    std::vector<std::pair<uint32_t, uint32_t>> _ranges;
+    std::set<uint32_t> _keys;
+    uint32_t _highestChannel = 0;
+    Clock::time_point _firstPacket;
+    Clock::time_point _lastPacket;
+    Clock::time_point _lastFrameStart;
+    bool _haveLastFrame = false;
+    Clock::time_point _lastSync;
+    bool _haveLastSync = false;
+    int32_t _lastMatched = -1;
+
+    uint64_t _frames = 0;
+    uint64_t _completeFrames = 0;
+    uint64_t _syncedFrames = 0;
+    uint64_t _verifiedFrames = 0;
+    uint64_t _mismatchedFrames = 0;
+    uint64_t _unverifiedFrames = 0; // missing channels so not compared
+    double _completenessTotal = 0;
+    Samples _frameInterval;
+    Samples _frameJitter;
+    Samples _frameSpread; // first to last packet within a frame
+    Samples _syncLag; // last data packet to sync packet
+    Samples _syncInterval;
+};
+
+struct ChannelMap {
+    uint32_t startChannel = 0; // zero based
+    int e131UniverseStart = 1;
+    int artnetUniverseStart = 0;
+    int universeSize = 510;
+};
+
+static void CheckSequence(ProtocolStats& stats, uint32_t key, uint8_t seq) {
+    auto it = stats.lastSequence.find(key);
+    if (it != stats.lastSequence.end()) {
+        uint8_t expected = it->second + 1;
+        if (seq != expected && seq != it->second) {
+            stats.sequenceErrors++;
+        }
+    }
+    stats.lastSequence[key] = seq;
+}
+
+static void HandleE131(const uint8_t* p, int len, const ChannelMap& map, ProtocolStats& stats, FrameAssembler& frames, Clock::time_point now) {
+    if (len < 22 || memcmp(&p[4], "ASC-E1.17", 9) != 0) {
+        stats.ignored++;
+        return;
+    }
+    uint32_t const rootVector = ((uint32_t)p[18] << 24) | ((uint32_t)p[19] << 16) | ((uint32_t)p[20] << 8) | p[21];
+    if (rootVector == 0x08) {
+        // extended ... 0x01 framing vector is a sync packet
+        if (len >= 47 && p[43] == 0x01) {
+            stats.syncPackets++;
+            frames.Sync(now);
+        } else {
+            stats.ignored++;
+        }
+        return;
+    }
+    if (rootVector != 0x04 || len < E131_HEADERLEN) {
+        stats.ignored++;
+        return;
+    }
+    int const universe = (p[113] << 8) | p[114];
+    int const count = ((p[123] << 8) | p[124]) - 1; // includes the start code
+    if (universe < map.e131UniverseStart || count <= 0 || E131_HEADERLEN + count > len) {
+        stats.ignored++;
+        return;
+    }
+    CheckSequence(stats, universe, p[111]);
+    uint32_t const offset = map.startChannel + (uint32_t)(universe - map.e131UniverseStart) * map.universeSize;
+    frames.AddData(((uint32_t)Protocol::E131 << 28) | universe, offset, &p[E131_HEADERLEN], count, now);
+}
+
+static void HandleArtNet(const uint8_t* p, int len, const ChannelMap& map, ProtocolStats& stats, FrameAssembler& frames, Clock::time_point now) {
+    if (len < 10 || memcmp(p, "Art-Net", 8) != 0) {
+        stats.ignored++;
+        return;
+    }
+    int const opcode = p[8] | (p[9] << 8);
+    if (opcode == 0x5200) {
+        stats.syncPackets++;
+        frames.Sync(now);
+        return;
+    }
+    if (opcode != 0x5000 || len < ARTNET_HEADERLEN) {
+        stats.ignored++;
+        return;
+    }
+    int const universe = p[14] | (p[15] << 8);
+    int const count = (p[16] << 8) | p[17];
+    if (universe < map.artnetUniverseStart || count <= 0 || ARTNET_HEADERLEN + count > len) {
+        stats.ignored++;
+        return;
+    }
+    if (p[12] != 0) {
+        CheckSequence(stats, universe, p[12]);
+    }
+    uint32_t const offset = map.startChannel + (uint32_t)(universe - map.artnetUniverseStart) * map.universeSize;
+    frames.AddData(((uint32_t)Protocol::ARTNET << 28) | universe, offset, &p[ARTNET_HEADERLEN], count, now);
+}
+
+static void HandleDDP(const uint8_t* p, int len, const ChannelMap& map, ProtocolStats& stats, FrameAssembler& frames, Clock::time_point now) {
+    if (len < DDP_HEADERLEN || (p[0] & 0xc0) != 0x40) {
+        stats.ignored++;
+        return;
+    }
+    bool const push = (p[0] & 0x01) != 0;
+    uint32_t const dataOffset = ((uint32_t)p[4] << 24) | ((uint32_t)p[5] << 16) | ((uint32_t)p[6] << 8) | p[7];
+    int const count = (p[8] << 8) | p[9];
+
+    if (count == 0) {
+        // a push with no data is the sync packet
+        if (push) {
+            stats.syncPackets++;
+            frames.Sync(now);
+        } else {
+            stats.ignored++;
+        }
+        return;
+    }
+    if (DDP_HEADERLEN + count > len) {
+        stats.ignored++;
+        return;
+    }
+    if ((p[1] & 0x0f) != 0) {
+        CheckSequence(stats, 0, p[1] & 0x0f);
+    }
+    frames.AddData(((uint32_t)Protocol::DDP << 28) | (dataOffset & 0x0fffffff), map.startChannel + dataOffset, &p[DDP_HEADERLEN], count, now);
+    if (push) {
+        frames.Sync(now);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    spdlog::set_level(spdlog::level::info);
+    argparse::ArgumentParser program("output_bench", GIT_COMMIT_HASH);
+    program.set_prefix_chars("-+/");
+
+    program.add_argument("-i", "--input").help("fseq file the received frames are verified against");
+    program.add_argument("-b", "--bind").default_value(std::string("0.0.0.0")).help("Local address to listen on");
+    program.add_argument("-p", "--protocols").default_value(std::string("e131,artnet,ddp")).help("Protocols to listen for (e131,artnet,ddp)");
+    program.add_argument("-s", "--start").default_value(1).help("Absolute channel the first universe maps to").scan<'i', int>();
+    program.add_argument("-u", "--universe").default_value(1).help("First E1.31 universe").scan<'i', int>();
+    program.add_argument("-a", "--artnet-universe").default_value(0).help("First ArtNet universe").scan<'i', int>();
+    program.add_argument("-z", "--universe-size").default_value(510).help("Channels per universe").scan<'i', int>();
+    program.add_argument("-y", "--sync-universe").default_value(0).help("E1.31 sync universe to join the multicast group for").scan<'i', int>();
+    program.add_argument("-m", "--multicast").flag().help("Join the E1.31 multicast groups for the universes covered by the sequence");
+    program.add_argument("-d", "--duration").default_value(0).help("Seconds to listen for, 0 to run until idle").scan<'i', int>();
+    program.add_argument("-t", "--idle").default_value(3).help("Stop after this many seconds without packets").scan<'i', int>();
+    program.add_argument("-f", "--frame-ms").default_value(0).help("Expected frame time if there is no fseq").scan<'i', int>();
+    program.add_argument("-j", "--json").flag().help("Print the report as JSON");
+
+    try {
+        program.parse_args(argc, argv);
+    } catch (const std::exception& err) {
+        spdlog::critical(err.what());
+        exit(EXIT_FAILURE);
+    }
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+
+    ReferenceSequence reference;
+    if (program.is_used("-i")) {
+        if (!reference.Open(program.get("-i"))) {
+            spdlog::critical("Error opening input file: {}", program.get("-i"));
+            exit(EXIT_FAILURE);
+        }
+        spdlog::info("Verifying against {}: {} frames of {} channels at {}ms.", program.get("-i"), reference.NumFrames(), reference.ChannelCount(), reference.StepTime());
+    }
+
+    ChannelMap map;
+    map.startChannel = (uint32_t)std::max(program.get<int>("-s") - 1, 0);
+    map.e131UniverseStart = program.get<int>("-u");
+    map.artnetUniverseStart = program.get<int>("-a");
+    map.universeSize = std::max(program.get<int>("-z"), 1);
+
+    int const stepTime = reference.IsOpen() ? reference.StepTime() : program.get<int>("-f");
+    FrameAssembler frames(reference, stepTime);
+    ProtocolStats stats[3];
+
+    std::string const bindIp = program.get("-b");
+    std::string const protocols = program.get("-p");
+    std::unique_ptr<sockets::UDPSocket> socks[3];
+    uint16_t const ports[3] = { E131_PORT, ARTNET_PORT, DDP_PORT };
+    for (int i = 0; i < 3; i++) {
+        if (protocols.find(ProtocolNames[i]) == std::string::npos) continue;
+        socks[i] = std::make_unique<sockets::UDPSocket>();
+        if (!socks[i]->Bind(bindIp, ports[i], true)) {
+            spdlog::critical("Unable to listen for {} on {}:{}. {}", ProtocolNames[i], bindIp, ports[i], socks[i]->LastError());
+            exit(EXIT_FAILURE);
+        }
+        spdlog::info("Listening for {} on {}:{}.", ProtocolNames[i], bindIp, ports[i]);
+    }
+
+    if (socks[(int)Protocol::E131] != nullptr) {
+        auto& e131 = socks[(int)Protocol::E131];
+        int const syncUniverse = program.get<int>("-y");
+        if (syncUniverse > 0) {
+            e131->JoinMulticast(fmt::format("239.255.{}.{}", syncUniverse >> 8, syncUniverse & 0xff));
+        }
+        if (program.get<bool>("-m") && reference.IsOpen()) {
+            int const universes = (int)((reference.ChannelCount() + map.universeSize - 1) / map.universeSize);
+            for (int u = map.e131UniverseStart; u < map.e131UniverseStart + universes; u++) {
+                e131->JoinMulticast(fmt::format("239.255.{}.{}", u >> 8, u & 0xff));
+            }
+        }
+    }
+
+    std::signal(SIGINT, OnSignal);
+#ifndef _WIN32
+    std::signal(SIGTERM, OnSignal);
+#endif
+
+    int const duration = program.get<int>("-d");
+    int const idle = program.get<int>("-t");
+    std::vector<uint8_t> buffer(65536);
+    Clock::time_point start;
+    Clock::time_point lastPacket;
+    bool started = false;
+
+    while (!stopRequested) {
+        auto const now = Clock::now();
+        if (started) {
+            if (duration > 0 && now - start > std::chrono::seconds(duration)) break;
+            if (duration == 0 && idle > 0 && now - lastPacket > std::chrono::seconds(idle)) break;
+        }
+
+        fd_set readSet;
+        FD_ZERO(&readSet);
+        sockets::SocketHandle maxHandle = 0;
+        for (const auto& s : socks) {
+            if (s == nullptr) continue;
+            FD_SET(s->GetHandle(), &readSet);
+            maxHandle = std::max(maxHandle, s->GetHandle());
+        }
+        timeval tv{ 0, 100000 };
+        int ready = select((int)maxHandle + 1, &readSet, nullptr, nullptr, &tv);
+        if (ready <= 0) continue;
+
+        for (int i = 0; i < 3; i++) {
+            if (socks[i] == nullptr || !FD_ISSET(socks[i]->GetHandle(), &readSet)) continue;
+
+            int len = socks[i]->ReceiveFrom(buffer.data(), buffer.size());
+            if (len <= 0) continue;
+
+            auto const received = Clock::now();
+            if (!started) {
+                start = received;
+                started = true;
+            }
+            lastPacket = received;
+            stats[i].packets++;
+            stats[i].bytes += len;
+
+            switch ((Protocol)i) {
+            case Protocol::E131:
+                HandleE131(buffer.data(), len, map, stats[i], frames, received);
+                break;
+            case Protocol::ARTNET:
+                HandleArtNet(buffer.data(), len, map, stats[i], frames, received);
+                break;
+            case Protocol::DDP:
+                HandleDDP(buffer.data(), len, map, stats[i], frames, received);
+                break;
+            }
+        }
+    }
+    frames.Finish(Clock::now());
+
+    double const seconds = started ? std::max(std::chrono::duration<double>(lastPacket - start).count(), 0.001) : 0.0;
+
+    if (program.get<bool>("-j")) {
+        std::string info = fmt::format("{{\"seconds\": {:.3f}, \"protocols\": {{", seconds);
+        bool first = true;
+        for (int i = 0; i < 3; i++) {
+            if (socks[i] == nullptr) continue;
+            if (!first) info += ", ";
+            info += fmt::format("\"{}\": {{\"packets\": {}, \"bytes\": {}, \"packetsPerSec\": {:.1f}, \"syncPackets\": {}, \"ignored\": {}, \"sequenceErrors\": {}}}",
+                                ProtocolNames[i], stats[i].packets, stats[i].bytes, seconds > 0 ? stats[i].packets / seconds : 0.0,
+                                stats[i].syncPackets, stats[i].ignored, stats[i].sequenceErrors);
+            first = false;
+        }
+        info += fmt::format("}}, \"frames\": {}, \"framesPerSec\": {:.2f}, \"completeFrames\": {}, \"expectedChannels\": {}, \"meanCompleteness\": {:.4f}, \"syncedFrames\": {}",
+                            frames.Frames(), seconds > 0 ? frames.Frames() / seconds : 0.0, frames.CompleteFrames(), frames.ExpectedChannels(),
+                            frames.MeanCompleteness(), frames.SyncedFrames());
+        if (reference.IsOpen()) {
+            info += fmt::format(", \"verifiedFrames\": {}, \"mismatchedFrames\": {}, \"unverifiedFrames\": {}",
+                                frames.VerifiedFrames(), frames.MismatchedFrames(), frames.UnverifiedFrames());
+        }
+        info += fmt::format(", \"frameInterval\": {}, \"frameJitter\": {}, \"frameSpread\": {}, \"syncLag\": {}, \"syncInterval\": {}}}\n",
+                            frames.FrameInterval().ToJSON(), frames.FrameJitter().ToJSON(), frames.FrameSpread().ToJSON(),
+                            frames.SyncLag().ToJSON(), frames.SyncInterval().ToJSON());
+        std::cout << info;
+    } else {
+        std::cout << fmt::format("Received for {:.3f}s\n", seconds);
+        for (int i = 0; i < 3; i++) {
+            if (socks[i] == nullptr) continue;
+            std::cout << fmt::format("  {:7} {} packets ({:.1f}/s, {:.2f} MB/s), {} sync, {} ignored, {} sequence errors\n",
+                                     ProtocolNames[i], stats[i].packets, seconds > 0 ? stats[i].packets / seconds : 0.0,
+                                     seconds > 0 ? stats[i].bytes / seconds / 1048576.0 : 0.0,
+                                     stats[i].syncPackets, stats[i].ignored, stats[i].sequenceErrors);
+        }
+        std::cout << fmt::format("Frames: {} ({:.2f}/s), {} complete of {} channels, mean completeness {:.2f}%, {} ended by sync\n",
+                                 frames.Frames(), seconds > 0 ? frames.Frames() / seconds : 0.0, frames.CompleteFrames(),
+                                 frames.ExpectedChannels(), frames.MeanCompleteness() * 100.0, frames.SyncedFrames());
+        if (reference.IsOpen()) {
+            std::cout << fmt::format("Verified: {} match the sequence, {} do not, {} incomplete so not checked\n",
+                                     frames.VerifiedFrames(), frames.MismatchedFrames(), frames.UnverifiedFrames());
+        }
+        std::cout << "Frame interval: " << frames.FrameInterval().ToString() << "\n";
+        if (stepTime > 0) {
+            std::cout << "Frame jitter:   " << frames.FrameJitter().ToString() << "\n";
+        }
+        std::cout << "Frame spread:   " << frames.FrameSpread().ToString() << "\n";
+        if (!frames.SyncLag().Empty()) {
+            std::cout << "Sync lag:       " << frames.SyncLag().ToString() << "\n";
+            std::cout << "Sync interval:  " << frames.SyncInterval().ToString() << "\n";
+        }
+    }
+
+#ifdef _WIN32
+    WSACleanup();
+#endif
+
+    return frames.MismatchedFrames() == 0 ? 0 : 2;
+}
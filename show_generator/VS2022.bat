@@ -0,0 +1,3 @@
+
+cmake.exe -S. -Bcmake_vs -G"Visual Studio 17 2022"
+pause
\ No newline at end of file
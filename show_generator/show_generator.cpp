@@ -0,0 +1,125 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+// Writes a synthetic show folder (networks, layout and sequences) of any size
+// so load, render and output performance can be measured at scale. The same
+// options and seed always give the same files.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <spdlog/fmt/fmt.h>
+#include "spdlog/spdlog.h"
+#include <argparse/argparse.hpp>
+#include "git_version.h"
+#include "render/ShowGenerator.h"
+
+int main(int argc, char* argv[]) {
+    spdlog::set_level(spdlog::level::info);
+    argparse::ArgumentParser program("show_generator", GIT_COMMIT_HASH);
+    program.set_prefix_chars("-+/");
+
+    ShowGeneratorOptions defaults;
+    std::string effects;
+    for (const auto& it : ShowGenerator::GetKnownEffects()) {
+        if (!effects.empty()) effects += ", ";
+        effects += it;
+    }
+
+    program.add_argument("output").help("Show folder to write, created if it does not exist");
+    program.add_argument("-s", "--seed").default_value((int)defaults.seed).help("Random seed").scan<'i', int>();
+    program.add_argument("--matrices").default_value(defaults.matrices).help("Number of matrix models").scan<'i', int>();
+    program.add_argument("--matrix-strings").default_value(defaults.matrixStrings).help("Strings per matrix").scan<'i', int>();
+    program.add_argument("--matrix-nodes").default_value(defaults.matrixNodesPerString).help("Nodes per matrix string").scan<'i', int>();
+    program.add_argument("--trees").default_value(defaults.trees).help("Number of tree models").scan<'i', int>();
+    program.add_argument("--tree-strings").default_value(defaults.treeStrings).help("Strings per tree").scan<'i', int>();
+    program.add_argument("--tree-nodes").default_value(defaults.treeNodesPerString).help("Nodes per tree string").scan<'i', int>();
+    program.add_argument("--customs").default_value(defaults.customs).help("Number of custom models").scan<'i', int>();
+    program.add_argument("--custom-width").default_value(defaults.customWidth).help("Custom model grid width").scan<'i', int>();
+    program.add_argument("--custom-height").default_value(defaults.customHeight).help("Custom model grid height").scan<'i', int>();
+    program.add_argument("--custom-fill").default_value(defaults.customFillPercent).help("Percentage of the custom grid with a node").scan<'i', int>();
+    program.add_argument("--polylines").default_value(defaults.polyLines).help("Number of poly line models").scan<'i', int>();
+    program.add_argument("--polyline-nodes").default_value(defaults.polyLineNodes).help("Nodes per poly line").scan<'i', int>();
+    program.add_argument("--polyline-points").default_value(defaults.polyLinePoints).help("Points per poly line").scan<'i', int>();
+    program.add_argument("--submodels").default_value(defaults.subModelsPerModel).help("Node range submodels per model").scan<'i', int>();
+    program.add_argument("--groups").default_value(defaults.groups).help("Random model groups, an all models group is always added").scan<'i', int>();
+    program.add_argument("--group-size").default_value(defaults.groupSize).help("Models per random group").scan<'i', int>();
+    program.add_argument("-p", "--protocol").default_value(defaults.protocol).help("Output protocol (E131, ArtNet or DDP)");
+    program.add_argument("-z", "--universe-size").default_value(defaults.channelsPerUniverse).help("Channels per universe").scan<'i', int>();
+    program.add_argument("-u", "--universes-per-controller").default_value(defaults.universesPerController).help("Universes per controller").scan<'i', int>();
+    program.add_argument("-n", "--sequences").default_value(defaults.sequences).help("Number of sequences").scan<'i', int>();
+    program.add_argument("-d", "--duration").default_value(defaults.durationMS).help("Sequence length in ms").scan<'i', int>();
+    program.add_argument("-f", "--frame-ms").default_value(defaults.frameMS).help("Frame time in ms").scan<'i', int>();
+    program.add_argument("-l", "--layers").default_value(defaults.layers).help("Effect layers per model and group").scan<'i', int>();
+    program.add_argument("-e", "--effect-ms").default_value(defaults.effectMS).help("Mean effect length in ms").scan<'i', int>();
+    program.add_argument("--density").default_value(defaults.densityPercent).help("Percentage of each layer covered by effects").scan<'i', int>();
+    program.add_argument("--submodel-effects").default_value(defaults.subModelEffectPercent).help("Percentage chance a submodel gets its own effects").scan<'i', int>();
+    program.add_argument("--no-group-effects").flag().help("Leave the groups without effects");
+    program.add_argument("-m", "--effects").default_value(std::string("")).help(fmt::format("Effect mix as Name:weight,... Default is an even mix of {}", effects));
+
+    try {
+        program.parse_args(argc, argv);
+    } catch (const std::exception& err) {
+        spdlog::critical(err.what());
+        exit(EXIT_FAILURE);
+    }
+
+    ShowGeneratorOptions options;
+    options.seed = (uint32_t)program.get<int>("--seed");
+    options.matrices = program.get<int>("--matrices");
+    options.matrixStrings = program.get<int>("--matrix-strings");
+    options.matrixNodesPerString = program.get<int>("--matrix-nodes");
+    options.trees = program.get<int>("--trees");
+    options.treeStrings = program.get<int>("--tree-strings");
+    options.treeNodesPerString = program.get<int>("--tree-nodes");
+    options.customs = program.get<int>("--customs");
+    options.customWidth = program.get<int>("--custom-width");
+    options.customHeight = program.get<int>("--custom-height");
+    options.customFillPercent = program.get<int>("--custom-fill");
+    options.polyLines = program.get<int>("--polylines");
+    options.polyLineNodes = program.get<int>("--polyline-nodes");
+    options.polyLinePoints = program.get<int>("--polyline-points");
+    options.subModelsPerModel = program.get<int>("--submodels");
+    options.groups = program.get<int>("--groups");
+    options.groupSize = program.get<int>("--group-size");
+    options.protocol = program.get("--protocol");
+    options.channelsPerUniverse = program.get<int>("--universe-size");
+    options.universesPerController = program.get<int>("--universes-per-controller");
+    options.sequences = program.get<int>("--sequences");
+    options.durationMS = program.get<int>("--duration");
+    options.frameMS = program.get<int>("--frame-ms");
+    options.layers = program.get<int>("--layers");
+    options.effectMS = program.get<int>("--effect-ms");
+    options.densityPercent = program.get<int>("--density");
+    options.subModelEffectPercent = program.get<int>("--submodel-effects");
+    options.groupEffects = !program.get<bool>("--no-group-effects");
+    options.effectMix = ShowGenerator::ParseEffectMix(program.get("--effects"));
+
+    if (options.protocol != "E131" && options.protocol != "ArtNet" && options.protocol != "DDP") {
+        spdlog::critical("Unknown protocol '{}', expected E131, ArtNet or DDP", options.protocol);
+        exit(EXIT_FAILURE);
+    }
+
+    ShowGenerator generator(options);
+    if (!generator.Generate(program.get("output"))) {
+        exit(EXIT_FAILURE);
+    }
+
+    std::cout << fmt::format("Models:    {}\n", generator.GetModelCount());
+    std::cout << fmt::format("Nodes:     {}\n", generator.GetNodeCount());
+    std::cout << fmt::format("Channels:  {}\n", generator.GetChannelCount());
+    std::cout << fmt::format("Universes: {}\n", generator.GetUniverseCount());
+    std::cout << fmt::format("Effects:   {}\n", generator.GetEffectCount());
+    for (const auto& it : generator.GetSequenceFiles()) {
+        std::cout << it << "\n";
+    }
+    return 0;
+}
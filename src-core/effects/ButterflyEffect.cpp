@@ -131,26 +131,28 @@ void ButterflyEffect::Render(Effect *effect, const SettingsMap &SettingsMap, Ren
         if (end > max) {
             end = max;
         }
-        switch (Style) {
-            case 1:
-                ButterflyEffectStyle1(data, start, end, (ispc::uint8_t4 *)buffer.GetPixels());
-                break;
-            case 2:
-                ButterflyEffectStyle2(data, start, end, (ispc::uint8_t4 *)buffer.GetPixels());
-                break;
-            case 3:
-                ButterflyEffectStyle3(data, start, end, (ispc::uint8_t4 *)buffer.GetPixels());
-                break;
-            case 4:
-                ButterflyEffectStyle4(data, start, end, (ispc::uint8_t4 *)buffer.GetPixels());
-                break;
-            case 5:
-                ButterflyEffectStyle5(data, start, end, (ispc::uint8_t4 *)buffer.GetPixels());
-                break;
-            default:
-                ButterflyEffectPlasmaStyles(data, start, end, (ispc::uint8_t4 *)buffer.GetPixels());
-                break;
-        }
+        buffer.ForEachOccupiedRun(start, end, [&](int s, int e) {
+            switch (Style) {
+                case 1:
+                    ButterflyEffectStyle1(data, s, e, (ispc::uint8_t4 *)buffer.GetPixels());
+                    break;
+                case 2:
+                    ButterflyEffectStyle2(data, s, e, (ispc::uint8_t4 *)buffer.GetPixels());
+                    break;
+                case 3:
+                    ButterflyEffectStyle3(data, s, e, (ispc::uint8_t4 *)buffer.GetPixels());
+                    break;
+                case 4:
+                    ButterflyEffectStyle4(data, s, e, (ispc::uint8_t4 *)buffer.GetPixels());
+                    break;
+                case 5:
+                    ButterflyEffectStyle5(data, s, e, (ispc::uint8_t4 *)buffer.GetPixels());
+                    break;
+                default:
+                    ButterflyEffectPlasmaStyles(data, s, e, (ispc::uint8_t4 *)buffer.GetPixels());
+                    break;
+            }
+        });
     });
 }
 
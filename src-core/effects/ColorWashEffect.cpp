@@ -79,6 +79,13 @@ int ColorWashEffect::DrawEffectBackground(const Effect *e, int x1, int y1, int x
     return 2;
 }
 
+// The fades (with an alpha buffer) and the shimmer's black frames come out transparent
+bool ColorWashEffect::IsOpaque(const SettingsMap& settings) const {
+    return !settings.GetBool(CHECKBOX_ColorWash_Shimmer, sShimmerDefault) &&
+           !settings.GetBool(CHECKBOX_ColorWash_HFade, sHFadeDefault) &&
+           !settings.GetBool(CHECKBOX_ColorWash_VFade, sVFadeDefault);
+}
+
 void ColorWashEffect::Render(Effect *effect, const SettingsMap &SettingsMap, RenderBuffer &buffer) {
 
     float oset = buffer.GetEffectTimeIntervalPosition();
@@ -140,11 +147,20 @@ void ColorWashEffect::Render(Effect *effect, const SettingsMap &SettingsMap, Ren
         int max = std::min<int>(buffer.GetPixelCount(), buffer.BufferWi * buffer.BufferHt);
         constexpr int bfBlockSize = 4096;
         int blocks = max / bfBlockSize + 1;
-        parallel_for(0, blocks, [&cwdata, &buffer, max](int blk) {
+        // the background display list samples the wash's centre cell, which
+        // need not be occupied, so render everything when it is wanted
+        const bool fullBuffer = effect->IsBackgroundDisplayListEnabled() && buffer.perModelIndex == 0;
+        parallel_for(0, blocks, [&cwdata, &buffer, max, fullBuffer](int blk) {
             int start = blk * bfBlockSize;
             int end = start + bfBlockSize;
             if (end > max) end = max;
-            ispc::ColorWashEffectISPC(&cwdata, start, end, (ispc::uint8_t4*)buffer.GetPixels());
+            if (fullBuffer) {
+                ispc::ColorWashEffectISPC(&cwdata, start, end, (ispc::uint8_t4*)buffer.GetPixels());
+                return;
+            }
+            buffer.ForEachOccupiedRun(start, end, [&](int s, int e) {
+                ispc::ColorWashEffectISPC(&cwdata, s, e, (ispc::uint8_t4*)buffer.GetPixels());
+            });
         });
     }
 
@@ -20,6 +20,7 @@ public:
 
     virtual void Render(Effect* effect, const SettingsMap& settings, RenderBuffer& buffer) override;
     virtual FrameParallelism GetFrameParallelism(const SettingsMap& settings) const override { return FrameParallelism::Pure; }
+    virtual bool IsOpaque(const SettingsMap& settings) const override;
     virtual int DrawEffectBackground(const Effect* e, int x1, int y1, int x2, int y2, xlVertexColorAccumulator& bg, xlColor* colorMask, bool ramps) override;
     virtual bool CanRenderPartialTimeInterval() const override
     {
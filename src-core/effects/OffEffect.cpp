@@ -78,6 +78,11 @@ void OffEffect::adjustSettings(const std::string& version, Effect* effect, bool
 }
 
 
+bool OffEffect::IsOpaque(const SettingsMap& settings) const
+{
+    return settings.Get("CHOICE_Off_Style", sStyleDefault) == "Black";
+}
+
 void OffEffect::Render(Effect* effect, const SettingsMap& settings, RenderBuffer& buffer)
 {
     std::string style = settings.Get("CHOICE_Off_Style", sStyleDefault);
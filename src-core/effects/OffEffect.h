@@ -20,6 +20,7 @@ class OffEffect : public RenderableEffect
         virtual bool CanBeRandom() override {return false;}
         virtual void Render(Effect *effect, const SettingsMap &settings, RenderBuffer &buffer) override;
         virtual FrameParallelism GetFrameParallelism(const SettingsMap& settings) const override { return FrameParallelism::Pure; }
+        virtual bool IsOpaque(const SettingsMap& settings) const override;
         virtual bool CanRenderPartialTimeInterval() const override { return true; }
         virtual std::list<std::string> CheckEffectSettings(const SettingsMap& settings, AudioManager* media, Model* model, Effect* eff, bool renderCache) override;
 
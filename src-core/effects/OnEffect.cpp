@@ -13,6 +13,7 @@
 #include "OnEffect.h"
 #include "../render/Effect.h"
 #include "../render/RenderBuffer.h"
+#include "../render/ValueCurve.h"
 #include "UtilClasses.h"
 #include "UtilFunctions.h"
 #include "Parallel.h"
@@ -131,6 +132,17 @@ int OnEffect::DrawEffectBackground(const Effect *e, int x1, int y1, int x2, int
     }
 }
 
+// Shimmer leaves the odd frames untouched and any transparency lets lower layers through
+bool OnEffect::IsOpaque(const SettingsMap& settings) const {
+    if (settings.GetInt(CHECKBOX_On_Shimmer, sShimmerDefault ? 1 : 0) > 0) {
+        return false;
+    }
+    if (settings.Contains("VALUECURVE_On_Transparency") && ValueCurve(settings.Get("VALUECURVE_On_Transparency", "")).IsActive()) {
+        return false;
+    }
+    return settings.GetInt("TEXTCTRL_On_Transparency", sTransparencyDefault) == 0;
+}
+
 void OnEffect::Render(Effect *eff, const SettingsMap &SettingsMap, RenderBuffer &buffer) {
     // Defaults were cached from On.json in OnMetadataLoaded() — Render must
     // never touch the JSON.
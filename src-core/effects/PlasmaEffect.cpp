@@ -114,22 +114,24 @@ void PlasmaEffect::Render(Effect *effect, const SettingsMap &SettingsMap, Render
         if (end > max) {
             end = max;
         }
-        switch (ColorScheme) {
-            case 0:
-                ispc::PlasmaEffectStyle0(rdata, start, end, (ispc::uint8_t4 *)buffer.GetPixels());
-                break;
-            case 1:
-                ispc::PlasmaEffectStyle1(rdata, start, end, (ispc::uint8_t4 *)buffer.GetPixels());
-                break;
-            case 2:
-                ispc::PlasmaEffectStyle2(rdata, start, end, (ispc::uint8_t4 *)buffer.GetPixels());
-                break;
-            case 3:
-                ispc::PlasmaEffectStyle3(rdata, start, end, (ispc::uint8_t4 *)buffer.GetPixels());
-                break;
-            case 4:
-                ispc::PlasmaEffectStyle4(rdata, start, end, (ispc::uint8_t4 *)buffer.GetPixels());
-                break;
-        }
+        buffer.ForEachOccupiedRun(start, end, [&](int s, int e) {
+            switch (ColorScheme) {
+                case 0:
+                    ispc::PlasmaEffectStyle0(rdata, s, e, (ispc::uint8_t4 *)buffer.GetPixels());
+                    break;
+                case 1:
+                    ispc::PlasmaEffectStyle1(rdata, s, e, (ispc::uint8_t4 *)buffer.GetPixels());
+                    break;
+                case 2:
+                    ispc::PlasmaEffectStyle2(rdata, s, e, (ispc::uint8_t4 *)buffer.GetPixels());
+                    break;
+                case 3:
+                    ispc::PlasmaEffectStyle3(rdata, s, e, (ispc::uint8_t4 *)buffer.GetPixels());
+                    break;
+                case 4:
+                    ispc::PlasmaEffectStyle4(rdata, s, e, (ispc::uint8_t4 *)buffer.GetPixels());
+                    break;
+            }
+        });
     });
 }
@@ -141,6 +141,15 @@ public:
     // output. Effect overrides only need to describe their own algorithm.
     FrameParallelism GetEffectiveFrameParallelism(const SettingsMap& settings) const;
 
+    // True when, with these settings, every frame of the effect sets every
+    // pixel of its buffer fully opaque. Layers under such a layer (Normal mix,
+    // no transitions or rotozoom, see PixelBufferClass::IsLayerOpaque) cannot
+    // show, so the engine may skip rendering the Pure ones. Conservatively
+    // false by default.
+    virtual bool IsOpaque(const SettingsMap& settings) const {
+        return false;
+    }
+
     // --- Tier-2 Snapshottable API ------------------------------------------
     // A Snapshottable effect exposes a cheap serial state-advance separately
     // from an expensive pure per-frame draw, so the engine can advance the
@@ -157,44 +157,10 @@ bool ISPCComputeUtilities::blendLayers(PixelBufferClass *pixelBuffer, int effect
     }
     uint32_t * tmpBufferBlend = (uint32_t *)&pixelBuffer->blendDataBuffer[0];
 
-    
-    // first load the pixel data into the buffers for blending on each layer
-    for (int l = validLayers.size() - 1; l >= 0; --l) {
-        if (validLayers[l]) {
-            auto layer = pixelBuffer->layers[l];
-            std::vector<uint32_t> &tmpBufferLayer = layer->buffer.blendBuffer;
-            uint32_t * result = (uint32_t *)&tmpBufferLayer[0];
-            
-            ispc::LayerBlendingData data;
-            data.nodeCount = layer->buffer.GetNodeCount();
-            data.startNode = 0;
-            data.endNode = layer->buffer.GetNodeCount();
-            data.bufferHi = layer->buffer.BufferHt;
-            data.bufferWi = layer->buffer.BufferWi;
-            data.useMask = layer->maskSize > 0;
-            data.hueAdjust = layer->outputHueAdjust;
-            data.valueAdjust = layer->outputValueAdjust;
-            data.saturationAdjust = layer->outputSaturationAdjust;
-            data.outputSparkleCount = layer->outputSparkleCount;
-            data.contrast = layer->contrast;
-            data.brightness = layer->outputBrightnessAdjust;
-            data.isChromaKey = layer->isChromaKey;
-            data.chromaSensitivity = layer->chromaSensitivity;
-            data.chromaColor = layer->chromaKeyColour.GetRGBA();
-            data.effectMixThreshold = layer->outputEffectMixThreshold;
-            data.effectMixVaries = layer->effectMixVaries;
-            data.brightnessLevel = layer->brightnessLevel;
-            data.fadeFactor = layer->fadeFactor;
-            
-            // first, we grab the color for the node from the buffer for the layer and into a single [] of colors matching the nodes
-            const uint32_t *src = (const uint32_t *)layer->buffer.pixels;
-            if (layer->buffer.allSimpleIndex && !data.useMask)  {
-                ispc::GetColorsISPCKernelSimple(data, (uint32_t*)result, src, layer->mask, &layer->buffer.indexVector[0]);
-            } else {
-                ispc::GetColorsISPCKernel(data, (uint32_t*)result, src, layer->mask, &layer->buffer.indexVector[0]);
-            }
-        }
-    }
+    // Each block of nodes is gathered, adjusted and blended through every
+    // layer before moving on to the next, so a block of the result and of the
+    // layer being mixed in stay in cache rather than every layer being
+    // streamed through the whole buffer for each stage.
     constexpr int maxPerBlock = 4096;
     int count = pixelBuffer->layers[saveLayer]->buffer.GetNodeCount();
     if (count < maxPerBlock) {
@@ -243,17 +209,12 @@ bool ISPCComputeUtilities::blendLayers(PixelBufferClass *pixelBuffer, int effect
             ispc::PutColorsForNodes(data, target, tmpBufferBlend, nullptr, &layer->buffer.indexVector[0]);
         }
     }
-    
-    xlColor *colors = (xlColor*)(&pixelBuffer->blendDataBuffer[0]);
-    int nc = pixelBuffer->layers[saveLayer]->buffer.GetNodeCount();
-    for (int x = 0; x < nc; x++) {
-        pixelBuffer->layers[saveLayer]->buffer.Nodes[x]->SetColor(colors[x]);
-    }
     return true;
 }
 
 void ISPCComputeUtilities::blendLayers(PixelBufferClass *pixelBuffer, int effectPeriod, const std::vector<bool>& validLayers, int saveLayer, int start, int end) {
     uint32_t * tmpBufferBlend = (uint32_t *)&pixelBuffer->blendDataBuffer[0];
+    bool first = true;
     for (int l = validLayers.size() - 1; l >= 0; --l) {
         if (validLayers[l]) {
             auto layer = pixelBuffer->layers[l];
@@ -261,9 +222,9 @@ void ISPCComputeUtilities::blendLayers(PixelBufferClass *pixelBuffer, int effect
             uint32_t * result = (uint32_t *)&tmpBufferLayer[0];
 
             ispc::LayerBlendingData data;
-            data.startNode = start;
-            data.endNode = end;
             data.nodeCount = layer->buffer.GetNodeCount();
+            data.startNode = start;
+            data.endNode = std::min((uint32_t)end, data.nodeCount);
             data.bufferHi = layer->buffer.BufferHt;
             data.bufferWi = layer->buffer.BufferWi;
             data.useMask = layer->maskSize > 0;
@@ -280,7 +241,16 @@ void ISPCComputeUtilities::blendLayers(PixelBufferClass *pixelBuffer, int effect
             data.effectMixVaries = layer->effectMixVaries;
             data.brightnessLevel = layer->brightnessLevel;
             data.fadeFactor = layer->fadeFactor;
-            
+
+            // grab the color for the nodes in the block from the buffer for the layer (with
+            // any transition mask applied) into a single [] of colors matching the nodes
+            const uint32_t *src = (const uint32_t *)layer->buffer.pixels;
+            if (layer->buffer.allSimpleIndex && !data.useMask)  {
+                ispc::GetColorsISPCKernelSimple(data, result, src, layer->mask, &layer->buffer.indexVector[0]);
+            } else {
+                ispc::GetColorsISPCKernel(data, result, src, layer->mask, &layer->buffer.indexVector[0]);
+            }
+
             if (layer->needsHSVAdjust) {
                 ispc::AdjustHSV(data, result);
             }
@@ -298,45 +268,16 @@ void ISPCComputeUtilities::blendLayers(PixelBufferClass *pixelBuffer, int effect
             if (layer->brightnessLevel) {
                 ispc::AdjustBrightnessLevel(data, result);
             }
-        }
-    }
-    
-    // now all the pixels are loaded and adjusted, now start the blending
-    bool first = true;
-    for (int l = validLayers.size() - 1; l >= 0; --l) {
-        if (validLayers[l]) {
-            auto layer = pixelBuffer->layers[l];
-            std::vector<uint32_t> &tmpBufferLayer = layer->buffer.blendBuffer;
-            uint32_t * src = (uint32_t *)&tmpBufferLayer[0];
 
-            ispc::LayerBlendingData data;
-            data.startNode = start;
+            // the blend covers the whole block, as it always has
             data.endNode = end;
-            data.nodeCount = layer->buffer.GetNodeCount();
-            data.bufferHi = layer->buffer.BufferHt;
-            data.bufferWi = layer->buffer.BufferWi;
-            data.useMask = layer->maskSize > 0;
-            data.hueAdjust = layer->outputHueAdjust;
-            data.valueAdjust = layer->outputValueAdjust;
-            data.saturationAdjust = layer->outputSaturationAdjust;
-            data.outputSparkleCount = layer->outputSparkleCount;
-            data.contrast = layer->contrast;
-            data.brightness = layer->outputBrightnessAdjust;
-            data.isChromaKey = layer->isChromaKey;
-            data.chromaSensitivity = layer->chromaSensitivity;
-            data.chromaColor = layer->chromaKeyColour.GetRGBA();
-            data.effectMixThreshold = layer->outputEffectMixThreshold;
-            data.effectMixVaries = layer->effectMixVaries;
-            data.brightnessLevel = layer->brightnessLevel;
-            data.fadeFactor = layer->fadeFactor;
-            
             if (first) {
                 first = false;
-                ispc::FirstLayerFade(data, tmpBufferBlend, src);
+                ispc::FirstLayerFade(data, tmpBufferBlend, result);
             } else {
                 if (!layer->buffer.allowAlpha && layer->fadeFactor != 1.0) {
                     // need to fade the first here as we're not mixing anything
-                    ispc::NonAlphaFade(data, src);
+                    ispc::NonAlphaFade(data, result);
                 }
                 
                 ISPCBlendFunctionInfo* f = this->data->forMixType(layer->mixType);
@@ -349,8 +290,15 @@ void ISPCComputeUtilities::blendLayers(PixelBufferClass *pixelBuffer, int effect
                     f = this->data->forMixType(MixTypes::Mix_Normal);
                 }
                 data.mixTypeData = f->mixTypeData;
-                f->function(data, tmpBufferBlend, src, &layer->buffer.indexVector[0]);
+                f->function(data, tmpBufferBlend, result, &layer->buffer.indexVector[0]);
             }
         }
     }
+
+    // the block's blended colours are still in cache, hand them to the nodes now
+    xlColor *colors = (xlColor*)tmpBufferBlend;
+    auto &nodes = pixelBuffer->layers[saveLayer]->buffer.Nodes;
+    for (int x = start; x < end; x++) {
+        nodes[x]->SetColor(colors[x]);
+    }
 }
@@ -30,6 +30,7 @@
 #include <atomic>
 
 #include <log.h>
+#include "utils/PerfTrace.h"
 
 // XL_VIDEO_DUMP=<dir>: write the first few frames each reader serves as binary
 // PPM, named <basename>_<decoder>_<posMS>.ppm. The point is to compare decoders
@@ -216,6 +217,7 @@ VideoReader::~VideoReader()
 int VideoReader::GetLengthMS() const { return _impl->GetLengthMS(); }
 void VideoReader::Seek(int timestampMS, bool readFrame) { _impl->Seek(timestampMS, readFrame); }
 VideoFrame* VideoReader::GetNextFrame(int timestampMS, int gracetime) {
+    PerfTrace::Span span("video", "GetNextFrame", "ms", timestampMS, "reader", _readerId);
     VideoFrame* f = _impl->GetNextFrame(timestampMS, gracetime);
     if (f != nullptr) {
         MaybeDumpFrame(*f, _impl->GetFilename(), _decoderTag, _impl->GetPos(), _dumpedFrames);
@@ -271,10 +271,25 @@ public:
         }
     }
 
+    // GetForChannelsBase with the colour passed through a dimming curve's tables
+    void GetForChannelsBase(unsigned char* buf, const uint8_t lut[3][256]) const {
+        for (int x = 0; x < 3; x++) {
+            if (offsets[x] != 255 && offsets[x] < chanCnt) {
+                buf[offsets[x]] = lut[x][c[x]];
+            }
+        }
+    }
+
     void GetColorBase(xlColor& color) const {
         color.Set(c[0], c[1], c[2]);
     }
 
+    // The channel SetFromChannelsBase/GetForChannelsBase use for red, green or
+    // blue (0-2), 255 if there is none
+    uint8_t GetChannelOffsetBase(int color) const {
+        return (offsets[color] != 255 && offsets[color] < chanCnt) ? offsets[color] : 255;
+    }
+
     virtual void SetFromChannels(const unsigned char* buf) {
         SetFromChannelsBase(buf);
     }
@@ -349,6 +349,7 @@ void ArtNetOutput::StartFrame(long msec) {
     
 
     if (!_enabled) return;
+    StartZeroCopyFrame();
 
     if (_datagram == nullptr && OutputManager::IsRetryOpen()) {
         OpenDatagram();
@@ -362,11 +363,16 @@ void ArtNetOutput::StartFrame(long msec) {
 
 void ArtNetOutput::EndFrame(int suppressFrames) {
 
+    const uint8_t* payload = EndZeroCopyFrame(&_data[ARTNET_PACKET_HEADERLEN]);
     if (!_enabled || _suspend || _datagram == nullptr) return;
 
     if (_changed || NeedToOutput(suppressFrames)) {
         _data[12] = _sequenceNum;
-        _datagram->SendTo(_remoteIp, ARTNET_PORT, _data, ARTNET_PACKET_LEN - (512 - _channels));
+        if (payload != nullptr) {
+            SendDatagramGather(_datagram, GetForceLocalIPToUse(), _forceSourcePort ? ARTNET_PORT : 0, _remoteIp, ARTNET_PORT, _data, ARTNET_PACKET_HEADERLEN, payload, _channels);
+        } else {
+            SendDatagram(_datagram, GetForceLocalIPToUse(), _forceSourcePort ? ARTNET_PORT : 0, _remoteIp, ARTNET_PORT, _data, ARTNET_PACKET_LEN - (512 - _channels));
+        }
         _sequenceNum = _sequenceNum == 255 ? 0 : _sequenceNum + 1;
         FrameOutput();
         _changed = false;
@@ -383,6 +389,7 @@ void ArtNetOutput::SetOneChannel(int32_t channel, unsigned char data) {
     if (!_enabled) return;
     assert(channel < _channels);
 
+    MaterializeZeroCopyPayload(&_data[ARTNET_PACKET_HEADERLEN]);
     if (_data[channel + ARTNET_PACKET_HEADERLEN] != data) {
         _data[channel + ARTNET_PACKET_HEADERLEN] = data;
         _changed = true;
@@ -394,21 +401,19 @@ void ArtNetOutput::SetManyChannels(int32_t channel, unsigned char* data, size_t
     if (!_enabled) return;
     assert((size_t)channel + size <= (size_t)_channels);
     if (channel < 0 || channel >= _channels) return;
+    if (SetZeroCopyPayload(channel, data, size, &_data[ARTNET_PACKET_HEADERLEN])) return;
 
     size_t chs = (std::min)((int32_t)size, _channels - channel);
 
-    if (memcmp(&_data[channel + ARTNET_PACKET_HEADERLEN], data, chs) == 0) {
-        // nothing has changed
-    }
-    else {
-        memcpy(&_data[channel + ARTNET_PACKET_HEADERLEN], data, chs);
-        _changed = true;
-    }
+    // duplicate frames are detected on the whole payload in DetectDuplicateFrame
+    memcpy(&_data[channel + ARTNET_PACKET_HEADERLEN], data, chs);
+    _changed = true;
 }
 
 void ArtNetOutput::AllOff() {
 
     if (!_enabled) return;
+    ResetZeroCopy();
     memset(&_data[ARTNET_PACKET_HEADERLEN], 0x00, _channels);
     _changed = true;
 }
@@ -48,6 +48,7 @@ class ArtNetOutput : public IPOutput
 
 #pragma region Private Functions
     void OpenDatagram();
+    virtual const uint8_t* GetPayload() const override { return _zeroCopyPayload != nullptr ? _zeroCopyPayload : &_data[ARTNET_PACKET_HEADERLEN]; }
 #pragma endregion
 
 public:
@@ -430,6 +430,7 @@ void DDPOutput::StartFrame(long msec) {
     
 
     if (!_enabled) return;
+    StartZeroCopyFrame();
     if (_fppProxyOutput) {
         _fppProxyOutput->StartFrame(msec);
     } else if (_datagram == nullptr && OutputManager::IsRetryOpen()) {
@@ -444,6 +445,7 @@ void DDPOutput::StartFrame(long msec) {
 
 void DDPOutput::EndFrame(int suppressFrames) {
 
+    const uint8_t* payload = EndZeroCopyFrame(_fulldata);
     if (!_enabled || _suspend || _tempDisable) return;
     if (_fppProxyOutput) {
         _fppProxyOutput->EndFrame(suppressFrames);
@@ -482,9 +484,12 @@ void DDPOutput::EndFrame(int suppressFrames) {
             _data[8] = (thissend & 0xFF00) >> 8;
             _data[9] = thissend & 0x00FF;
 
-            memcpy(&_data[10], _fulldata + index, thissend);
-
-            _datagram->SendTo(_remoteIp, DDP_PORT, &_data[0], DDP_PACKET_LEN - (1440 - thissend));
+            if (payload != nullptr) {
+                SendDatagramGather(_datagram, GetForceLocalIP(), 0, _remoteIp, DDP_PORT, &_data[0], DDP_PACKET_HEADERLEN, payload + index, thissend);
+            } else {
+                memcpy(&_data[10], _fulldata + index, thissend);
+                SendDatagram(_datagram, GetForceLocalIP(), 0, _remoteIp, DDP_PORT, &_data[0], DDP_PACKET_LEN - (1440 - thissend));
+            }
             _sequenceNum = _sequenceNum == 15 ? 1 : _sequenceNum + 1;
 
             tosend -= thissend;
@@ -509,6 +514,7 @@ void DDPOutput::SetOneChannel(int32_t channel, unsigned char data) {
     }
     if (_fulldata == nullptr) return;
 
+    MaterializeZeroCopyPayload(_fulldata);
     if ((channel < _channels) && (*(_fulldata + channel) != data)) {
         *(_fulldata + channel) = data;
         _changed = true;
@@ -525,15 +531,13 @@ void DDPOutput::SetManyChannels(int32_t channel, unsigned char* data, size_t siz
     }
     if (_fulldata == nullptr) return;
     if (channel < 0 || channel >= _channels) return;
+    if (SetZeroCopyPayload(channel, data, size, _fulldata)) return;
 
     size_t chs = (std::min)((int32_t)size, _channels - channel);
 
-    if (memcmp(_fulldata + channel, data, chs) == 0) {
-        // nothing changed
-    } else {
-        memcpy(_fulldata + channel, data, chs);
-        _changed = true;
-    }
+    // duplicate frames are detected on the whole payload in DetectDuplicateFrame
+    memcpy(_fulldata + channel, data, chs);
+    _changed = true;
 }
 
 void DDPOutput::AllOff() {
@@ -545,6 +549,7 @@ void DDPOutput::AllOff() {
         return;
     }
     if (_fulldata == nullptr) return;
+    ResetZeroCopy();
     memset(_fulldata, 0x00, _channels);
     _changed = true;
 }
@@ -62,6 +62,7 @@ class DDPOutput : public IPOutput
 
     #pragma region Private Functions
     void OpenDatagram();
+    virtual const uint8_t* GetPayload() const override { return _zeroCopyPayload != nullptr ? _zeroCopyPayload : _fulldata; }
     #pragma  endregion
 
 public:
@@ -62,7 +62,7 @@ void DMXOutput::EndFrame(int suppressFrames) {
 
     if (_changed || NeedToOutput(suppressFrames)) {
         if (_serial != nullptr) {
-            _serial->Write((char *)_data, _datalen);
+            SerialWrite(_data, _datalen);
         }
         FrameOutput();
     }
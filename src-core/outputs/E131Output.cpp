@@ -384,6 +384,7 @@ void E131Output::StartFrame(long msec) {
     assert(!IsOutputCollection_CONVERT());
 
     if (!_enabled) return;
+    StartZeroCopyFrame();
     if (_fppProxyOutput) {
         return _fppProxyOutput->StartFrame(msec);
     }
@@ -402,6 +403,7 @@ void E131Output::EndFrame(int suppressFrames) {
 
     assert(!IsOutputCollection_CONVERT());
 
+    const uint8_t* payload = EndZeroCopyFrame(&_data[E131_PACKET_HEADERLEN]);
     if (!_enabled || _suspend || _tempDisable) return;
 
     if (_fppProxyOutput) {
@@ -413,7 +415,11 @@ void E131Output::EndFrame(int suppressFrames) {
 
     if (_changed || NeedToOutput(suppressFrames)) {
         _data[111] = _sequenceNum;
-        _datagram->SendTo(_remoteIp, E131_PORT, _data, E131_PACKET_LEN - (512 - _channels));
+        if (payload != nullptr) {
+            SendDatagramGather(_datagram, GetForceLocalIPToUse(), 0, _remoteIp, E131_PORT, _data, E131_PACKET_HEADERLEN, payload, _channels);
+        } else {
+            SendDatagram(_datagram, GetForceLocalIPToUse(), 0, _remoteIp, E131_PORT, _data, E131_PACKET_LEN - (512 - _channels));
+        }
         _sequenceNum = _sequenceNum == 255 ? 0 : _sequenceNum + 1;
         FrameOutput();
     }
@@ -445,6 +451,7 @@ void E131Output::SetOneChannel(int32_t channel, unsigned char data) {
         return;
     }
 
+    MaterializeZeroCopyPayload(&_data[E131_PACKET_HEADERLEN]);
     if (_data[channel + E131_PACKET_HEADERLEN] != data) {
         _data[channel + E131_PACKET_HEADERLEN] = data;
         _changed = true;
@@ -462,14 +469,12 @@ void E131Output::SetManyChannels(int32_t channel, unsigned char* data, size_t si
     }
     else {
         if (channel < 0 || channel >= GetMaxChannels()) return;
+        if (SetZeroCopyPayload(channel, data, size, &_data[E131_PACKET_HEADERLEN])) return;
         size_t chs = (std::min)(size, (size_t)(GetMaxChannels() - channel));
 
-        if (memcmp(&_data[channel + E131_PACKET_HEADERLEN], data, chs) == 0) {
-            // nothing changed
-        } else {
-            memcpy(&_data[channel + E131_PACKET_HEADERLEN], data, chs);
-            _changed = true;
-        }
+        // duplicate frames are detected on the whole payload in DetectDuplicateFrame
+        memcpy(&_data[channel + E131_PACKET_HEADERLEN], data, chs);
+        _changed = true;
     }
 }
 
@@ -483,6 +488,7 @@ void E131Output::AllOff() {
         _fppProxyOutput->AllOff();
     } 
     else {
+        ResetZeroCopy();
         memset(&_data[E131_PACKET_HEADERLEN], 0x00, _channels);
         _changed = true;
     }
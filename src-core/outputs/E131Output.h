@@ -43,6 +43,7 @@ class E131Output : public IPOutput
     // this is used to create any sub universes in this output
     void CreateMultiUniverses_CONVERT(int num);
     void OpenDatagram();
+    virtual const uint8_t* GetPayload() const override { return _zeroCopyPayload != nullptr ? _zeroCopyPayload : &_data[E131_PACKET_HEADERLEN]; }
     #pragma endregion
 
 public:
@@ -0,0 +1,277 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "FSEQPlayer.h"
+#include "OutputManager.h"
+#include "../render/FSEQFile.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <timeapi.h>
+#if !defined(XLIGHTS_CMAKE_BUILD)
+#pragma comment(lib, "winmm.lib")
+#endif
+#endif
+
+#include <log.h>
+
+// how long before a deadline we stop sleeping and spin instead
+#define FSEQPLAYER_SPIN_US 1000
+
+#pragma region Constructors and Destructors
+FSEQPlayer::FSEQPlayer(OutputManager* outputManager) :
+    _outputManager(outputManager) {
+}
+
+FSEQPlayer::~FSEQPlayer() {
+    Close();
+}
+#pragma endregion
+
+#pragma region Open and Close
+bool FSEQPlayer::Open(const std::string& filename, int prefetchFrames) {
+
+    Close();
+
+    _fseq = FSEQFile::openFSEQFile(filename);
+    if (_fseq == nullptr) {
+        spdlog::error("FSEQPlayer: Unable to open '{}'.", filename);
+        return false;
+    }
+
+    _frameMS = std::max(_fseq->getStepTime(), 1);
+    _numFrames = (uint32_t)_fseq->getNumFrames();
+    _channels = (uint32_t)_fseq->getChannelCount();
+
+    // playback reads each frame once in order and must not hold the sequence in memory
+    _fseq->setReadPattern(FSEQFile::ReadPattern::Streaming);
+    std::vector<std::pair<uint32_t, uint32_t>> ranges = { { 0, _channels } };
+    _fseq->prepareRead(ranges, 0);
+
+    _slots.resize(std::max(prefetchFrames, 2));
+    for (auto& s : _slots) {
+        s.data.resize(_channels);
+    }
+    _lastSent.assign(_channels, 0);
+
+    spdlog::info("FSEQPlayer: Opened '{}' {} frames of {}ms, {} channels, prefetching {} frames.",
+        filename, _numFrames, _frameMS, _channels, _slots.size());
+    return true;
+}
+
+void FSEQPlayer::Close() {
+
+    StopPrefetch();
+    if (_fseq != nullptr) {
+        delete _fseq;
+        _fseq = nullptr;
+    }
+    _slots.clear();
+    _lastSent.clear();
+    _numFrames = 0;
+    _channels = 0;
+}
+#pragma endregion
+
+#pragma region Prefetch
+void FSEQPlayer::Prefetch(bool loop) {
+
+    uint32_t frame = 0;
+    while (!_stopRequested) {
+
+        if (frame >= _numFrames) {
+            if (!loop || _numFrames == 0) break;
+            frame = 0;
+        }
+
+        size_t slot;
+        {
+            std::unique_lock<std::mutex> lock(_prefetchLock);
+            _prefetchSignal.wait(lock, [this] { return _stopRequested || _count < _slots.size(); });
+            if (_stopRequested) break;
+            slot = (_head + _count) % _slots.size();
+        }
+
+        // the slot is not visible to the player until _count moves so it can be filled unlocked
+        auto& s = _slots[slot];
+        s.frame = frame;
+        FSEQFile::FrameData* fd = _fseq->getFrame(frame);
+        if (fd == nullptr || !fd->readFrame(s.data.data(), _channels)) {
+            spdlog::warn("FSEQPlayer: Unable to read frame {}.", frame);
+            std::fill(s.data.begin(), s.data.end(), 0);
+        }
+        delete fd;
+
+        {
+            std::unique_lock<std::mutex> lock(_prefetchLock);
+            _count++;
+        }
+        _prefetchSignal.notify_all();
+        frame++;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(_prefetchLock);
+        _prefetchDone = true;
+    }
+    _prefetchSignal.notify_all();
+}
+
+FSEQPlayer::PrefetchSlot* FSEQPlayer::PeekFrame() {
+
+    std::unique_lock<std::mutex> lock(_prefetchLock);
+    if (_count == 0) return nullptr;
+    return &_slots[_head];
+}
+
+void FSEQPlayer::ReleaseFrame() {
+
+    {
+        std::unique_lock<std::mutex> lock(_prefetchLock);
+        if (_count == 0) return;
+        _head = (_head + 1) % _slots.size();
+        _count--;
+    }
+    _prefetchSignal.notify_all();
+}
+
+void FSEQPlayer::StopPrefetch() {
+
+    bool const stop = _stopRequested;
+    {
+        std::unique_lock<std::mutex> lock(_prefetchLock);
+        _stopRequested = true;
+    }
+    _prefetchSignal.notify_all();
+    if (_prefetchThread.joinable()) {
+        _prefetchThread.join();
+    }
+    _stopRequested = stop;
+    _head = 0;
+    _count = 0;
+    _prefetchDone = false;
+}
+#pragma endregion
+
+#pragma region Play
+bool FSEQPlayer::Play(bool loop) {
+
+    using namespace std::chrono;
+
+    if (_fseq == nullptr || _outputManager == nullptr) return false;
+
+    _stopRequested = false;
+    _framesPlayed = 0;
+    _framesDropped = 0;
+    _underruns = 0;
+    _sendLatency.Reset();
+    _frameJitter.Reset();
+
+    if (!_outputManager->StartOutput()) {
+        spdlog::error("FSEQPlayer: Unable to start output.");
+        return false;
+    }
+
+    _prefetchThread = std::thread(&FSEQPlayer::Prefetch, this, loop);
+    {
+        // let the ring fill before the clock starts so the first frames are not underruns
+        std::unique_lock<std::mutex> lock(_prefetchLock);
+        _prefetchSignal.wait(lock, [this] { return _stopRequested || _prefetchDone || _count == _slots.size(); });
+    }
+
+#ifdef _WIN32
+    timeBeginPeriod(1);
+#endif
+
+    auto const frameTime = milliseconds(_frameMS);
+    auto const playStart = steady_clock::now();
+    auto deadline = playStart;
+    steady_clock::time_point lastStart;
+    bool haveLastStart = false;
+
+    while (!_stopRequested) {
+
+        // sleep until just before the deadline then spin the rest for accuracy
+        std::this_thread::sleep_until(deadline - microseconds(FSEQPLAYER_SPIN_US));
+        while (steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+
+        auto slot = PeekFrame();
+        if (slot == nullptr) {
+            std::unique_lock<std::mutex> lock(_prefetchLock);
+            if (_prefetchDone && _count == 0) break;
+        }
+
+        auto const start = steady_clock::now();
+        if (haveLastStart) {
+            auto interval = duration_cast<microseconds>(start - lastStart).count();
+            _frameJitter.Add(std::abs(interval - (int64_t)_frameMS * 1000));
+        }
+        lastStart = start;
+        haveLastStart = true;
+
+        // the frame data is held until the next frame has been sent, see below
+        _outputManager->StartFrame((long)duration_cast<milliseconds>(start - playStart).count(), true);
+        if (slot != nullptr) {
+            _outputManager->SetManyChannels(0, slot->data.data(), slot->data.size());
+        } else {
+            // nothing decoded in time ... still start/end the frame so keep-alives go out
+            _underruns++;
+        }
+        _outputManager->EndFrame();
+        // zero copy outputs keep referencing the frame until the next frame has been sent so
+        // its buffer moves out of the ring rather than being refilled, the buffer sent the
+        // frame before goes back in its place
+        if (slot != nullptr) {
+            std::swap(slot->data, _lastSent);
+            ReleaseFrame();
+            _framesPlayed++;
+        }
+
+        auto const end = steady_clock::now();
+        _sendLatency.Add(duration_cast<microseconds>(end - start).count());
+        deadline += frameTime;
+
+        // if we are more than a frame behind drop the frames we missed so we stay in time
+        if (end > deadline + frameTime) {
+            auto behind = (end - deadline) / frameTime;
+            deadline += frameTime * behind;
+            for (int64_t i = 0; i < behind && PeekFrame() != nullptr; i++) {
+                ReleaseFrame();
+                _framesDropped++;
+            }
+        }
+    }
+
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+
+    bool const stopped = _stopRequested;
+    StopPrefetch();
+    // leave the lights off rather than holding the last frame
+    _outputManager->StartFrame(0);
+    _outputManager->AllOff();
+    _outputManager->EndFrame();
+    _outputManager->StopOutput();
+
+    spdlog::info("FSEQPlayer: {} after {} frames, {} dropped, {} underruns, latency p99 {}us, jitter p99 {}us.",
+        stopped ? "Stopped" : "Finished", (uint64_t)_framesPlayed, (uint64_t)_framesDropped, (uint64_t)_underruns,
+        _sendLatency.GetPercentile(99), _frameJitter.GetPercentile(99));
+
+    // rewind so Play can be called again
+    _fseq->prepareRead({ { 0, _channels } }, 0);
+    return true;
+}
+#pragma endregion
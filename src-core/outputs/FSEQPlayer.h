@@ -0,0 +1,91 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "OutputScheduler.h"
+
+class FSEQFile;
+class OutputManager;
+
+// Plays an fseq straight to the outputs without models, sequences or any UI.
+// A prefetch thread streams and decompresses frames into a small bounded ring
+// while the playing thread paces StartFrame/SetManyChannels/EndFrame on
+// absolute steady_clock deadlines. If the sender falls behind, late frames
+// are dropped so the show stays on the wall clock.
+class FSEQPlayer
+{
+public:
+    FSEQPlayer(OutputManager* outputManager);
+    ~FSEQPlayer();
+
+    FSEQPlayer(const FSEQPlayer&) = delete;
+    FSEQPlayer& operator=(const FSEQPlayer&) = delete;
+
+    bool Open(const std::string& filename, int prefetchFrames = 20);
+    void Close();
+
+    // Blocks until the sequence ends (never when looping) or Stop is called.
+    // Starts and stops output on the OutputManager.
+    bool Play(bool loop = false);
+    // Only sets a flag so it is safe to call from a signal handler
+    void Stop() { _stopRequested = true; }
+
+    int GetFrameMS() const { return _frameMS; }
+    uint32_t GetNumFrames() const { return _numFrames; }
+    uint32_t GetChannelCount() const { return _channels; }
+
+    uint64_t GetFramesPlayed() const { return _framesPlayed; }
+    uint64_t GetFramesDropped() const { return _framesDropped; }
+    uint64_t GetUnderruns() const { return _underruns; }
+    const OutputTimingHistogram& GetSendLatency() const { return _sendLatency; }
+    const OutputTimingHistogram& GetFrameJitter() const { return _frameJitter; }
+
+private:
+    struct PrefetchSlot {
+        std::vector<uint8_t> data;
+        uint32_t frame = 0;
+    };
+
+    void Prefetch(bool loop);
+    PrefetchSlot* PeekFrame();
+    void ReleaseFrame();
+    void StopPrefetch();
+
+    OutputManager* _outputManager = nullptr;
+    FSEQFile* _fseq = nullptr;
+    int _frameMS = 50;
+    uint32_t _numFrames = 0;
+    uint32_t _channels = 0;
+
+    std::thread _prefetchThread;
+    std::mutex _prefetchLock;
+    std::condition_variable _prefetchSignal;
+    std::vector<PrefetchSlot> _slots;
+    std::vector<uint8_t> _lastSent; // the frame last sent, outputs may still reference it
+    size_t _head = 0;  // oldest filled slot
+    size_t _count = 0; // filled slots
+    bool _prefetchDone = false;
+    std::atomic_bool _stopRequested = false;
+
+    std::atomic<uint64_t> _framesPlayed = 0;
+    std::atomic<uint64_t> _framesDropped = 0;
+    std::atomic<uint64_t> _underruns = 0;
+    OutputTimingHistogram _sendLatency;
+    OutputTimingHistogram _frameJitter;
+};
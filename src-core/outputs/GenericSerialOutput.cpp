@@ -61,7 +61,7 @@ void GenericSerialOutput::EndFrame(int suppressFrames)
     {
         if (_serial != nullptr && _datalen > 0)
         {
-            _serial->Write((char *)&_data[0], _datalen);
+            SerialWrite(&_data[0], _datalen);
             FrameOutput();
         }
     }
@@ -18,9 +18,14 @@
 #include <icmpapi.h>
 #endif
 
+#include "SocketAbstraction.h"
+#include "UDPBatchSender.h"
 #include "utils/CurlManager.h"
 #include "utils/ip_utils.h"
 
+#include <cstring>
+#include <vector>
+
 #include <log.h>
 
 #pragma region Private Functions
@@ -33,6 +38,70 @@ void IPOutput::SaveAttr(pugi::xml_node node) {
 
     Output::SaveAttr(node);
 }
+
+bool IPOutput::SendDatagram(sockets::UDPSocket* datagram, const std::string& localIp, uint16_t localPort, const std::string& remoteIp, uint16_t remotePort, const uint8_t* data, size_t length) {
+
+    if (_batchSender != nullptr && _batchSender->Enqueue(localIp, localPort, remoteIp, remotePort, data, length)) {
+        return true;
+    }
+    if (datagram == nullptr) return false;
+    return datagram->SendTo(remoteIp, remotePort, data, length);
+}
+
+bool IPOutput::SendDatagramGather(sockets::UDPSocket* datagram, const std::string& localIp, uint16_t localPort, const std::string& remoteIp, uint16_t remotePort, const uint8_t* header, size_t headerLength, const uint8_t* payload, size_t payloadLength) {
+
+    if (_batchSender != nullptr && _batchSender->EnqueueGather(localIp, localPort, remoteIp, remotePort, header, headerLength, payload, payloadLength)) {
+        return true;
+    }
+    if (datagram == nullptr) return false;
+    std::vector<uint8_t> packet(header, header + headerLength);
+    packet.insert(packet.end(), payload, payload + payloadLength);
+    return datagram->SendTo(remoteIp, remotePort, packet.data(), packet.size());
+}
+
+bool IPOutput::SetZeroCopyPayload(int32_t channel, const uint8_t* data, size_t size, uint8_t* payloadBuffer) {
+
+    bool const whole = channel == 0 && size >= (size_t)_channels;
+    if (whole && _zeroCopyFrame && _zeroCopyAllowed) {
+        _zeroCopyPayload = data;
+        _zeroCopyCarried = false;
+        _changed = true;
+        return true;
+    }
+
+    MaterializeZeroCopyPayload(payloadBuffer);
+    return false;
+}
+
+void IPOutput::MaterializeZeroCopyPayload(uint8_t* payloadBuffer) {
+
+    if (_zeroCopyPayload == nullptr) return;
+    memcpy(payloadBuffer, _zeroCopyPayload, _channels);
+    _zeroCopyPayload = nullptr;
+    _zeroCopyCarried = false;
+    _changed = true;
+}
+
+void IPOutput::StartZeroCopyFrame() {
+
+    // only a frame the caller held is still referenced here, and it is valid to the end of this one
+    _zeroCopyCarried = _zeroCopyPayload != nullptr;
+    _zeroCopyFrame = true;
+}
+
+const uint8_t* IPOutput::EndZeroCopyFrame(uint8_t* payloadBuffer) {
+
+    const uint8_t* payload = _zeroCopyPayload;
+    if (payload != nullptr && (_zeroCopyCarried || !_frameDataHeld)) {
+        // the reference dies with this frame but keep-alive and resend frames still need
+        // the data, the batch sender still sends this frame from the frame memory
+        memcpy(payloadBuffer, payload, _channels);
+        _zeroCopyPayload = nullptr;
+        _zeroCopyCarried = false;
+    }
+    _zeroCopyFrame = false;
+    return payload;
+}
 #pragma endregion
 
 #pragma region Constructors and Destructors
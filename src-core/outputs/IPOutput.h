@@ -14,12 +14,45 @@
 
 #include "Output.h"
 
+namespace sockets {
+class UDPSocket;
+}
+
 class IPOutput : public Output
 {
 protected:
 
     #pragma region Private Functions
     virtual void SaveAttr(pugi::xml_node node) override;
+
+    // Sends the datagram on this output's own socket, or queues it on the output
+    // manager's frame batch when batched transmission is active
+    bool SendDatagram(sockets::UDPSocket* datagram, const std::string& localIp, uint16_t localPort, const std::string& remoteIp, uint16_t remotePort, const uint8_t* data, size_t length);
+    // As SendDatagram but the payload follows the header without being copied into it
+    bool SendDatagramGather(sockets::UDPSocket* datagram, const std::string& localIp, uint16_t localPort, const std::string& remoteIp, uint16_t remotePort, const uint8_t* header, size_t headerLength, const uint8_t* payload, size_t payloadLength);
+
+    // Zero copy output. When the output manager allows it and one call between StartFrame and
+    // EndFrame supplies every channel, the frame memory is referenced rather than copied into
+    // the packet buffer. If the caller holds the frame data (OutputManager::StartFrame) the
+    // reference is kept into the next frame, and is only copied into the packet buffer if that
+    // frame ends without a whole frame of its own or a channel is changed on its own. Otherwise
+    // EndFrame copies it once it is queued so keep-alive and resend frames go out with what was last sent.
+    // Returns true if the data was referenced. Otherwise payloadBuffer is brought up to date
+    // and the caller copies into it as usual.
+    bool SetZeroCopyPayload(int32_t channel, const uint8_t* data, size_t size, uint8_t* payloadBuffer);
+    // Copies any referenced frame into the packet buffer. Call before changing individual channels.
+    void MaterializeZeroCopyPayload(uint8_t* payloadBuffer);
+    void StartZeroCopyFrame();
+    // Returns the referenced frame, if any, to send now and ends the frame. If the frame memory
+    // does not outlive this frame it is also copied into payloadBuffer, the send still goes from it.
+    const uint8_t* EndZeroCopyFrame(uint8_t* payloadBuffer);
+    void ResetZeroCopy() { _zeroCopyPayload = nullptr; _zeroCopyCarried = false; _zeroCopyFrame = false; }
+    #pragma endregion
+
+    #pragma region Member Variables
+    const uint8_t* _zeroCopyPayload = nullptr;
+    bool _zeroCopyCarried = false; // _zeroCopyPayload was referenced in the previous frame
+    bool _zeroCopyFrame = false;
     #pragma endregion
 
 public:
@@ -50,6 +83,6 @@ public:
     #pragma endregion 
     
     #pragma region Start and Stop
-    virtual bool Open() override { return Output::Open(); }
+    virtual bool Open() override { ResetZeroCopy(); return Output::Open(); }
     #pragma endregion 
 };
@@ -201,6 +201,12 @@ void LOROptimisedOutput::EndFrame(int suppressFrames)
     }
     LOROutput::EndFrame(suppressFrames);
 }
+
+void LOROptimisedOutput::ResendAll() {
+    LOROutput::ResendAll();
+    // _lastSent alone misses channels that really are at 0xFF
+    _forceResend = true;
+}
 #pragma endregion 
 
 #pragma region Data Setting
@@ -290,7 +296,7 @@ void LOROptimisedOutput::SetManyChannels(int32_t channel, unsigned char* data, s
                     lorBankData[shift_offset].push_back(std::pair<uint8_t, uint16_t>({ data[cur_channel], 1 << chan_offset }));
                 }
 
-                if (data[cur_channel] != _lastSent[cur_channel]) {
+                if (_forceResend || data[cur_channel] != _lastSent[cur_channel]) {
                     bank_changed = true;
                     frame_changed = true;
                 }
@@ -386,7 +392,7 @@ void LOROptimisedOutput::SetManyChannels(int32_t channel, unsigned char* data, s
             }
 
             if (_serial != nullptr && frame_changed) {
-                _serial->Write((char*)d, idx);
+                SerialWrite(d, idx);
                 // After we output we dont want to close too early as that causes crashes
                 SetDontDieUntil(GetCurrentTimeMillis() + MINIMUM_MILLIS_AFTER_WRITE_BEFORE_CLOSE);
                 total_bytes_sent += idx;
@@ -400,6 +406,7 @@ void LOROptimisedOutput::SetManyChannels(int32_t channel, unsigned char* data, s
             ++unit_id;
         }
     }
+    _forceResend = false;
     //spdlog::debug("    LOROptimisedOutput: Sent {} bytes", total_bytes_sent);
 }
 
@@ -440,7 +447,7 @@ void LOROptimisedOutput::AllOff() {
             d[idx++] = 0x0;
 
             if (_serial != nullptr) {
-                _serial->Write((char*)d, idx);
+                SerialWrite(d, idx);
                 // After we output we dont want to close too early as that causes crashes
                 SetDontDieUntil(GetCurrentTimeMillis() + MINIMUM_MILLIS_AFTER_WRITE_BEFORE_CLOSE);
             }
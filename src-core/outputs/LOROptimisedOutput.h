@@ -25,6 +25,7 @@ class LOROptimisedOutput : public LOROutput
     bool unit_id_in_use[256];
     uint8_t _curData[LOR_MAX_CHANNELS];
     LorControllers _controllers;
+    bool _forceResend = false; // send every bank on the next frame whether it changed or not
     //uint8_t _framesSinceForcedOutput = 0xFF;
     #pragma endregion Member Variables
 
@@ -63,6 +64,7 @@ public:
 
     #pragma region Frame Handling
     virtual void EndFrame(int suppressFrames) override;
+    virtual void ResendAll() override;
     #pragma endregion 
 
     #pragma region Data Setting
@@ -57,6 +57,7 @@ public:
     virtual void EndFrame(int suppressFrames) override;
     virtual void ResetFrame() override;
     virtual void SendHeartbeat() const override;
+    virtual void ResendAll() override;
     #pragma endregion 
 
     #pragma region Data Setting
@@ -55,9 +55,7 @@ void OpenDMXOutput::EndFrame(int suppressFrames) {
 
     if (_changed || NeedToOutput(suppressFrames)) {
         if (_serial != nullptr) {
-            _serial->SendBreak();  // sends a 1 millisecond break
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));  // mark after break (MAB) - 1 millisecond is overkill (8 microseconds is the minimum dmx requirement)
-            _serial->Write((char *)_data, 513);
+            SerialWrite(_data, 513, true); // break then mark after break before the data
             FrameOutput();
         }
     }
@@ -70,9 +70,9 @@ void OpenPixelNetOutput::EndFrame(int suppressFrames) {
 
     if (_changed || NeedToOutput(suppressFrames)) {
         if (_serial != nullptr) {
-            if (_serial->WaitingToWrite() == 0) {
+            if (CanWriteFrame()) {
                 memcpy(&_serialBuffer[6], _data, sizeof(_data));
-                _serial->Write((char *)_serialBuffer, sizeof(_serialBuffer));
+                SerialWrite(_serialBuffer, sizeof(_serialBuffer));
                 FrameOutput();
             }
         }
@@ -35,6 +35,7 @@
 #include "OutputManager.h"
 #include "../utils/ip_utils.h"
 #include "Controller.h"
+#include "../utils/FastHash.h"
 
 #include <log.h>
 
@@ -258,6 +259,7 @@ bool Output::Open() {
             _fppProxyOutput->_resolvedIp = ip_utils::ResolveIP(proxy);
             _fppProxyOutput->_startChannel = _startChannel;
             _fppProxyOutput->_channels = GetEndChannel() - _startChannel + 1;
+            _fppProxyOutput->SetTransmission(_batchSender, _zeroCopyAllowed, _asyncWrite);
             _fppProxyOutput->Open();
         }
     }
@@ -296,6 +298,23 @@ void Output::FrameOutput() {
     _lastOutputTime = GetCurrentTimeMillis();
     _skippedFrames = 0;
     _changed = false;
+    _lastSentHash = _frameHash;
+    _lastSentHashValid = _frameHashValid;
+    _frameHashValid = false;
     OutputManager::RegisterSentPacket();
 }
+
+void Output::DetectDuplicateFrame() {
+
+    _frameHashValid = false;
+    if (!_enabled || !_suppressDuplicateFrames || _fppProxyOutput != nullptr) return;
+
+    const uint8_t* payload = GetPayload();
+    if (payload == nullptr || _channels <= 0) return;
+
+    _frameHash = FastHash::Hash64(payload, _channels);
+    _frameHashValid = true;
+    _changed = !_lastSentHashValid || _frameHash != _lastSentHash;
+}
+
 #pragma endregion 
@@ -10,6 +10,7 @@
  * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <list>
@@ -20,6 +21,7 @@
 
 class ModelManager;
 class OutputManager;
+class UDPBatchSender;
 class OutputModelManager;
 class ControllerEthernet;
 class Controller;
@@ -74,11 +76,20 @@ protected:
     int64_t _lastOutputTime = 0;
     int _skippedFrames = 9999;
     bool _changed = false; // set to true when something in the packed has changed
+    uint64_t _frameHash = 0; // hash of this frame's payload, valid if _frameHashValid
+    bool _frameHashValid = false;
+    uint64_t _lastSentHash = 0; // hash of the payload last sent, valid if _lastSentHashValid
+    bool _lastSentHashValid = false;
+    std::atomic<uint64_t> _duplicateFramesSkipped = 0; // read by the stats while outputting
     std::string _fppProxy;
     std::string _globalFPPProxy;
     std::string _forceLocalIP;
     std::string _globalForceLocalIP;
     Output* _fppProxyOutput = nullptr;
+    UDPBatchSender* _batchSender = nullptr; // the output manager's frame batch, only set while outputting
+    bool _zeroCopyAllowed = false; // may reference frame data rather than copy it
+    bool _frameDataHeld = false; // this frame's data stays valid until the next frame has ended
+    bool _asyncWrite = false; // serial outputs write from their own thread
 
     bool _autoSize_CONVERT = false;
     std::string _description_CONVERT;
@@ -86,6 +97,9 @@ protected:
 
 #pragma region Private Functions
     virtual void SaveAttr(pugi::xml_node node);
+    // The channel data that would go in this frame's packets or nullptr if the output
+    // does not support whole payload duplicate detection
+    virtual const uint8_t* GetPayload() const { return nullptr; }
 #pragma endregion
 
 public:
@@ -148,6 +162,17 @@ public:
     void SetForceLocalIP(const std::string& ip) { _forceLocalIP = ip; }
     bool IsUsingForceLocalIP() const { return _forceLocalIP != ""; }
     void SetGlobalForceLocalIP(const std::string& ip) { _globalForceLocalIP = ip; }
+    // How the owning output manager transmits, set before Open and cleared after Close
+    void SetTransmission(UDPBatchSender* batchSender, bool zeroCopy, bool asyncWrite) {
+        _batchSender = batchSender;
+        _zeroCopyAllowed = zeroCopy;
+        _asyncWrite = asyncWrite;
+    }
+    // Set by the output manager before each StartFrame
+    void SetFrameDataHeld(bool held) {
+        _frameDataHeld = held;
+        if (_fppProxyOutput != nullptr) _fppProxyOutput->SetFrameDataHeld(held);
+    }
     std::string GetForceLocalIPToUse() const;
 
     int GetUniverse() const { return _universe; }
@@ -237,8 +262,14 @@ public:
     virtual void EndFrame(int suppressFrames) = 0;
     virtual void ResetFrame() {}
     void FrameOutput();
-    void SkipFrame() { _skippedFrames++; }
+    void SkipFrame() { _skippedFrames++; _duplicateFramesSkipped++; }
     bool NeedToOutput(int suppressFrames) const { return !IsSuppressDuplicateFrames() || _skippedFrames >= suppressFrames; }
+    // Sets _changed by comparing a hash of the whole payload with the last one sent.
+    // Called by the output manager for every output just before EndFrame.
+    void DetectDuplicateFrame();
+    uint64_t GetDuplicateFramesSkipped() const { return _duplicateFramesSkipped; }
+    // Called by the output manager for every output just after EndFrame
+    virtual void FlushFrame() {}
     #pragma endregion 
 
     #pragma region Data Setting
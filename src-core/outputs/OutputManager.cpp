@@ -23,13 +23,16 @@
 #include "DDPOutput.h"
 #include "xxxEthernetOutput.h"
 #include "OPCOutput.h"
+#include "UDPBatchSender.h"
 #include "TestPreset.h"
 #include "Parallel.h"
 #include "UtilFunctions.h"
 #include "utils/ExternalHooks.h"
 #include "utils/FileUtils.h"
 #include "utils/ip_utils.h"
+#include "utils/PerfTrace.h"
 #include "render/UICallbacks.h"
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <spdlog/fmt/fmt.h>
@@ -206,6 +209,9 @@ bool OutputManager::Load(const std::string& showdir, bool syncEnabled) {
         pugi::xml_node root = doc.document_element();
         _globalFPPProxy = root.attribute("GlobalFPPProxy").as_string("");
         _globalForceLocalIP = root.attribute("GlobalForceLocalIP").as_string("");
+        _batchTransmission = std::string_view(root.attribute("BatchTransmission").as_string("0")) == "1";
+        _zeroCopyOutput = std::string_view(root.attribute("ZeroCopyOutput").as_string("0")) == "1";
+        _asyncSerial = std::string_view(root.attribute("AsyncSerial").as_string("0")) == "1";
 
         _autoUpdateFromBaseShowDir = std::string_view(root.attribute("AutoUpdateFromBase").as_string("0")) == "1";
         _baseShowDir = root.attribute("BaseShowDir").as_string("");
@@ -491,6 +497,15 @@ void OutputManager::SaveToXML(pugi::xml_document& doc) {
     root.append_attribute("computer") = GetHostName();
     root.append_attribute("GlobalFPPProxy") = _globalFPPProxy;
     root.append_attribute("GlobalForceLocalIP") = _globalForceLocalIP;
+    if (_batchTransmission) {
+        root.append_attribute("BatchTransmission") = "1";
+    }
+    if (_zeroCopyOutput) {
+        root.append_attribute("ZeroCopyOutput") = "1";
+    }
+    if (_asyncSerial) {
+        root.append_attribute("AsyncSerial") = "1";
+    }
 
     root.append_attribute("AutoUpdateFromBase") = _autoUpdateFromBaseShowDir ? "1" : "0";
     root.append_attribute("BaseShowDir") = _baseShowDir;
@@ -1109,6 +1124,15 @@ int OutputManager::GetPacketsPerSecond() const {
     return 0;
 }
 
+uint64_t OutputManager::GetDuplicateFramesSkipped() const {
+
+    uint64_t skipped = 0;
+    for (const auto& it : GetAllOutputs()) {
+        skipped += it->GetDuplicateFramesSkipped();
+    }
+    return skipped;
+}
+
 // Mark all controllers with the same IP address as unmanaged
 void OutputManager::UpdateUnmanaged() {
 
@@ -1261,11 +1285,25 @@ bool OutputManager::StartOutput() {
     }
     ip_utils::waitForAllToResolve();
 
+    if (_batchTransmission && _batchSender == nullptr) {
+        spdlog::debug("Light output using batched UDP transmission.");
+        _batchSender = new UDPBatchSender();
+    }
+    _zeroCopyActive = _batchSender != nullptr && _zeroCopyOutput;
+    if (_zeroCopyActive) {
+        spdlog::debug("Light output referencing frame data directly rather than copying it.");
+    }
+    _asyncSerialActive = _asyncSerial;
+    if (_asyncSerialActive) {
+        spdlog::debug("Serial outputs writing from their own threads.");
+    }
+
     for (const auto& it : GetAllOutputs()) {
 
         // make sure global FPP proxy is up to date ...
         it->SetGlobalFPPProxyIP(_globalFPPProxy);
         it->SetGlobalForceLocalIP(_globalForceLocalIP);
+        it->SetTransmission(_batchSender, _zeroCopyActive, _asyncSerialActive);
 
         bool preok = ok;
         ok = it->Open() && ok;
@@ -1282,6 +1320,8 @@ bool OutputManager::StartOutput() {
         if (ok) started++;
         _outputting = (started > 0);
     }
+
+    BuildRoutingTable();
     
     if (err && !_outputting) {
         // fake it so we dont keep getting error messages
@@ -1306,10 +1346,14 @@ bool OutputManager::StartControllerOutputs(Controller* controller) {
     for (auto output : controller->GetOutputs()) {
         output->SetGlobalFPPProxyIP(_globalFPPProxy);
         output->SetGlobalForceLocalIP(_globalForceLocalIP);
+        output->SetTransmission(_batchSender, _zeroCopyActive, _asyncSerialActive);
         if (output->Open()) started++;
     }
 
-    if (started > 0) _outputting = true;
+    if (started > 0) {
+        _outputting = true;
+        BuildRoutingTable();
+    }
 
     _outputCriticalSection.unlock();
     return started > 0;
@@ -1325,14 +1369,42 @@ void OutputManager::StopOutput() {
     spdlog::debug("Stopping light output.");
 
     _outputting = false;
+    _routingTable.clear();
 
     for (const auto& it : GetAllOutputs()) {
         it->Close();
+        it->SetTransmission(nullptr, false, false);
+    }
+
+    _zeroCopyActive = false;
+    _asyncSerialActive = false;
+    uint64_t const skipped = GetDuplicateFramesSkipped();
+    if (skipped > 0) {
+        spdlog::debug("Duplicate frame suppression skipped {} universe frames.", skipped);
+    }
+    if (_batchSender != nullptr) {
+        spdlog::debug("Batched UDP transmission sent {} packets using {} syscalls, {} errors.",
+            _batchSender->GetSentCount(), _batchSender->GetSyscallCount(), _batchSender->GetErrorCount());
+        delete _batchSender;
+        _batchSender = nullptr;
     }
 
     _outputCriticalSection.unlock();
 }
 
+void OutputManager::BuildRoutingTable() {
+
+    _routingTable.clear();
+    for (const auto& it : GetAllOutputs()) {
+        if (it->GetChannels() <= 0) continue;
+        _routingTable.push_back({ it->GetStartChannel() - 1, it->GetChannels(), it });
+    }
+    std::stable_sort(_routingTable.begin(), _routingTable.end(), [](const OutputRoute& a, const OutputRoute& b) {
+        return a.startChannel < b.startChannel;
+    });
+    spdlog::debug("Output routing table built with {} entries.", _routingTable.size());
+}
+
 size_t OutputManager::TxNonEmptyCount() {
 
     size_t res = 0;
@@ -1352,12 +1424,13 @@ bool OutputManager::TxEmpty() {
 #pragma endregion
 
 #pragma region Frame Handling
-void OutputManager::StartFrame(long msec) {
+void OutputManager::StartFrame(long msec, bool frameDataHeld) {
 
     if (!_outputting) return;
     if (!_outputCriticalSection.try_lock()) return;
     
     for (const auto& it : GetAllOutputs()) {
+        it->SetFrameDataHeld(frameDataHeld);
         it->StartFrame(msec);
     }
     _outputCriticalSection.unlock();
@@ -1380,17 +1453,27 @@ void OutputManager::EndFrame() {
     if (!_outputCriticalSection.try_lock()) return;
 
     auto outputs = GetAllOutputs();
+    PerfTrace::Span span("output", "EndFrame", "outputs", (int)outputs.size());
     if (_parallelTransmission) {
         parallel_for(0, (int)outputs.size(), [this, &outputs](int n) {
+            outputs[n]->DetectDuplicateFrame();
             outputs[n]->EndFrame(_suppressFrames);
+            outputs[n]->FlushFrame();
         });
     }
     else {
         for (const auto& it : outputs) {
+            it->DetectDuplicateFrame();
             it->EndFrame(_suppressFrames);
+            it->FlushFrame();
         }
     }
 
+    // everything queued by the outputs must hit the wire before the sync packets
+    if (_batchSender != nullptr) {
+        _batchSender->Flush();
+    }
+
     if (IsSyncEnabled()) {
         if (_syncUniverse != 0) {
             if (AtLeastOneOutputUsingProtocol(OUTPUT_E131)) {
@@ -1443,6 +1526,22 @@ void OutputManager::SetManyChannels(int32_t channel, unsigned char* data, size_t
 
     if (size == 0) return;
 
+    if (_outputting && !_routingTable.empty()) {
+        // find the first route which ends after our first channel
+        auto it = std::upper_bound(_routingTable.begin(), _routingTable.end(), channel, [](int32_t ch, const OutputRoute& r) {
+            return ch < r.startChannel + r.channels;
+        });
+        int64_t const end = (int64_t)channel + size;
+        for (; it != _routingTable.end() && it->startChannel < end; ++it) {
+            int32_t const from = std::max(channel, it->startChannel);
+            int32_t const to = (int32_t)std::min(end, (int64_t)it->startChannel + it->channels);
+            if (to > from && it->output->IsEnabled()) {
+                it->output->SetManyChannels(from - it->startChannel, &data[from - channel], to - from);
+            }
+        }
+        return;
+    }
+
     int32_t stch;
     Output* o = GetOutput(channel + 1, stch);
 
@@ -1485,8 +1584,12 @@ void OutputManager::AllOff(bool send) {
         it->AllOff();
         if (send) {
             it->EndFrame(_suppressFrames);
+            it->FlushFrame();
         }
     }
+    if (send && _batchSender != nullptr) {
+        _batchSender->Flush();
+    }
     _outputCriticalSection.unlock();
 }
 #pragma endregion 
@@ -24,9 +24,17 @@ class Controller;
 class TestPreset;
 class UICallbacks;
 class ControllerEthernet;
+class UDPBatchSender;
 
 #define NETWORKSFILE "xlights_networks.xml";
 
+// One contiguous span of absolute channels owned by a single output
+struct OutputRoute {
+    int32_t startChannel; // zero based absolute channel
+    int32_t channels;
+    Output* output;
+};
+
 class OutputManager
 {
     #pragma region Member Variables
@@ -39,6 +47,12 @@ class OutputManager
     bool _dirty = false;
     int _suppressFrames = 0;
     bool _parallelTransmission = false;
+    bool _batchTransmission = false;
+    bool _zeroCopyOutput = false;
+    bool _asyncSerial = false;
+    UDPBatchSender* _batchSender = nullptr; // only set while outputting with batched transmission
+    bool _zeroCopyActive = false; // outputs reference frame data rather than copying it
+    bool _asyncSerialActive = false; // serial outputs write from their own thread
     bool _outputting = false; // true if we are currently sending out data
     bool _didConvert = false;
     std::string _globalFPPProxy;
@@ -51,6 +65,9 @@ class OutputManager
     // form of `_baseShowDir` so the base-folder link survives
     // moving the show between machines (e.g. desktop ↔ iPad).
     std::string _showDir = "";
+    // Sorted by startChannel. Built when output starts so SetManyChannels does not have to
+    // search the controllers for every frame. Only valid while _outputting.
+    std::vector<OutputRoute> _routingTable;
     #pragma endregion
 
     #pragma region Static Variables
@@ -68,6 +85,7 @@ class OutputManager
     #pragma region Private Functions
     bool ConvertStartChannel(const std::string sc, std::string& newsc) const;
     void AsyncPingAll();
+    void BuildRoutingTable();
     #pragma endregion 
 
 public:
@@ -193,8 +211,20 @@ public:
     
     void SetParallelTransmission(bool parallel) { _parallelTransmission = parallel; }
     bool GetParallelTransmission() const { return _parallelTransmission; }
+
+    // When enabled E1.31/ArtNet/DDP datagrams are queued during EndFrame and sent together
+    void SetBatchTransmission(bool batch) { if (_batchTransmission != batch) { _batchTransmission = batch; _dirty = true; } }
+    bool GetBatchTransmission() const { return _batchTransmission; }
+    // Only takes effect with batch transmission as the batch is what carries the payload pointers
+    void SetZeroCopyOutput(bool zeroCopy) { if (_zeroCopyOutput != zeroCopy) { _zeroCopyOutput = zeroCopy; _dirty = true; } }
+    bool GetZeroCopyOutput() const { return _zeroCopyOutput; }
+    // When enabled each serial output hands its frames to a writer thread so a slow port cannot stall the frame
+    void SetAsyncSerial(bool async) { if (_asyncSerial != async) { _asyncSerial = async; _dirty = true; } }
+    bool GetAsyncSerial() const { return _asyncSerial; }
     
     int GetPacketsPerSecond() const;
+    // universe frames not sent because duplicate frame suppression found them unchanged
+    uint64_t GetDuplicateFramesSkipped() const;
     
     void UpdateUnmanaged();
     
@@ -227,7 +257,10 @@ public:
     #pragma endregion 
 
     #pragma region Frame Handling
-    void StartFrame(long msec);
+    // frameDataHeld promises that data passed to SetManyChannels in this frame stays unchanged until
+    // the following frame has ended, or AllOff/StopOutput. Zero copy outputs then keep referencing it
+    // rather than copying it into their packet buffers for keep-alive and resend frames.
+    void StartFrame(long msec, bool frameDataHeld = false);
     void EndFrame();
     void ResetFrame();
     void SendHeartbeat();
@@ -257,6 +290,7 @@ public:
     void SetOneChannel(int32_t channel, unsigned char data);
     void SetManyChannels(int32_t channel, unsigned char* data, size_t size);
     void AllOff(bool send = true);
+    const std::vector<OutputRoute>& GetRoutingTable() const { return _routingTable; }
     #pragma endregion 
 
     #pragma region Test Presets
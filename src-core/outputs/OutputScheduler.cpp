@@ -0,0 +1,320 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "OutputScheduler.h"
+#include "OutputManager.h"
+#include "../render/SequenceData.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <timeapi.h>
+#if !defined(XLIGHTS_CMAKE_BUILD)
+#pragma comment(lib, "winmm.lib")
+#endif
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <log.h>
+
+// how long before a deadline we stop sleeping and spin instead
+#define OUTPUTSCHEDULER_SPIN_US 1000
+
+#pragma region OutputTimingHistogram
+void OutputTimingHistogram::Add(int64_t us) {
+
+    if (us < 0) us = 0;
+    int bucket = 0;
+    int64_t v = us >> 1;
+    while (v > 0 && bucket < NUM_BUCKETS - 1) {
+        v >>= 1;
+        bucket++;
+    }
+
+    std::unique_lock<std::mutex> lock(_lock);
+    if (_count == 0 || us < _min) _min = us;
+    if (us > _max) _max = us;
+    _count++;
+    _total += us;
+    _buckets[bucket]++;
+}
+
+void OutputTimingHistogram::Reset() {
+    std::unique_lock<std::mutex> lock(_lock);
+    _buckets.fill(0);
+    _count = 0;
+    _min = 0;
+    _max = 0;
+    _total = 0;
+}
+
+uint64_t OutputTimingHistogram::GetCount() const {
+    std::unique_lock<std::mutex> lock(_lock);
+    return _count;
+}
+
+int64_t OutputTimingHistogram::GetPercentile(double pct) const {
+
+    std::unique_lock<std::mutex> lock(_lock);
+    if (_count == 0) return 0;
+
+    uint64_t target = (uint64_t)std::ceil(_count * std::clamp(pct, 0.0, 100.0) / 100.0);
+    uint64_t seen = 0;
+    for (int i = 0; i < NUM_BUCKETS; i++) {
+        seen += _buckets[i];
+        if (seen >= target && seen > 0) {
+            return std::min((int64_t)2 << i, _max);
+        }
+    }
+    return _max;
+}
+
+nlohmann::json OutputTimingHistogram::ToJSON() const {
+
+    nlohmann::json res;
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        res["count"] = _count;
+        res["minUs"] = _min;
+        res["maxUs"] = _max;
+        res["meanUs"] = _count == 0 ? 0.0 : _total / _count;
+
+        nlohmann::json buckets = nlohmann::json::array();
+        for (int i = 0; i < NUM_BUCKETS; i++) {
+            if (_buckets[i] == 0) continue;
+            nlohmann::json b;
+            b["fromUs"] = i == 0 ? 0 : (int64_t)1 << i;
+            b["toUs"] = (int64_t)2 << i;
+            b["count"] = _buckets[i];
+            buckets.push_back(b);
+        }
+        res["buckets"] = buckets;
+    }
+    res["p50Us"] = GetPercentile(50);
+    res["p99Us"] = GetPercentile(99);
+    return res;
+}
+#pragma endregion
+
+#pragma region Constructors and Destructors
+OutputScheduler::OutputScheduler(OutputManager* outputManager) :
+    _outputManager(outputManager) {
+}
+
+OutputScheduler::~OutputScheduler() {
+    Stop();
+}
+#pragma endregion
+
+#pragma region Start and Stop
+void OutputScheduler::Start(SequenceData* seqData, int frameMS) {
+
+    if (_running) return;
+
+    {
+        std::unique_lock<std::mutex> lock(_positionLock);
+        _seqData = seqData;
+        _frameMS = std::max(frameMS, 1);
+        _havePosition = false;
+        _playing = false;
+    }
+
+    spdlog::debug("Starting output scheduler thread.");
+    _stopRequested = false;
+    _running = true;
+    _thread = std::thread(&OutputScheduler::Run, this);
+}
+
+void OutputScheduler::Stop() {
+
+    if (!_running) return;
+
+    spdlog::debug("Stopping output scheduler thread.");
+    {
+        std::unique_lock<std::mutex> lock(_stopLock);
+        _stopRequested = true;
+    }
+    _stopSignal.notify_all();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    _running = false;
+
+    spdlog::debug("Output scheduler sent {} frames, {} missed deadlines, latency p99 {}us, jitter p99 {}us.",
+        (uint64_t)_framesSent, (uint64_t)_missedDeadlines, _sendLatency.GetPercentile(99), _frameJitter.GetPercentile(99));
+}
+#pragma endregion
+
+#pragma region Playhead
+void OutputScheduler::SetPlayPosition(long ms, bool playing) {
+
+    std::unique_lock<std::mutex> lock(_positionLock);
+    _havePosition = true;
+    _playing = playing;
+    _anchorMS = ms;
+    _anchorTime = std::chrono::steady_clock::now();
+}
+
+void OutputScheduler::ClearPlayPosition() {
+
+    std::unique_lock<std::mutex> lock(_positionLock);
+    _havePosition = false;
+    _playing = false;
+}
+
+void OutputScheduler::SetSequenceData(SequenceData* seqData) {
+
+    std::unique_lock<std::mutex> lock(_positionLock);
+    _seqData = seqData;
+    _havePosition = false;
+    _playing = false;
+    if (_seqData != nullptr && _seqData->FrameTime() > 0) {
+        _frameMS = _seqData->FrameTime();
+    }
+}
+
+// must be called with _positionLock held
+int32_t OutputScheduler::GetFrameForDeadline(std::chrono::steady_clock::time_point deadline) {
+
+    if (!_havePosition || _seqData == nullptr || !_seqData->IsValidData() || _seqData->FrameTime() == 0) return -1;
+
+    long ms = _anchorMS;
+    if (_playing && deadline > _anchorTime) {
+        ms += (long)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - _anchorTime).count();
+    }
+    int32_t frame = ms / (long)_seqData->FrameTime();
+    if (frame < 0 || frame >= (int32_t)_seqData->NumFrames()) return -1;
+    return frame;
+}
+#pragma endregion
+
+#pragma region Statistics
+void OutputScheduler::ResetStats() {
+    _framesSent = 0;
+    _missedDeadlines = 0;
+    _sendLatency.Reset();
+    _frameJitter.Reset();
+}
+
+nlohmann::json OutputScheduler::GetStatsJSON() const {
+
+    nlohmann::json res;
+    res["running"] = (bool)_running;
+    {
+        std::unique_lock<std::mutex> lock(_positionLock);
+        res["frameMS"] = _frameMS;
+        res["playing"] = _havePosition && _playing;
+    }
+    res["framesSent"] = (uint64_t)_framesSent;
+    res["missedDeadlines"] = (uint64_t)_missedDeadlines;
+    res["duplicateFramesSkipped"] = _outputManager->GetDuplicateFramesSkipped();
+    res["sendLatency"] = _sendLatency.ToJSON();
+    res["frameJitter"] = _frameJitter.ToJSON();
+    return res;
+}
+#pragma endregion
+
+#pragma region Thread
+static void RaiseOutputThreadPriority() {
+#ifdef _WIN32
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+#elif defined(__APPLE__)
+    pthread_setname_np("OutputScheduler");
+    pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0);
+#else
+    pthread_setname_np(pthread_self(), "OutputScheduler");
+    // only succeeds with CAP_SYS_NICE/rtprio ... that is fine, we just run at normal priority
+    sched_param param{};
+    param.sched_priority = 10;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+        spdlog::debug("OutputScheduler: Unable to use real-time scheduling, running at normal priority.");
+    }
+#endif
+}
+
+void OutputScheduler::Run() {
+
+    using namespace std::chrono;
+
+    RaiseOutputThreadPriority();
+#ifdef _WIN32
+    timeBeginPeriod(1);
+#endif
+
+    auto const threadStart = steady_clock::now();
+    auto deadline = threadStart;
+    steady_clock::time_point lastStart;
+    bool haveLastStart = false;
+
+    while (!_stopRequested) {
+
+        int frameMS;
+        {
+            std::unique_lock<std::mutex> lock(_positionLock);
+            // pace to the sequence being played if there is one
+            frameMS = (_havePosition && _seqData != nullptr && _seqData->FrameTime() > 0) ? (int)_seqData->FrameTime() : _frameMS;
+        }
+        auto const frameTime = milliseconds(frameMS);
+        deadline += frameTime;
+
+        // sleep until just before the deadline then spin the rest for accuracy
+        {
+            std::unique_lock<std::mutex> lock(_stopLock);
+            _stopSignal.wait_until(lock, deadline - microseconds(OUTPUTSCHEDULER_SPIN_US), [this] { return _stopRequested.load(); });
+        }
+        if (_stopRequested) break;
+        while (steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+
+        auto const start = steady_clock::now();
+        if (haveLastStart) {
+            auto interval = duration_cast<microseconds>(start - lastStart).count();
+            _frameJitter.Add(std::abs(interval - (int64_t)frameMS * 1000));
+        }
+        lastStart = start;
+        haveLastStart = true;
+
+        _outputManager->StartFrame((long)duration_cast<milliseconds>(start - threadStart).count());
+        {
+            // the lock and the frame handle are held until the frame is sent as zero copy
+            // outputs reference the sequence data directly
+            std::unique_lock<std::mutex> lock(_positionLock);
+            int32_t frame = GetFrameForDeadline(deadline);
+            if (frame >= 0) {
+                auto fd = _seqData->Read(frame);
+                _outputManager->SetManyChannels(0, (unsigned char*)fd[0], _seqData->NumChannels());
+                _outputManager->EndFrame();
+            } else {
+                _outputManager->EndFrame();
+            }
+        }
+
+        auto const end = steady_clock::now();
+        _sendLatency.Add(duration_cast<microseconds>(end - start).count());
+        _framesSent++;
+
+        // if we are more than a frame behind skip the missed slots rather than bursting frames
+        if (end > deadline + frameTime) {
+            auto behind = (end - deadline) / frameTime;
+            _missedDeadlines += behind;
+            deadline += frameTime * behind;
+        }
+    }
+
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+#pragma endregion
@@ -0,0 +1,107 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+class OutputManager;
+class SequenceData;
+
+// Log2 bucketed histogram of microsecond durations. Bucket 0 holds [0, 2us),
+// bucket n holds [2^n, 2^(n+1)) us and the last bucket everything above.
+class OutputTimingHistogram
+{
+public:
+    static constexpr int NUM_BUCKETS = 26; // last bucket starts at ~33 seconds
+
+    void Add(int64_t us);
+    void Reset();
+
+    uint64_t GetCount() const;
+    int64_t GetPercentile(double pct) const; // upper bound of the bucket holding the percentile
+    nlohmann::json ToJSON() const;
+
+private:
+    mutable std::mutex _lock;
+    std::array<uint64_t, NUM_BUCKETS> _buckets = {};
+    uint64_t _count = 0;
+    int64_t _min = 0;
+    int64_t _max = 0;
+    double _total = 0;
+};
+
+// Owns a dedicated thread which drives OutputManager StartFrame/SetManyChannels/EndFrame
+// on absolute steady_clock deadlines so frame spacing does not depend on the UI timer.
+// The UI only tells the scheduler where the playhead is; between updates the
+// scheduler extrapolates the position from its own clock.
+class OutputScheduler
+{
+public:
+    OutputScheduler(OutputManager* outputManager);
+    ~OutputScheduler();
+
+    OutputScheduler(const OutputScheduler&) = delete;
+    OutputScheduler& operator=(const OutputScheduler&) = delete;
+
+    // frameMS is the pacing interval used when there is no sequence data to pace against
+    void Start(SequenceData* seqData, int frameMS = 50);
+    void Stop();
+    bool IsRunning() const { return _running; }
+
+    // Anchors the playhead. When playing the position advances with the clock until
+    // the next call; when not playing the frame at ms is held (scrubbing/pause).
+    void SetPlayPosition(long ms, bool playing);
+    // Stop sending sequence data. Frames are still started/ended so test patterns
+    // and duplicate frame keep-alives continue to go out.
+    void ClearPlayPosition();
+
+    void SetSequenceData(SequenceData* seqData);
+
+    uint64_t GetFramesSent() const { return _framesSent; }
+    uint64_t GetMissedDeadlines() const { return _missedDeadlines; }
+    const OutputTimingHistogram& GetSendLatency() const { return _sendLatency; }
+    const OutputTimingHistogram& GetFrameJitter() const { return _frameJitter; }
+    void ResetStats();
+    nlohmann::json GetStatsJSON() const;
+
+private:
+    void Run();
+    int32_t GetFrameForDeadline(std::chrono::steady_clock::time_point deadline);
+
+    OutputManager* _outputManager = nullptr;
+    std::thread _thread;
+    std::atomic_bool _running = false;
+    std::atomic_bool _stopRequested = false;
+    std::mutex _stopLock;
+    std::condition_variable _stopSignal;
+
+    mutable std::mutex _positionLock;
+    SequenceData* _seqData = nullptr;
+    int _frameMS = 50;
+    bool _havePosition = false;
+    bool _playing = false;
+    long _anchorMS = 0;
+    std::chrono::steady_clock::time_point _anchorTime;
+
+    std::atomic<uint64_t> _framesSent = 0;
+    std::atomic<uint64_t> _missedDeadlines = 0;
+    OutputTimingHistogram _sendLatency;
+    OutputTimingHistogram _frameJitter;
+};
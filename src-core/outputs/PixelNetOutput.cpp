@@ -60,11 +60,11 @@ void PixelNetOutput::EndFrame(int suppressFrames)
     {
         if (_serial != nullptr)
         {
-            if (_serial->WaitingToWrite() == 0)
+            if (CanWriteFrame())
             {
                 memcpy(&_serialBuffer[1], _data, sizeof(_data));
                 _serialBuffer[0] = 170;    // start of message
-                _serial->Write((char *)_serialBuffer, sizeof(_serialBuffer));
+                SerialWrite(_serialBuffer, sizeof(_serialBuffer));
                 FrameOutput();
             }
         }
@@ -49,7 +49,7 @@ void RenardOutput::EndFrame(int suppressFrames)
     {
         if (_serial != nullptr)
         {
-            _serial->Write((char *)&_data[0], _datalen);
+            SerialWrite(&_data[0], _datalen);
             FrameOutput();
         }
     }
@@ -26,6 +26,7 @@
 #include "OpenPixelNetOutput.h"
 #include "GenericSerialOutput.h"
 #include "OutputManager.h"
+#include "SerialWriter.h"
 #include "UtilFunctions.h"
 #include "../utils/AppCallbacks.h"
 
@@ -122,6 +123,7 @@ SerialOutput::SerialOutput() : Output() {
 
 SerialOutput::~SerialOutput() {
 
+    if (_writer != nullptr) delete _writer;
     if (_serial != nullptr) delete _serial;
 }
 
@@ -294,10 +296,12 @@ std::string SerialOutput::GetLongDescription() const {
 }
 
 size_t SerialOutput::TxNonEmptyCount() const {
+    if (_writer != nullptr && _writer->IsBusy()) return 1;
     return (_serial != nullptr) ? _serial->WaitingToWrite() : 0;
 }
 
 bool SerialOutput::TxEmpty() const {
+    if (_writer != nullptr && _writer->IsBusy()) return false;
     if (_serial != nullptr) return (_serial->WaitingToWrite() == 0);
     return true;
 }
@@ -388,6 +392,9 @@ bool SerialOutput::Open() {
         }
         else {
             spdlog::debug("    Serial port {} open.", _commPort);
+            if (_asyncWrite && _writer == nullptr) {
+                _writer = new SerialWriter(_serial, _commPort);
+            }
         }
     }
 
@@ -395,6 +402,16 @@ bool SerialOutput::Open() {
 }
 
 void SerialOutput::Close() {
+    if (_writer != nullptr) {
+        // throw away any frames the writer has not started on
+        delete _writer;
+        _writer = nullptr;
+    }
+    {
+        std::unique_lock<std::mutex> lock(_pendingLock);
+        _pending.clear();
+        _inFrame = false;
+    }
     if (_serial != nullptr) {
         // throw away any pending data
         _serial->Purge();
@@ -434,5 +451,65 @@ void SerialOutput::StartFrame(long msec) {
     }
 
     _timer_msec = msec;
+
+    std::unique_lock<std::mutex> lock(_pendingLock);
+    // the last frame was never flushed ... send it rather than merging it with this one
+    if (_inFrame) CommitPending();
+    _inFrame = true;
+    if (_framesDropped) {
+        _framesDropped = false;
+        ResendAll();
+    }
+}
+
+void SerialOutput::FlushFrame() {
+
+    std::unique_lock<std::mutex> lock(_pendingLock);
+    CommitPending();
+    _inFrame = false;
+}
+#pragma endregion
+
+#pragma region Writing
+void SerialOutput::SerialWrite(const uint8_t* data, size_t length, bool sendBreak) const {
+
+    if (_serial == nullptr || length == 0) return;
+
+    if (_writer == nullptr) {
+        if (sendBreak) {
+            _serial->SendBreak(); // sends a 1 millisecond break
+            std::this_thread::sleep_for(std::chrono::milliseconds(1)); // mark after break (MAB) - 1 millisecond is overkill (8 microseconds is the minimum dmx requirement)
+        }
+        _serial->Write((char*)data, length);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(_pendingLock);
+    // a break can only lead a frame
+    if (sendBreak) {
+        CommitPending();
+        _pendingBreak = true;
+    }
+    _pending.insert(_pending.end(), data, data + length);
+    if (!_inFrame) CommitPending();
+}
+
+bool SerialOutput::CanWriteFrame() const {
+
+    // the writer drops its oldest frame instead, and ResendAll covers what it held, so there is never a reason to skip
+    if (_writer != nullptr) return true;
+    return _serial != nullptr && _serial->WaitingToWrite() == 0;
+}
+
+// must be called with _pendingLock held
+void SerialOutput::CommitPending() const {
+
+    if (_writer != nullptr && !_pending.empty()) {
+        if (!_writer->Push(_pending.data(), _pending.size(), _pendingBreak)) {
+            _framesDropped = true;
+        }
+    }
+    _pending.clear();
+    _pendingBreak = false;
 }
 #pragma endregion
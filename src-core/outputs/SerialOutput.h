@@ -10,11 +10,13 @@
  * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <mutex>
 #include <vector>
 
 #include "Output.h"
 
 class SerialPort;
+class SerialWriter;
 
 class SerialOutput : public Output
 {
@@ -26,11 +28,26 @@ protected:
     int64_t _dieTime = 0;
     std::vector<uint8_t> _prefix;
     std::vector<uint8_t> _postfix;
+    SerialWriter* _writer = nullptr; // only set while asynchronous serial output is active
+    mutable std::mutex _pendingLock;
+    mutable std::vector<uint8_t> _pending; // bytes written during the current frame
+    mutable bool _pendingBreak = false;
+    mutable bool _framesDropped = false; // the writer dropped a queued frame to make room
+    bool _inFrame = false;
 #pragma endregion
 
     #pragma region Private Functions
     virtual void SaveAttr(pugi::xml_node node) override;
     void SetDontDieUntil(int64_t dieTime) { _dieTime = dieTime; }
+    // Writes to the port, or when there is a writer thread collects the bytes and hands
+    // them over as one frame in FlushFrame. Writes outside a frame are handed over at once.
+    void SerialWrite(const uint8_t* data, size_t length, bool sendBreak = false) const;
+    // false if the port still has the last frame to send and this one should be skipped
+    bool CanWriteFrame() const;
+    void CommitPending() const;
+    // Called at the start of a frame after the writer dropped a queued frame. Outputs that
+    // only send channels that changed must forget what they sent so the changes go out again.
+    virtual void ResendAll() {}
     #pragma endregion
 
 public:
@@ -95,5 +112,6 @@ public:
 
     #pragma region Frame Handling
     virtual void StartFrame(long msec) override;
+    virtual void FlushFrame() override;
     #pragma endregion 
 };
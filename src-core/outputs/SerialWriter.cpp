@@ -0,0 +1,171 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "SerialWriter.h"
+#include "serial.h"
+
+#include <chrono>
+#include <cstring>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#include <log.h>
+
+#pragma region Constructors and Destructors
+SerialWriter::SerialWriter(SerialPort* serial, const std::string& name, size_t depth) :
+    _serial(serial), _name(name) {
+
+    if (depth < 1) depth = 1;
+    _queue = std::vector<std::atomic<uint32_t>>(depth);
+    _frames.resize(depth + 2);
+    _free.resize(_frames.size());
+    for (size_t i = 0; i < _free.size(); i++) {
+        _free[i] = (uint32_t)i;
+    }
+    _freeWrite = _free.size();
+
+    _thread = std::thread(&SerialWriter::Run, this);
+}
+
+SerialWriter::~SerialWriter() {
+
+    _stopRequested = true;
+    _signal++;
+    _signal.notify_one();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+
+    spdlog::debug("SerialWriter {}: wrote {} frames ({} bytes), dropped {} frames.",
+        _name, (uint64_t)_framesWritten, (uint64_t)_bytesWritten, (uint64_t)_framesDropped);
+}
+#pragma endregion
+
+#pragma region Producer
+bool SerialWriter::Push(const uint8_t* data, size_t length, bool sendBreak) {
+
+    if (data == nullptr || length == 0) return true;
+
+    uint64_t const w = _write.load(std::memory_order_relaxed);
+    bool dropped = false;
+    uint32_t index = 0;
+
+    // if the ring is full take the oldest queued frame back unless the writer claims it first
+    while (true) {
+        uint64_t r = _read.load(std::memory_order_acquire);
+        if (w - r < _queue.size()) break;
+        uint32_t const oldest = _queue[r % _queue.size()].load(std::memory_order_relaxed);
+        if (_read.compare_exchange_strong(r, r + 1, std::memory_order_acq_rel)) {
+            index = oldest;
+            dropped = true;
+            _framesDropped++;
+            break;
+        }
+    }
+
+    if (!dropped) {
+        if (_freeRead == _freeWrite.load(std::memory_order_acquire)) {
+            // cannot happen with depth + 2 frames but never overwrite a frame in use
+            _framesDropped++;
+            return false;
+        }
+        index = _free[_freeRead % _free.size()];
+        _freeRead++;
+    }
+
+    auto& f = _frames[index];
+    if (f.data.size() < length) {
+        f.data.resize(length);
+    }
+    memcpy(f.data.data(), data, length);
+    f.length = length;
+    f.sendBreak = sendBreak;
+
+    _queue[w % _queue.size()].store(index, std::memory_order_relaxed);
+    _write.store(w + 1, std::memory_order_release);
+    _signal.fetch_add(1, std::memory_order_release);
+    _signal.notify_one();
+
+    return !dropped;
+}
+#pragma endregion
+
+#pragma region Writer Thread
+void SerialWriter::Run() {
+
+#ifdef __APPLE__
+    pthread_setname_np("SerialWriter");
+#elif !defined(_WIN32)
+    pthread_setname_np(pthread_self(), "SerialWriter");
+#endif
+
+    bool errorLogged = false;
+
+    while (!_stopRequested) {
+
+        uint32_t const signal = _signal.load(std::memory_order_acquire);
+        uint64_t r = _read.load(std::memory_order_acquire);
+        if (r == _write.load(std::memory_order_acquire)) {
+            _signal.wait(signal, std::memory_order_acquire);
+            continue;
+        }
+
+        _writing = true;
+        uint32_t const index = _queue[r % _queue.size()].load(std::memory_order_relaxed);
+        if (!_read.compare_exchange_strong(r, r + 1, std::memory_order_acq_rel)) {
+            // the producer dropped it to make room
+            _writing = false;
+            continue;
+        }
+
+        auto& f = _frames[index];
+        if (f.sendBreak) {
+            _serial->SendBreak();
+            // mark after break ... 1ms is overkill but it is off the frame thread now
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+#ifdef _WIN32
+        // writes are overlapped so the whole frame is handed to the driver in one go
+        int n = _serial->Write((char*)f.data.data(), f.length);
+        if (n < 0 && !errorLogged) {
+            spdlog::warn("SerialWriter {}: write failed {}.", _name, n);
+            errorLogged = true;
+        }
+        size_t done = n < 0 ? 0 : f.length;
+#else
+        // the port is non blocking so keep going until the whole frame is out rather than truncating it
+        size_t done = 0;
+        while (done < f.length && !_stopRequested) {
+            int n = _serial->Write((char*)f.data.data() + done, f.length - done);
+            if (n < 0) {
+                if (!errorLogged) {
+                    spdlog::warn("SerialWriter {}: write failed {}.", _name, n);
+                    errorLogged = true;
+                }
+                break;
+            }
+            if (n == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            done += n;
+        }
+#endif
+        _bytesWritten += done;
+        _framesWritten++;
+
+        _free[_freeWrite.load(std::memory_order_relaxed) % _free.size()] = index;
+        _freeWrite.fetch_add(1, std::memory_order_release);
+        _writing = false;
+    }
+}
+#pragma endregion
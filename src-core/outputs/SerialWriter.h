@@ -0,0 +1,84 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+class SerialPort;
+
+// Writes frames to a serial port on its own thread so a slow or blocked port
+// cannot stall the output frame. Frames are handed over through a lock free
+// single producer/single consumer ring. When the ring is full the oldest
+// unsent frame is dropped as the newer one supersedes it. That only holds for
+// outputs that send every channel each frame; outputs that send just what
+// changed must resend everything when Push reports a drop (see SerialOutput::ResendAll).
+//
+// Frame buffers circulate between the ring and a free list so the producer
+// never writes into a buffer the writer thread is still sending.
+class SerialWriter
+{
+public:
+    SerialWriter(SerialPort* serial, const std::string& name, size_t depth = 4);
+    ~SerialWriter();
+
+    SerialWriter(const SerialWriter&) = delete;
+    SerialWriter& operator=(const SerialWriter&) = delete;
+
+    // Copies the frame into the ring. Must only be called from one thread at a time.
+    // Returns false if an older frame had to be dropped to make room.
+    bool Push(const uint8_t* data, size_t length, bool sendBreak = false);
+
+    // true while frames are queued or being written
+    bool IsBusy() const { return _writing || _read.load() != _write.load(); }
+
+    uint64_t GetFramesWritten() const { return _framesWritten; }
+    uint64_t GetFramesDropped() const { return _framesDropped; }
+    uint64_t GetBytesWritten() const { return _bytesWritten; }
+
+private:
+    struct Frame {
+        std::vector<uint8_t> data;
+        size_t length = 0;
+        bool sendBreak = false;
+    };
+
+    void Run();
+
+    SerialPort* _serial = nullptr;
+    std::string _name;
+
+    // depth queued + one being written + one being filled
+    std::vector<Frame> _frames;
+
+    // ring of queued frame indexes, oldest at _read. Atomic as a stale slot can be
+    // read by a CAS that then loses the race.
+    std::vector<std::atomic<uint32_t>> _queue;
+    std::atomic<uint64_t> _read = 0;  // claimed by CAS: the writer to send a frame, the producer to drop one
+    std::atomic<uint64_t> _write = 0; // producer only
+
+    // frame indexes the writer has finished with, handed back to the producer
+    std::vector<uint32_t> _free;
+    uint64_t _freeRead = 0;                // producer only
+    std::atomic<uint64_t> _freeWrite = 0;  // writer only
+
+    std::atomic<uint32_t> _signal = 0; // bumped on every push and on stop so the writer can wait on it
+    std::atomic_bool _writing = false;
+    std::atomic_bool _stopRequested = false;
+    std::thread _thread;
+
+    std::atomic<uint64_t> _framesWritten = 0;
+    std::atomic<uint64_t> _framesDropped = 0;
+    std::atomic<uint64_t> _bytesWritten = 0;
+};
@@ -413,6 +413,15 @@ public:
             return false;
         }
 
+        return SendTo(remoteAddr, data, length);
+    }
+
+    bool SendTo(const sockaddr_in& remoteAddr, const uint8_t* data, size_t length)
+    {
+        if (_socket == INVALID_SOCKET_HANDLE || data == nullptr || length == 0) {
+            return false;
+        }
+
 #ifdef _WIN32
         const int sent = sendto(_socket, reinterpret_cast<const char*>(data), static_cast<int>(length), 0, reinterpret_cast<const sockaddr*>(&remoteAddr), sizeof(remoteAddr));
         if (sent < 0) {
@@ -541,6 +550,7 @@ public:
     }
 
     const std::string& LastError() const { return _lastError; }
+    SocketHandle GetHandle() const { return _socket; }
 
 private:
     SocketHandle _socket = INVALID_SOCKET_HANDLE;
@@ -0,0 +1,185 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "UDPBatchSender.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/uio.h>
+#endif
+
+#include <log.h>
+
+// sendmmsg accepts at most UIO_MAXIOV messages per call
+#define UDPBATCH_MAX_MESSAGES 1024
+
+UDPBatchSender::~UDPBatchSender()
+{
+    Close();
+}
+
+int UDPBatchSender::GetSocketIndex(const std::string& localIp, uint16_t localPort)
+{
+    std::string key = localIp + ":" + std::to_string(localPort);
+    auto it = _socketIndexes.find(key);
+    if (it != _socketIndexes.end()) {
+        return it->second;
+    }
+
+    auto socket = std::make_unique<sockets::UDPSocket>();
+    if (!socket->Bind(localIp, localPort, localPort != 0)) {
+        spdlog::error("UDPBatchSender: Error opening shared datagram for '{}'. {}", key, socket->LastError());
+        _socketIndexes[key] = -1;
+        return -1;
+    }
+    spdlog::debug("UDPBatchSender: Opened shared datagram for '{}'.", key);
+
+    int index = (int)_sockets.size();
+    _sockets.push_back(std::move(socket));
+    _socketIndexes[key] = index;
+    return index;
+}
+
+bool UDPBatchSender::Enqueue(const std::string& localIp, uint16_t localPort, const std::string& remoteIp, uint16_t remotePort, const uint8_t* data, size_t length)
+{
+    return EnqueueGather(localIp, localPort, remoteIp, remotePort, data, length, nullptr, 0);
+}
+
+bool UDPBatchSender::EnqueueGather(const std::string& localIp, uint16_t localPort, const std::string& remoteIp, uint16_t remotePort, const uint8_t* header, size_t headerLength, const uint8_t* payload, size_t payloadLength)
+{
+    if (header == nullptr || headerLength == 0) return false;
+    if (payload == nullptr) payloadLength = 0;
+
+    QueuedPacket packet{};
+    packet.remote.sin_family = AF_INET;
+    packet.remote.sin_port = htons(remotePort);
+    if (!sockets::parseIPv4(remoteIp, packet.remote.sin_addr)) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(_lock);
+    packet.socketIndex = GetSocketIndex(localIp, localPort);
+    if (packet.socketIndex < 0) return false;
+
+    packet.offset = _buffer.size();
+    packet.length = headerLength;
+    packet.payload = payload;
+    packet.payloadLength = payloadLength;
+    _buffer.insert(_buffer.end(), header, header + headerLength);
+    _packets.push_back(packet);
+    return true;
+}
+
+size_t UDPBatchSender::SendQueued(int socketIndex, const std::vector<size_t>& packetIndexes)
+{
+    auto& socket = _sockets[socketIndex];
+    size_t sent = 0;
+
+#ifdef __linux__
+    std::vector<mmsghdr> messages(std::min(packetIndexes.size(), (size_t)UDPBATCH_MAX_MESSAGES));
+    std::vector<iovec> iovecs(messages.size() * 2);
+
+    size_t next = 0;
+    while (next < packetIndexes.size()) {
+        size_t count = std::min(packetIndexes.size() - next, messages.size());
+        for (size_t i = 0; i < count; ++i) {
+            auto& p = _packets[packetIndexes[next + i]];
+            iovec* iov = &iovecs[i * 2];
+            iov[0].iov_base = &_buffer[p.offset];
+            iov[0].iov_len = p.length;
+            iov[1].iov_base = const_cast<uint8_t*>(p.payload);
+            iov[1].iov_len = p.payloadLength;
+            memset(&messages[i], 0x00, sizeof(mmsghdr));
+            messages[i].msg_hdr.msg_name = &p.remote;
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            messages[i].msg_hdr.msg_iov = iov;
+            messages[i].msg_hdr.msg_iovlen = p.payloadLength > 0 ? 2 : 1;
+        }
+
+        int res = sendmmsg(socket->GetHandle(), messages.data(), (unsigned int)count, 0);
+        _syscalls++;
+        if (res <= 0) {
+            // the first datagram in this batch failed ... skip it and carry on with the rest
+            if (_errors++ == 0) {
+                spdlog::warn("UDPBatchSender: sendmmsg failed. {}", sockets::getLastSocketErrorString());
+            }
+            ++next;
+        } else {
+            sent += res;
+            next += res;
+        }
+    }
+#else
+    for (auto i : packetIndexes) {
+        auto& p = _packets[i];
+        const uint8_t* data = &_buffer[p.offset];
+        size_t length = p.length;
+        if (p.payloadLength > 0) {
+            _scratch.assign(data, data + length);
+            _scratch.insert(_scratch.end(), p.payload, p.payload + p.payloadLength);
+            data = _scratch.data();
+            length = _scratch.size();
+        }
+        _syscalls++;
+        if (socket->SendTo(p.remote, data, length)) {
+            ++sent;
+        } else if (_errors++ == 0) {
+            spdlog::warn("UDPBatchSender: sendto failed. {}", socket->LastError());
+        }
+    }
+#endif
+    return sent;
+}
+
+size_t UDPBatchSender::Flush()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    if (_packets.empty()) return 0;
+
+    size_t sent = 0;
+    if (_sockets.size() == 1) {
+        std::vector<size_t> all(_packets.size());
+        for (size_t i = 0; i < all.size(); ++i) all[i] = i;
+        sent = SendQueued(0, all);
+    } else {
+        // keep the order packets were queued in within each socket
+        std::vector<std::vector<size_t>> bySocket(_sockets.size());
+        for (size_t i = 0; i < _packets.size(); ++i) {
+            bySocket[_packets[i].socketIndex].push_back(i);
+        }
+        for (size_t s = 0; s < bySocket.size(); ++s) {
+            if (!bySocket[s].empty()) {
+                sent += SendQueued((int)s, bySocket[s]);
+            }
+        }
+    }
+
+    _sentPackets += sent;
+    _packets.clear();
+    _buffer.clear();
+    return sent;
+}
+
+void UDPBatchSender::Close()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    _packets.clear();
+    _buffer.clear();
+    _sockets.clear();
+    _socketIndexes.clear();
+}
+
+size_t UDPBatchSender::GetQueuedCount() const
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    return _packets.size();
+}
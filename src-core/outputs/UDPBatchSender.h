@@ -0,0 +1,77 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "SocketAbstraction.h"
+
+// Collects every UDP datagram produced during one output frame and sends them
+// together when the frame ends.  Datagrams are grouped onto one shared socket per
+// local interface/source port so a show with hundreds of universes uses a handful
+// of sockets rather than one per universe.  On Linux the queue is flushed with
+// sendmmsg so a frame costs a few syscalls instead of one per packet; elsewhere it
+// falls back to one sendto per packet on the shared socket.
+class UDPBatchSender
+{
+public:
+    UDPBatchSender() = default;
+    ~UDPBatchSender();
+
+    UDPBatchSender(const UDPBatchSender&) = delete;
+    UDPBatchSender& operator=(const UDPBatchSender&) = delete;
+
+    // Copies the datagram into the frame queue. Safe to call from parallel EndFrame calls.
+    bool Enqueue(const std::string& localIp, uint16_t localPort, const std::string& remoteIp, uint16_t remotePort, const uint8_t* data, size_t length);
+
+    // Copies only the header. The payload is sent straight from the caller's memory using
+    // scatter-gather so it must stay valid and unchanged until Flush returns.
+    bool EnqueueGather(const std::string& localIp, uint16_t localPort, const std::string& remoteIp, uint16_t remotePort, const uint8_t* header, size_t headerLength, const uint8_t* payload, size_t payloadLength);
+
+    // Sends everything queued since the last flush. Returns the number of datagrams sent.
+    size_t Flush();
+
+    // Drops any queued datagrams and closes the shared sockets
+    void Close();
+
+    size_t GetQueuedCount() const;
+    uint64_t GetSentCount() const { return _sentPackets; }
+    uint64_t GetSyscallCount() const { return _syscalls; }
+    uint64_t GetErrorCount() const { return _errors; }
+
+private:
+    struct QueuedPacket {
+        sockaddr_in remote;
+        size_t offset;
+        size_t length;
+        const uint8_t* payload; // not owned, may be null
+        size_t payloadLength;
+        int socketIndex;
+    };
+
+    int GetSocketIndex(const std::string& localIp, uint16_t localPort);
+    size_t SendQueued(int socketIndex, const std::vector<size_t>& packetIndexes);
+
+    mutable std::mutex _lock;
+    std::vector<uint8_t> _buffer;
+    std::vector<uint8_t> _scratch; // reassembles gathered packets where there is no sendmmsg
+    std::vector<QueuedPacket> _packets;
+    std::map<std::string, int> _socketIndexes;
+    std::vector<std::unique_ptr<sockets::UDPSocket>> _sockets;
+    uint64_t _sentPackets = 0;
+    uint64_t _syscalls = 0;
+    uint64_t _errors = 0;
+};
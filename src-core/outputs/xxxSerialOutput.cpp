@@ -29,7 +29,7 @@ void xxxSerialOutput::SendHeartbeat() const {
     d[2] = 0x00;
     d[3] = 0x81;
     if (_serial != nullptr) {
-        _serial->Write((char*)d, 4);
+        SerialWrite(d, 4);
     }
 }
 
@@ -104,6 +104,14 @@ void xxxSerialOutput::ResetFrame() {
     _lastheartbeat = -1;
 }
 
+void xxxSerialOutput::ResendAll() {
+
+    // a dropped frame took the only command for some channels with it
+    memset(_lastSent, 0xFF, sizeof(_lastSent));
+    memset(_notSentCount, 0xF0, sizeof(_notSentCount));
+    _changed = true;
+}
+
 uint8_t xxxSerialOutput::PopulateBuffer(uint8_t* buffer, int32_t channel, uint8_t value) const {
     uint8_t device = GetDeviceFromChannel(channel);
     uint8_t channelOnDevice = GetChannelOnDevice(channel);
@@ -131,7 +139,7 @@ void xxxSerialOutput::EndFrame(int suppressFrames) {
                     _notSentCount[i] = 0;
                     uint8_t d[16];
                     uint8_t used = PopulateBuffer(d, i, _data[i]);
-                    _serial->Write((char*)d, used);
+                    SerialWrite(d, used);
                 }
             }
         }
@@ -201,7 +209,7 @@ void xxxSerialOutput::SetOneChannel(int32_t channel, unsigned char data) {
         //DumpBinary(d, used);
 
         if (_serial != nullptr) {
-            _serial->Write((char*)d, used);
+            SerialWrite(d, used);
             _lastSent[channel] = data;
         }
     }
@@ -109,6 +109,20 @@ public:
                 break;
         }
     }
+    virtual bool applyToLUT(uint8_t table[3][256]) const {
+        if (channel == 4) {
+            // only applies to greys, depends on all three channels at once
+            return false;
+        }
+        for (int ch = 0; ch < 3; ch++) {
+            if (channel == -1 || channel == ch) {
+                for (int x = 0; x < 256; x++) {
+                    table[ch][x] = data[table[ch][x]];
+                }
+            }
+        }
+        return true;
+    }
 
     int channel;
     unsigned char data[256];
@@ -235,6 +249,14 @@ public:
             blue->reverse(c);
         }
     }
+    virtual bool applyToLUT(uint8_t table[3][256]) const {
+        for (auto dc : { red, green, blue }) {
+            if (dc != nullptr && !dc->applyToLUT(table)) {
+                return false;
+            }
+        }
+        return true;
+    }
     DimmingCurve *red;
     DimmingCurve *green;
     DimmingCurve *blue;
@@ -248,6 +270,15 @@ DimmingCurve::~DimmingCurve()
 {
 }
 
+void DimmingCurve::compileLUT() {
+    for (int ch = 0; ch < 3; ch++) {
+        for (int x = 0; x < 256; x++) {
+            lut[ch][x] = x;
+        }
+    }
+    hasLUT = applyToLUT(lut);
+}
+
 static const std::string &validate(const std::string &in, const std::string &def) {
     if (in == "") {
         return def;
@@ -299,7 +330,11 @@ DimmingCurve *DimmingCurve::createFromInfo(const std::map<std::string, std::map<
             if (blue) {
                 delete blue;
             }
-            return createCurve(v.second);
+            DimmingCurve *dc = createCurve(v.second);
+            if (dc != nullptr) {
+                dc->compileLUT();
+            }
+            return dc;
         } else if ("red" == name) {
             if (red != nullptr) {
                 delete red;
@@ -318,18 +353,25 @@ DimmingCurve *DimmingCurve::createFromInfo(const std::map<std::string, std::map<
         }
     }
     if (red != nullptr || blue != nullptr || green != nullptr) {
-        return new CompositeDimmingCurve(red, green, blue);
+        DimmingCurve *dc = new CompositeDimmingCurve(red, green, blue);
+        dc->compileLUT();
+        return dc;
     }
     return nullptr;
 }
 
 DimmingCurve *DimmingCurve::createBrightnessGamma(int brightness, float gamma) {
     BasicDimmingCurve *c = new BasicDimmingCurve(brightness, gamma, -1);
+    c->compileLUT();
     return c;
 }
 DimmingCurve *DimmingCurve::createFromFile(const std::string &fileName) {
+    DimmingCurve *dc = nullptr;
     if (FileExists(fileName)) {
-        return new FileDimmingCurve(fileName, -1);
+        dc = new FileDimmingCurve(fileName, -1);
+    } else {
+        dc = new BasicDimmingCurve(100, 1.0, -1);
     }
-    return new BasicDimmingCurve(100, 1.0, -1);
+    dc->compileLUT();
+    return dc;
 }
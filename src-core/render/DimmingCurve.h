@@ -12,6 +12,7 @@
 
 #include "Color.h"
 
+#include <cstdint>
 #include <map>
 #include <string>
 
@@ -29,6 +30,16 @@ class DimmingCurve
         
         static DimmingCurve *createBrightnessGamma(int brightness, float gamma);
         static DimmingCurve *createFromFile(const std::string &file);
+
+        // apply() as a red, green and blue table, built once when the curve is
+        // created. nullptr if the curve mixes channels and so cannot be one.
+        const uint8_t (*GetLUT() const)[256] { return hasLUT ? lut : nullptr; }
+        // Composes this curve onto the table, false if it cannot be expressed as one
+        virtual bool applyToLUT(uint8_t table[3][256]) const = 0;
     protected:
     private:
+        void compileLUT();
+
+        uint8_t lut[3][256];
+        bool hasLUT = false;
 };
@@ -986,10 +986,10 @@ bool Effect::GetFrame(RenderBuffer &buffer, RenderCache &renderCache, const Sett
     return mCache && mCache->GetFrame(&buffer);
 }
 
-void Effect::AddFrame(RenderBuffer &buffer, RenderCache &renderCache) {
+void Effect::AddFrame(RenderBuffer &buffer, RenderCache &renderCache, uint64_t renderNs) {
     std::unique_lock<std::recursive_mutex> lock(settingsLock);
     if (mCache) {
-        mCache->AddFrame(&buffer);
+        mCache->AddFrame(&buffer, renderNs);
     }
 }
 
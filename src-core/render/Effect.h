@@ -195,7 +195,7 @@ public:
 
     //gets the cached frame.   Returns true if the frame was filled into the buffer
     bool GetFrame(RenderBuffer &buffer, RenderCache &renderCache, const SettingsMap &settings);
-    void AddFrame(RenderBuffer &buffer, RenderCache &renderCache);
+    void AddFrame(RenderBuffer &buffer, RenderCache &renderCache, uint64_t renderNs);
     void PurgeCache(bool deleteCachefile = false);
     
     
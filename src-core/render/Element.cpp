@@ -309,6 +309,65 @@ void Element::IncrementChangeCount(int sms, int ems)
     listener->IncrementChangeCount(this);
 }
 
+// Enough for a burst of scattered edits; past it the closest windows merge.
+static const size_t MAX_DIRTY_WINDOWS = 32;
+
+void Element::AddDirtyWindow(int start, int end) {
+    if (end < 0) {
+        return;
+    }
+    start = std::max(start, 0);
+    if (end < start) {
+        std::swap(start, end);
+    }
+    std::unique_lock<std::mutex> lock(dirtyWindowLock);
+    auto it = std::lower_bound(dirtyWindows.begin(), dirtyWindows.end(), std::make_pair(start, end));
+    it = dirtyWindows.insert(it, std::make_pair(start, end));
+    // merge with the neighbours it touches
+    if (it != dirtyWindows.begin() && std::prev(it)->second >= it->first) {
+        --it;
+        it->second = std::max(it->second, std::next(it)->second);
+        dirtyWindows.erase(std::next(it));
+    }
+    while (std::next(it) != dirtyWindows.end() && std::next(it)->first <= it->second) {
+        it->second = std::max(it->second, std::next(it)->second);
+        dirtyWindows.erase(std::next(it));
+    }
+    while (dirtyWindows.size() > MAX_DIRTY_WINDOWS) {
+        size_t best = 0;
+        for (size_t i = 1; i + 1 < dirtyWindows.size(); ++i) {
+            if (dirtyWindows[i + 1].first - dirtyWindows[i].second < dirtyWindows[best + 1].first - dirtyWindows[best].second) {
+                best = i;
+            }
+        }
+        dirtyWindows[best].second = dirtyWindows[best + 1].second;
+        dirtyWindows.erase(dirtyWindows.begin() + best + 1);
+    }
+}
+
+void Element::ClearDirtyWindows() {
+    std::unique_lock<std::mutex> lock(dirtyWindowLock);
+    dirtyWindows.clear();
+}
+
+std::vector<std::pair<int, int>> Element::GetDirtyWindows() const {
+    if (dirtyStart == -1) {
+        return {};
+    }
+    std::unique_lock<std::mutex> lock(dirtyWindowLock);
+    if (dirtyWindows.empty()) {
+        return { std::make_pair((int)dirtyStart, (int)dirtyEnd) };
+    }
+    return dirtyWindows;
+}
+
+std::vector<std::pair<int, int>> Element::GetAndResetDirtyWindows() {
+    std::vector<std::pair<int, int>> windows = GetDirtyWindows();
+    dirtyStart = dirtyEnd = -1;
+    ClearDirtyWindows();
+    return windows;
+}
+
 void SubModelElement::IncrementChangeCount(int startMs, int endMS) {
     GetModelElement()->IncrementChangeCount(startMs, endMS);
 }
@@ -111,6 +111,7 @@ public:
         startMs = dirtyStart;
         endMs = dirtyEnd;
         dirtyStart = dirtyEnd = -1;
+        ClearDirtyWindows();
     }
     void SetDirtyRange(int start, int end) {
         if (dirtyStart == -1) {
@@ -124,14 +125,26 @@ public:
                 dirtyStart = start;
             }
         }
+        AddDirtyWindow(start, end);
     }
     void ClearDirtyFlags() {
         dirtyStart = dirtyEnd = -1;
+        ClearDirtyWindows();
     }
+    // The dirty range is the span of everything changed since the row was
+    // last rendered; the windows are the separate pieces of it (one per
+    // edited effect unless they overlap) so an incremental render can skip
+    // the unchanged time in between.  Empty when the range is not set.
+    std::vector<std::pair<int, int>> GetDirtyWindows() const;
+    // Returns the windows and clears the dirty range as a render that covers
+    // all of them would.
+    std::vector<std::pair<int, int>> GetAndResetDirtyWindows();
     virtual void CleanupAfterRender();
     
 protected:
     EffectLayer* AddEffectLayerInternal();
+    void AddDirtyWindow(int start, int end);
+    void ClearDirtyWindows();
 
     SequenceElements *parent = nullptr;
 
@@ -147,6 +160,8 @@ protected:
     std::atomic<int> changeCount = 0;
     std::atomic<int> dirtyStart = -1;
     std::atomic<int> dirtyEnd = -1;
+    mutable std::mutex dirtyWindowLock;
+    std::vector<std::pair<int, int>> dirtyWindows; // sorted, disjoint
 
     std::recursive_timed_mutex changeLock;
 };
@@ -95,6 +95,9 @@ inline void AddSlowStorageWarning() {
     spdlog::warn("This is a warning, not an error.  It is likely that the FSEQ file is on a slow storage device.");
     spdlog::warn("If you are using a USB drive, please consider using a faster drive.");
 }
+
+#include "utils/PerfTrace.h"
+#define FSEQ_TRACE(name, block) PerfTrace::Span fseqTraceSpan("fseq", name, "block", block)
 #elif __has_include("fppversion.h")
 
 // for FPP, use FPP logging
@@ -103,6 +106,7 @@ inline void AddSlowStorageWarning() {
 inline void AddSlowStorageWarning() {
     WarningHolder::AddWarningTimeout("FSEQ Data Block not available - Likely slow storage", 90);
 }
+#define FSEQ_TRACE(name, block)
 #else	
 #define PLATFORM_UNKNOWN
 template<typename... Args>
@@ -112,6 +116,7 @@ static void LogInfo(int i, const char* fmt, Args... args) { }
 template<typename... Args>
 static void LogDebug(int i, const char* fmt, Args... args) { }
 inline void AddSlowStorageWarning() {}
+#define FSEQ_TRACE(name, block)
 #endif
 
 #ifndef VB_SEQUENCE
@@ -1193,23 +1198,26 @@ public:
             // decompresses as a stream and stops once the frames the block
             // contributes are out.  One-shot ZSTD_decompress would instead
             // insist on room for every concatenated frame in the range.
-            ZSTD_initDStream(dctx);
-            ZSTD_inBuffer_s in = { s.comp.data(), s.comp.size(), 0 };
-            ZSTD_outBuffer_s out = { s.out.data(), outSize, 0 };
-            while (out.pos < outSize && in.pos < in.size) {
-                size_t r = ZSTD_decompressStream(dctx, &out, &in);
-                if (ZSTD_isError(r)) {
-                    LogErr(VB_SEQUENCE, "Failed to decompress block %d: %s\n", (int)s.block, ZSTD_getErrorName(r));
-                    break;
+            {
+                FSEQ_TRACE("zstd block", (int)s.block);
+                ZSTD_initDStream(dctx);
+                ZSTD_inBuffer_s in = { s.comp.data(), s.comp.size(), 0 };
+                ZSTD_outBuffer_s out = { s.out.data(), outSize, 0 };
+                while (out.pos < outSize && in.pos < in.size) {
+                    size_t r = ZSTD_decompressStream(dctx, &out, &in);
+                    if (ZSTD_isError(r)) {
+                        LogErr(VB_SEQUENCE, "Failed to decompress block %d: %s\n", (int)s.block, ZSTD_getErrorName(r));
+                        break;
+                    }
+                    if (r == 0 && out.pos < outSize && in.pos < in.size) {
+                        ZSTD_initDStream(dctx); // on to the next concatenated frame
+                    }
                 }
-                if (r == 0 && out.pos < outSize && in.pos < in.size) {
-                    ZSTD_initDStream(dctx); // on to the next concatenated frame
+                if (out.pos < outSize) {
+                    // Leave no stale bytes from whatever block used this slot last.
+                    memset(&s.out[out.pos], 0, outSize - out.pos);
                 }
             }
-            if (out.pos < outSize) {
-                // Leave no stale bytes from whatever block used this slot last.
-                memset(&s.out[out.pos], 0, outSize - out.pos);
-            }
 
             lk.lock();
             s.state = SLOT_DONE;
@@ -1444,6 +1452,7 @@ public:
             // the first frame in the block would trigger decompressing all the frames in the
             // block immediately which, if there are a lot of frames, could take much longer
             // than we'd have available in a latency critical step.
+            FSEQ_TRACE("zstd frame", (int)m_curBlock);
             m_outBuffer.size = frameEnd;
             ZSTD_decompressStream(m_dctx, &m_outBuffer, &m_inBuffer);
             m_curFrameInBlock = frameInBlock + 1;
@@ -1793,6 +1802,7 @@ public:
             m_stream->avail_out = m_outBufferSize;
 
             if (m_outBuffer != nullptr) {
+                FSEQ_TRACE("zlib block", (int)m_curBlock);
                 inflate(m_stream, Z_SYNC_FLUSH);
             }
             inflateEnd(m_stream);
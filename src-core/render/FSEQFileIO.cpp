@@ -262,7 +262,7 @@ bool Write(const std::string& path,
     file->writeHeader();
     const uint32_t numFrames = static_cast<uint32_t>(seqData.NumFrames());
     for (uint32_t fr = 0; fr < numFrames; ++fr) {
-        file->addFrame(fr, &seqData[fr][0]);
+        file->addFrame(fr, seqData.Read(fr)[0]);
     }
     file->finalize();
 
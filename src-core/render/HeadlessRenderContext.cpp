@@ -172,6 +172,9 @@ bool HeadlessRenderContext::OpenSequence(const std::string& path) {
     const auto elementsEnd = std::chrono::steady_clock::now();
 
     EnsureSequenceDataSized();
+    if (!_renderCacheDir.empty()) {
+        _renderCache.SetSequence(_renderCacheDir, _sequenceFile->GetName());
+    }
     const auto sequenceDataEnd = std::chrono::steady_clock::now();
 
     auto openMS = std::chrono::duration_cast<std::chrono::milliseconds>(sequenceDataEnd - openStart).count();
@@ -198,8 +201,9 @@ void HeadlessRenderContext::EnsureRenderEngine() {
         // Enabled default with an empty cache folder — RenderEngine still ran the
         // GetFrame/AddFrame cache path in the frame-parallel workers with nowhere
         // to persist to.  A one-shot headless render has nothing to reuse a cache
-        // for, so disable it.  XL_HEADLESS_RENDERCACHE=1 opts back in.
-        if (getenv("XL_HEADLESS_RENDERCACHE") == nullptr) {
+        // for, so disable it.  XL_HEADLESS_RENDERCACHE=1 or EnableRenderCache
+        // opts back in.
+        if (_renderCacheDir.empty() && getenv("XL_HEADLESS_RENDERCACHE") == nullptr) {
             _renderCache.Enable("Disabled");
         }
         jobPool.Start(RenderEngine::RecommendedPoolSize());
@@ -207,6 +211,16 @@ void HeadlessRenderContext::EnsureRenderEngine() {
     }
 }
 
+void HeadlessRenderContext::EnableRenderCache(const std::string& cacheDir, bool shared) {
+    _renderCacheDir = cacheDir;
+    _renderCache.Enable("Enabled");
+    _renderCache.SetShareAcrossSequences(shared);
+}
+
+void HeadlessRenderContext::PurgeRenderCache() {
+    _renderCache.Purge(&_sequenceElements, true);
+}
+
 bool HeadlessRenderContext::RenderAndWait(int timeoutMs) {
     if (!IsSequenceLoaded()) {
         spdlog::error("HeadlessRenderContext: RenderAndWait with no sequence loaded");
@@ -51,6 +51,14 @@ public:
     // channel scope). Returns false if nothing is loaded/rendered or on I/O error.
     bool WriteFseq(const std::string& fseqPath);
 
+    // Keep a render cache under <cacheDir>/RenderCache like the desktop does,
+    // rather than the headless default of none. Call before OpenSequence.
+    // PurgeRenderCache deletes the open sequence's cached frames so the next
+    // render starts cold. With shared set, renders that do not depend on the
+    // sequence are also kept show wide for every sequence opened after.
+    void EnableRenderCache(const std::string& cacheDir, bool shared = false);
+    void PurgeRenderCache();
+
     // ---- RenderContext pieces the base does not provide ----
     // (IsInShow*Folder, MakeRelativePath, MoveToShowFolder, IsSequenceLoaded,
     // GetCurrentMediaManager, AbortRender, CloseSequence live on the base.)
@@ -72,4 +80,5 @@ private:
 
     int _previewWidth = 1280;
     int _previewHeight = 720;
+    std::string _renderCacheDir;
 };
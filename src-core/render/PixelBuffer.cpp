@@ -2373,6 +2373,53 @@ bool PixelBufferClass::IsPersistent(int layer) {
 bool PixelBufferClass::IsRenderingDisabled(int layer) const {
     return layers[layer]->renderingDisabled;
 }
+bool PixelBufferClass::IsLayerOpaque(int layer) const {
+    const LayerInfo* inf = layers[layer];
+    return !inf->renderingDisabled &&
+           !inf->canvas &&
+           inf->mixType == MixTypes::Mix_Normal &&
+           inf->effectMixThreshold == 0.0f && !inf->effectMixVaries &&
+           !inf->isChromaKey &&
+           inf->fadeInSteps == 0 && inf->fadeOutSteps == 0 &&
+           inf->suppressUntil == 0 &&
+           inf->modelBuffers == nullptr &&
+           !IsVariableSubBuffer(layer) &&
+           inf->bufferTransform == STR_NONE &&
+           inf->blur <= 1 && !inf->BlurValueCurve.IsActive() &&
+           inf->rotation == 0 && !inf->RotationValueCurve.IsActive() &&
+           inf->xrotation == 0 && !inf->XRotationValueCurve.IsActive() &&
+           inf->yrotation == 0 && !inf->YRotationValueCurve.IsActive() &&
+           inf->rotations == 0.0f && !inf->RotationsValueCurve.IsActive() &&
+           inf->zoom == 1.0f && !inf->ZoomValueCurve.IsActive() &&
+           !inf->buffer.IsDmxBuffer() &&
+           inf->buffer.allNodesMapped;
+}
+bool PixelBufferClass::CanRenderSparse(int layer) const {
+    const LayerInfo* inf = layers[layer];
+    if (inf->persistent || inf->modelBuffers != nullptr || IsVariableSubBuffer(layer) ||
+        inf->buffer.IsDmxBuffer() ||
+        inf->blur > 1 || inf->BlurValueCurve.IsActive() ||
+        inf->rotation != 0 || inf->RotationValueCurve.IsActive() ||
+        inf->xrotation != 0 || inf->XRotationValueCurve.IsActive() ||
+        inf->yrotation != 0 || inf->YRotationValueCurve.IsActive() ||
+        inf->rotations != 0.0f || inf->RotationsValueCurve.IsActive() ||
+        inf->zoom != 1.0f || inf->ZoomValueCurve.IsActive()) {
+        return false;
+    }
+    // wipes, slides and the like move or sample neighbouring cells
+    if ((inf->fadeInSteps > 0 && inf->inTransitionType != STR_FADE) ||
+        (inf->fadeOutSteps > 0 && inf->outTransitionType != STR_FADE)) {
+        return false;
+    }
+    // a canvas layer anywhere in the stack reads the cells beneath it
+    for (const auto* l : layers) {
+        if (l->canvas) {
+            return false;
+        }
+    }
+    return true;
+}
+
 int PixelBufferClass::GetFreezeFrame(int layer) {
     return layers[layer]->freezeAfterFrame;
 }
@@ -2679,6 +2726,7 @@ void PixelBufferClass::MergeBuffersForLayerScalar(int layer) {
 
 void PixelBufferClass::SetLayer(int layer, int period, bool resetState) {
     layers[layer]->buffer.SetState(period, resetState);
+    layers[layer]->buffer.SetSparseAllowed(CanRenderSparse(layer));
     if (layers[layer]->modelBuffers) {
         for (auto it = layers[layer]->modelBuffers->begin(); it != layers[layer]->modelBuffers->end(); ++it) {
             (*it)->SetState(period, resetState);
@@ -2743,7 +2791,31 @@ static void ReadClampedNode(NodeBaseClass& n, const unsigned char* fdata, size_t
 // whichever thread got there last.
 void PixelBufferClass::GetColors(unsigned char* fdata, const std::vector<bool>& restrictRange, unsigned int numChannels) {
     if (layers[0] != nullptr) { // I dont like this ... it should never be null
-        if (!anyDimmingCurve) {
+        RenderBuffer& rb = layers[0]->buffer;
+        if (!anyDimmingCurve && rb.allPlainNodes) {
+            // Every node is plain RGB: the mirror of SetColors, scatter each
+            // node's colour through the buffer's channel table rather than
+            // asking the node where its channels go.
+            const uint32_t* actChan = rb.nodeActChan.data();
+            const uint8_t* order = rb.nodeChanOrder.data();
+            const size_t nc = rb.nodeActChan.size();
+            xlColor color;
+            for (size_t i = 0; i < nc; ++i) {
+                const uint32_t start = actChan[i];
+                if (start >= numChannels) continue;
+                if (!IsInRange(restrictRange, start)) continue;
+
+                if (start + 3 > numChannels) {
+                    WriteClampedNode(*rb.Nodes[i], fdata, start, numChannels);
+                    continue;
+                }
+                rb.Nodes[i]->GetColorBase(color);
+                const uint8_t* o = &order[i * 3];
+                fdata[start + o[0]] = color.red;
+                fdata[start + o[1]] = color.green;
+                fdata[start + o[2]] = color.blue;
+            }
+        } else if (!anyDimmingCurve) {
             // Fast path: no model on this buffer has a dimming curve, so
             // skip the per-node GetDimmingCurve()/apply() block entirely.
             // Nodes of exactly NodeBaseClass (the dominant type - plain RGB
@@ -2775,6 +2847,11 @@ void PixelBufferClass::GetColors(unsigned char* fdata, const std::vector<bool>&
                 }
             }
         } else {
+            // Plain RGB nodes whose curve compiled to tables gather each
+            // colour through the table straight into the channel data.  The
+            // dimmed colour is not stored back on the node; the slow path
+            // below still does that for the other node types.
+            const std::type_info& baseTI = typeid(NodeBaseClass);
             for (auto& n : layers[0]->buffer.Nodes) {
                 if (n == nullptr) continue;
                 size_t start = n->ActChan;
@@ -2782,6 +2859,12 @@ void PixelBufferClass::GetColors(unsigned char* fdata, const std::vector<bool>&
                 if (IsInRange(restrictRange, start)) {
                     if (n->model != nullptr) { // nor this
                         DimmingCurve* curve = n->model->GetDimmingCurve();
+                        auto& node = *n;
+                        if (curve != nullptr && curve->GetLUT() != nullptr && typeid(node) == baseTI
+                            && start + n->GetChanCount() <= numChannels) {
+                            n->GetForChannelsBase(&fdata[start], curve->GetLUT());
+                            continue;
+                        }
                         if (curve != nullptr) {
                             if (n->GetChanCount() == 1) {
                                 uint8_t buf[3] = { 0, 0, 0 };
@@ -2825,7 +2908,46 @@ void PixelBufferClass::SetColors(int layer, const unsigned char* fdata, unsigned
     const size_t pixCnt = rb.GetPixelCount();
     const bool dmx = rb.IsDmxBuffer();
     const std::type_info& baseTI = typeid(NodeBaseClass);
-    if (!anyDimmingCurve) {
+    if (!anyDimmingCurve && !dmx && rb.allPlainNodes) {
+        // Every node is plain RGB: stream the buffer's channel table and
+        // indexVector rather than visiting the nodes.  The layer's node colours
+        // are left as they were, nothing reads them after SetColors - CalcOutput
+        // writes the colour of every node it outputs.
+        const uint32_t* actChan = rb.nodeActChan.data();
+        const uint8_t* order = rb.nodeChanOrder.data();
+        const uint32_t* index = rb.indexVector.data();
+        const size_t nc = rb.nodeActChan.size();
+        for (size_t i = 0; i < nc; ++i) {
+            const uint32_t start = actChan[i];
+            if (start >= numChannels) continue;
+
+            if (start + 3 > numChannels) {
+                // Reading past the frame would pull the NEXT frame's leading
+                // channels into this node (see WriteClampedNode).
+                ReadClampedNode(*rb.Nodes[i], fdata, start, numChannels);
+                rb.Nodes[i]->GetColorBase(color);
+            } else {
+                const uint8_t* o = &order[i * 3];
+                color.Set(fdata[start + o[0]], fdata[start + o[1]], fdata[start + o[2]]);
+            }
+
+            const uint32_t idx = index[i];
+            if (idx == 0xFFFFFFFF) {
+                continue;
+            }
+            if (idx & 0x80000000) {
+                // multi coord node: a count followed by its in-buffer pixels
+                const uint32_t* list = &index[idx & 0x7FFFFFFF];
+                for (uint32_t c = 1; c <= list[0]; ++c) {
+                    if (list[c] < pixCnt) {
+                        px[list[c]] = color;
+                    }
+                }
+            } else if (idx < pixCnt) {
+                px[idx] = color;
+            }
+        }
+    } else if (!anyDimmingCurve) {
         // Fast path: no model on this buffer has a dimming curve, so
         // skip the per-node GetDimmingCurve()/reverse() block entirely.
         for (const auto& n : rb.Nodes) {
@@ -427,6 +427,15 @@ public:
 
     void SetLayerSettings(int layer, const SettingsMap& settings, bool layerEnabled);
     bool IsRenderingDisabled(int layer) const;
+    // True when nothing under this layer can show through it, provided its
+    // effect fills the buffer opaque (RenderableEffect::IsOpaque): Normal mix
+    // at 100%, no fades or transitions, no chroma key, no rotozoom or blur to
+    // expose edges, and every node inside the buffer.
+    bool IsLayerOpaque(int layer) const;
+    // True when nothing after the effect on this layer reads buffer cells that
+    // no node samples (no blur, rotozoom, per-model buffers, moving
+    // transitions or canvas), so the effect may leave those cells unrendered.
+    bool CanRenderSparse(int layer) const;
     bool IsPersistent(int layer);
     int GetFreezeFrame(int layer);
     int GetSuppressUntil(int layer);
@@ -0,0 +1,260 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "RenderBenchmark.h"
+#include "HeadlessRenderContext.h"
+#include "RenderEngine.h"
+#include "RenderProfile.h"
+#include "utils/UtilFunctions.h"
+#include "xLightsVersion.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <log.h>
+
+namespace
+{
+    long long MSSince(std::chrono::steady_clock::time_point start) {
+        return (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    nlohmann::json Summarise(std::vector<double> values) {
+        nlohmann::json res = nlohmann::json::object();
+        if (values.empty()) return res;
+        std::sort(values.begin(), values.end());
+        double sum = 0;
+        for (auto v : values) {
+            sum += v;
+        }
+        size_t const mid = values.size() / 2;
+        res["min"] = values.front();
+        res["max"] = values.back();
+        res["median"] = values.size() % 2 == 1 ? values[mid] : (values[mid - 1] + values[mid]) / 2.0;
+        res["mean"] = sum / values.size();
+        return res;
+    }
+
+    nlohmann::json ProfileToJson(const RenderJobProfile& p) {
+        nlohmann::json stages;
+        stages["effect"] = p.effectNs;
+        stages["blurZoom"] = p.blurZoomNs;
+        stages["transition"] = p.transitionNs;
+        stages["blend"] = p.blendNs;
+        stages["getColors"] = p.getColorsNs;
+        stages["setColors"] = p.setColorsNs;
+        stages["gpuWait"] = p.gpuWaitNs;
+        stages["suspended"] = p.suspendedNs;
+        stages["slice"] = p.sliceNs;
+        stages["gpuBusy"] = p.gpuBusyNs;
+
+        nlohmann::json effects = nlohmann::json::object();
+        for (const auto& it : p.perEffectNs) {
+            nlohmann::json e;
+            e["ns"] = it.second;
+            auto c = p.perEffectCount.find(it.first);
+            e["count"] = c == p.perEffectCount.end() ? 0 : c->second;
+            auto g = p.perEffectGpuNs.find(it.first);
+            if (g != p.perEffectGpuNs.end()) {
+                e["gpuNs"] = g->second;
+            }
+            effects[it.first] = e;
+        }
+
+        nlohmann::json res;
+        res["stagesNs"] = stages;
+        res["effects"] = effects;
+        res["rowFrames"] = p.frames;
+        res["slices"] = p.slices;
+        res["suspends"] = p.suspends;
+        res["occludedLayerFrames"] = p.occludedLayerFrames;
+        res["bufferCells"] = p.bufferCells;
+        res["occupiedCells"] = p.occupiedCells;
+        return res;
+    }
+}
+
+#pragma region Constructors and Destructors
+RenderBenchmark::RenderBenchmark(const RenderBenchmarkOptions& options) :
+    _options(options) {
+
+    if (_options.iterations < 1) _options.iterations = 1;
+    if (_options.cacheDir.empty()) _options.cacheDir = _options.showDir;
+}
+
+RenderBenchmark::~RenderBenchmark() {
+    RenderEngine::SetRenderProfileSink(nullptr);
+    if (_context != nullptr) {
+        delete _context;
+        _context = nullptr;
+    }
+}
+#pragma endregion
+
+#pragma region Run
+bool RenderBenchmark::Run() {
+
+    _results = nlohmann::json::object();
+    _results["version"] = xlights_version_string;
+    _results["cpu"] = GetCPUBrand();
+    _results["logicalCores"] = GetLogicalCoreCount();
+    _results["physicalCores"] = GetPhysicalCoreCount();
+    _results["gpu"] = GetGPUDescription();
+    _results["show"] = _options.showDir;
+    _results["iterations"] = _options.iterations;
+    _results["renderCache"] = _options.renderCache;
+    _results["sharedRenderCache"] = _options.renderCache && _options.sharedRenderCache;
+    _results["sequences"] = nlohmann::json::array();
+
+    // must be in place before the first render so the engine collects the profile
+    RenderEngine::SetRenderProfileSink([this](const RenderJobProfile& total, long long elapsedMS, int, int) {
+        OnProfile(total, elapsedMS);
+    });
+
+    if (_context != nullptr) delete _context;
+    _context = new HeadlessRenderContext();
+    _sharedPurged = false;
+    if (_options.renderCache) {
+        _context->EnableRenderCache(_options.cacheDir, _options.sharedRenderCache);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (!_context->LoadShowFolder(_options.showDir, _options.mediaFolders)) {
+        spdlog::error("RenderBenchmark: Unable to load show folder '{}'.", _options.showDir);
+        _results["error"] = "Unable to load show folder";
+        _results["peakRssMB"] = GetProcessPeakMemoryUsageMB();
+        return false;
+    }
+    _results["loadShowMs"] = MSSince(start);
+
+    bool ok = false;
+    for (const auto& s : _options.sequences) {
+        nlohmann::json seq;
+        if (RunSequence(s, seq)) {
+            ok = true;
+        }
+        _results["sequences"].push_back(seq);
+    }
+
+    RenderEngine::SetRenderProfileSink(nullptr);
+    _results["peakRssMB"] = GetProcessPeakMemoryUsageMB();
+    return ok;
+}
+
+bool RenderBenchmark::RunSequence(const std::string& sequence, nlohmann::json& out) {
+
+    out["file"] = sequence;
+
+    auto start = std::chrono::steady_clock::now();
+    if (!_context->OpenSequence(sequence)) {
+        spdlog::error("RenderBenchmark: Unable to open sequence '{}'.", sequence);
+        out["error"] = "Unable to open sequence";
+        return false;
+    }
+    out["openMs"] = MSSince(start);
+
+    unsigned int const frames = _context->GetSeqData().NumFrames();
+    out["frames"] = frames;
+    out["channels"] = _context->GetSeqData().NumChannels();
+    out["frameMs"] = _context->GetSeqData().FrameTime();
+
+    std::vector<double> wall;
+    std::vector<double> fps;
+    nlohmann::json iterations = nlohmann::json::array();
+    for (int i = 0; i < _options.iterations; i++) {
+
+        std::string cache = "uncached";
+        if (_options.renderCache) {
+            if (i == 0) {
+                _context->PurgeRenderCache();
+                if (!_sharedPurged) {
+                    _context->_renderCache.PurgeShared();
+                    _sharedPurged = true;
+                }
+                cache = "cold";
+            } else {
+                cache = "warm";
+            }
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(_profileLock);
+            _profile = std::make_unique<RenderJobProfile>();
+            _batches = 0;
+        }
+
+        RenderCacheStats const before = _context->_renderCache.GetStats();
+        JobPoolStats const poolBefore = _context->jobPool.GetStats();
+        start = std::chrono::steady_clock::now();
+        bool const rendered = _context->RenderAndWait();
+        auto const ms = MSSince(start);
+
+        nlohmann::json it;
+        {
+            std::unique_lock<std::mutex> lock(_profileLock);
+            it = ProfileToJson(*_profile);
+            it["batches"] = _batches;
+        }
+        it["iteration"] = i;
+        it["cache"] = cache;
+        it["wallMs"] = ms;
+        double const f = ms > 0 ? frames * 1000.0 / ms : 0.0;
+        it["fps"] = f;
+        it["rendered"] = rendered;
+        if (_options.renderCache) {
+            RenderCacheStats const after = _context->_renderCache.GetStats();
+            it["cacheHits"] = after.hits - before.hits;
+            it["cacheMisses"] = after.misses - before.misses;
+            if (_options.sharedRenderCache) {
+                it["cacheSharedItems"] = after.sharedItems - before.sharedItems;
+            }
+        }
+        // scheduling overhead: how often workers had to steal or wait on a deque lock
+        JobPoolStats const poolAfter = _context->jobPool.GetStats();
+        it["jobsQueued"] = poolAfter.pushed - poolBefore.pushed;
+        it["jobsStolen"] = poolAfter.stolen - poolBefore.stolen;
+        it["jobQueueContended"] = poolAfter.contended - poolBefore.contended;
+        iterations.push_back(it);
+
+        spdlog::info("RenderBenchmark: {} iteration {} ({}) {}ms {:.1f} fps.", sequence, i, cache, ms, f);
+
+        if (!rendered) {
+            out["error"] = "Render did not complete";
+            break;
+        }
+
+        // the cold pass is reported with the rest but kept out of the summary
+        // when there are warm passes to summarise
+        if (!_options.renderCache || i > 0 || _options.iterations == 1) {
+            wall.push_back((double)ms);
+            fps.push_back(f);
+        }
+    }
+    out["iterations"] = iterations;
+
+    nlohmann::json summary;
+    summary["wallMs"] = Summarise(wall);
+    summary["fps"] = Summarise(fps);
+    out["summary"] = summary;
+
+    _context->CloseSequence();
+    return !out.contains("error");
+}
+
+void RenderBenchmark::OnProfile(const RenderJobProfile& profile, long long elapsedMS) {
+
+    std::unique_lock<std::mutex> lock(_profileLock);
+    if (_profile != nullptr) {
+        _profile->merge(profile);
+        _batches++;
+    }
+}
+#pragma endregion
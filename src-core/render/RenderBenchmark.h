@@ -0,0 +1,73 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+class HeadlessRenderContext;
+struct RenderJobProfile;
+
+struct RenderBenchmarkOptions {
+    std::string showDir;
+    std::list<std::string> mediaFolders;
+    std::list<std::string> sequences;
+    int iterations = 3;
+    // with the cache on the first iteration of each sequence renders cold
+    // (cache purged) and the rest render warm from it
+    bool renderCache = true;
+    // keep the show wide cache tier too; it is purged once at the start so the
+    // cold pass of each later sequence shows what it gains from the earlier ones
+    bool sharedRenderCache = false;
+    std::string cacheDir; // defaults to the show folder
+};
+
+// Renders each sequence of a show a number of times through a
+// HeadlessRenderContext and collects the render profile of every pass so
+// render performance can be tracked run to run. Results are JSON:
+//
+//   { version, cpu, cores, gpu, show, loadShowMs, peakRssMB,
+//     sequences: [ { file, frames, channels, openMs,
+//                    iterations: [ { cache, wallMs, fps, stagesNs {..}, effects {..} } ],
+//                    summary { wallMs { min, median, mean }, fps { .. } } } ] }
+//
+// Rendering needs whatever GL/video setup the caller normally does for a
+// headless render to have been done already.
+class RenderBenchmark {
+public:
+    RenderBenchmark(const RenderBenchmarkOptions& options);
+    ~RenderBenchmark();
+
+    RenderBenchmark(const RenderBenchmark&) = delete;
+    RenderBenchmark& operator=(const RenderBenchmark&) = delete;
+
+    // Returns false if the show could not be loaded or no sequence rendered
+    bool Run();
+
+    const nlohmann::json& GetResults() const { return _results; }
+
+private:
+    bool RunSequence(const std::string& sequence, nlohmann::json& out);
+    void OnProfile(const RenderJobProfile& profile, long long elapsedMS);
+
+    RenderBenchmarkOptions _options;
+    HeadlessRenderContext* _context = nullptr;
+    bool _sharedPurged = false; // the show wide tier is only purged before the first sequence
+    nlohmann::json _results;
+
+    std::mutex _profileLock;
+    std::unique_ptr<RenderJobProfile> _profile; // batches completed in the current iteration
+    int _batches = 0;
+};
@@ -180,7 +180,10 @@ uint64_t RenderBuffer::GetApproxMemoryBytes() const
                + (uint64_t)tempbufVector.capacity() * sizeof(xlColor)
                + (uint64_t)transformScratch.capacity() * sizeof(xlColor)
                + (uint64_t)blendBuffer.capacity() * sizeof(uint32_t)
-               + (uint64_t)indexVector.capacity() * sizeof(uint32_t);
+               + (uint64_t)indexVector.capacity() * sizeof(uint32_t)
+               + (uint64_t)nodeActChan.capacity() * sizeof(uint32_t)
+               + (uint64_t)nodeChanOrder.capacity()
+               + (uint64_t)occupiedRuns.capacity() * sizeof(CellRun);
     // Each node is an individually-allocated clone; on a whole-house group
     // buffer there are tens of thousands of them, so they are not noise.
     b += (uint64_t)Nodes.capacity() * sizeof(NodeBaseClassPtr);
@@ -257,6 +260,7 @@ void RenderBuffer::InitBuffer(int newBufferHt, int newBufferWi, const std::strin
         }
     }
     allSimpleIndex = true;
+    allNodesMapped = !Nodes.empty();
     int idx = 0;
     int extraIdx = Nodes.size();
     for (auto &n : Nodes) {
@@ -274,6 +278,9 @@ void RenderBuffer::InitBuffer(int newBufferHt, int newBufferWi, const std::strin
                     indexVector[extraIdx++] = pidx;
                 }
             }
+            if (indexVector[countIdx] == 0) {
+                allNodesMapped = false;
+            }
         } else if (n->Coords.empty()) {
             // Node with zero coords - same sentinel as a node whose single
             // coord is out of bounds. The Metal twin of this loop
@@ -281,16 +288,83 @@ void RenderBuffer::InitBuffer(int newBufferHt, int newBufferWi, const std::strin
             // guard since eea63c430; without it Coords[0] below indexes an
             // empty vector.
             indexVector[idx] = 0xFFFFFFFF;
+            allNodesMapped = false;
         } else if (n->Coords[0].bufY < 0 || n->Coords[0].bufY >= BufferHt ||
                    n->Coords[0].bufX < 0 || n->Coords[0].bufX >= BufferWi ) {
             indexVector[idx] = 0xFFFFFFFF;
+            allNodesMapped = false;
         } else {
             int32_t pidx = n->Coords[0].bufY * BufferWi + n->Coords[0].bufX;
             indexVector[idx] = pidx;
         }
         ++idx;
     }
-    
+
+    // Occupancy mask: which cells some node actually samples. Per-pixel
+    // effects that opt in via ForEachOccupiedRun only compute these cells.
+    // Runs are only kept when enough of the buffer is empty to be worth it;
+    // short gaps are merged so a nearly-full row stays one run.
+    occupiedRuns.clear();
+    occupiedCount = 0;
+    if (NumPixels > 0) {
+        std::vector<uint8_t> mask(NumPixels, 0);
+        for (auto &n : Nodes) {
+            for (auto &c : n->Coords) {
+                if (c.bufY >= 0 && c.bufY < BufferHt && c.bufX >= 0 && c.bufX < BufferWi) {
+                    uint8_t& m = mask[c.bufY * BufferWi + c.bufX];
+                    occupiedCount += (m == 0);
+                    m = 1;
+                }
+            }
+        }
+        if (occupiedCount < (uint32_t)(NumPixels * SPARSE_OCCUPANCY_LIMIT)) {
+            uint32_t i = 0;
+            while (i < (uint32_t)NumPixels) {
+                while (i < (uint32_t)NumPixels && !mask[i]) {
+                    ++i;
+                }
+                if (i == (uint32_t)NumPixels) {
+                    break;
+                }
+                uint32_t s = i;
+                while (i < (uint32_t)NumPixels && mask[i]) {
+                    ++i;
+                }
+                if (!occupiedRuns.empty() && s - occupiedRuns.back().end < SPARSE_MIN_GAP) {
+                    occupiedRuns.back().end = i;
+                } else {
+                    occupiedRuns.push_back({ s, i });
+                }
+            }
+        }
+    }
+
+    const std::type_info& baseTI = typeid(NodeBaseClass);
+    allPlainNodes = !Nodes.empty();
+    for (auto &n : Nodes) {
+        auto& node = *n;
+        if (typeid(node) != baseTI || n->GetChanCount() != 3 ||
+            n->GetChannelOffsetBase(0) == 255 || n->GetChannelOffsetBase(1) == 255 || n->GetChannelOffsetBase(2) == 255) {
+            allPlainNodes = false;
+            break;
+        }
+    }
+    if (allPlainNodes) {
+        nodeActChan.resize(Nodes.size());
+        nodeChanOrder.resize(Nodes.size() * 3);
+        idx = 0;
+        for (auto &n : Nodes) {
+            nodeActChan[idx] = n->ActChan;
+            for (int c = 0; c < 3; ++c) {
+                nodeChanOrder[idx * 3 + c] = n->GetChannelOffsetBase(c);
+            }
+            ++idx;
+        }
+    } else {
+        nodeActChan.clear();
+        nodeChanOrder.clear();
+    }
+
     isTransformed = (bufferTransform != "None");
 }
 
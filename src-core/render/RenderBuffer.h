@@ -17,6 +17,7 @@
 #include <list>
 #include <vector>
 #include <atomic>
+#include <algorithm>
 #include "../../include/globals.h"
 
 #include "Color.h"
@@ -531,6 +532,9 @@ public:
     inline uint64_t hashRandomFrameSeed() const {
         return rngHashInput(0);
     }
+    // The per-effect base every stream above derives from. Two effects with the
+    // same base seed draw the same random numbers on the same frames.
+    uint64_t GetRandomBaseSeed() const { return rngBaseSeed; }
     // Force the next rand01()/randInt() this frame to reseed from scratch (as if
     // the frame were drawn for the first time). The serial RNG already reseeds
     // per frame via ensureRandomSeed(); this lets the XL_VERIFY_STATELESS harness
@@ -573,12 +577,62 @@ private:
     std::vector<uint32_t> blendBuffer;
     std::vector<uint32_t> indexVector;
     bool allSimpleIndex = true;
+    // every node has at least one coordinate inside the buffer, so a buffer
+    // filled edge to edge gives every node a colour
+    bool allNodesMapped = false;
     // true when two nodes share an ActChan (e.g. a group listing a nested
     // group plus that group's members) — parallel per-node channel writes
     // would race for the shared channel, so callers must use serial paths
     bool dupActChans = false;
+    // The channel side of indexVector, built with it: each node's first
+    // channel and which of its channels hold red, green and blue (3 per node).
+    // Only filled when every node is a plain RGB NodeBaseClass, which lets
+    // PixelBufferClass::SetColors and GetColors run as one loop over these
+    // arrays instead of visiting the nodes one heap object at a time.
+    std::vector<uint32_t> nodeActChan;
+    std::vector<uint8_t> nodeChanOrder;
+    bool allPlainNodes = false;
+    // Occupancy of the buffer by node coordinates, built in InitBuffer.
+    // occupiedRuns is a sorted list of [start, end) cell-index ranges covering
+    // every occupied cell (small gaps merged in); it is left empty when the
+    // buffer is dense enough that skipping cells would not pay.
+    struct CellRun {
+        uint32_t start;
+        uint32_t end;
+    };
+    static constexpr float SPARSE_OCCUPANCY_LIMIT = 0.75f;
+    static constexpr uint32_t SPARSE_MIN_GAP = 16;
+    std::vector<CellRun> occupiedRuns;
+    uint32_t occupiedCount = 0;
+    // Set per frame by PixelBufferClass when nothing downstream of the effect
+    // (blur, rotozoom, transitions, canvas...) reads unoccupied cells.
+    bool sparseAllowed = false;
 public:
     uint32_t GetPixelCount() { return pixelVector.size(); }
+    uint32_t GetOccupiedCount() const { return occupiedCount; }
+    float GetOccupancy() const { return pixelVector.empty() ? 1.0f : (float)occupiedCount / (float)pixelVector.size(); }
+    void SetSparseAllowed(bool b) { sparseAllowed = b; }
+    // True when ForEachOccupiedRun will actually skip cells this frame.
+    bool IsSparse() const { return sparseAllowed && !isTransformed && !occupiedRuns.empty(); }
+    // Calls f(s, e) for each occupied sub-range of the cell range [start, end).
+    // Per-pixel effects wrap their kernel in this to leave cells no node reads
+    // untouched; on a dense buffer it is a single f(start, end).
+    template<class F>
+    void ForEachOccupiedRun(int start, int end, F&& f) const {
+        if (!IsSparse()) {
+            f(start, end);
+            return;
+        }
+        auto it = std::upper_bound(occupiedRuns.begin(), occupiedRuns.end(), (uint32_t)start,
+                                   [](uint32_t v, const CellRun& r) { return v < r.end; });
+        for (; it != occupiedRuns.end() && (int)it->start < end; ++it) {
+            int s = std::max(start, (int)it->start);
+            int e = std::min(end, (int)it->end);
+            if (s < e) {
+                f(s, e);
+            }
+        }
+    }
     xlColor *GetPixels() { return pixels; }
     // Hand pixel storage back to the CPU-owned vector. A GPU backend may point
     // `pixels` into its own mapping; InitBuffer then deliberately keeps that
@@ -9,30 +9,36 @@
  **************************************************************/
 
 #include "RenderCache.h"
+#include "RenderCachePack.h"
 #include "SequenceElements.h"
 #include "RenderBuffer.h"
 #include "models/Model.h"
 
 #include <log.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <filesystem>
+#include <set>
 #include <spdlog/fmt/fmt.h>
 #include <functional>
 #include <thread>
+#include <type_traits>
 #include "xLightsVersion.h"
 #include "UtilFunctions.h"
 #include "utils/TraceLog.h"
 #include "utils/ExternalHooks.h"
 
 #ifdef __APPLE__
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <unistd.h>
 #define USE_MMAP_RENDERCACHE
 #endif
 
+// every cached effect of a sequence lives in this one file in the sequence's cache folder
+#define RENDER_CACHE_PACK "render.pack"
+// the show wide pack lives in a folder of its own alongside the sequence folders
+#define RENDER_CACHE_SHARED "Shared_RENDER_CACHE"
+
 #pragma region RenderCache
 
 namespace fs = std::filesystem;
@@ -45,36 +51,49 @@ static void RenderCacheLoadThreadEntry(RenderCache* cache)
 
     spdlog::get("render")->debug("Loading cache.");
 
+    // render caches from before the pack are one .cache file per effect, they
+    // cannot be used so clear them out
     std::string cacheFolder = cache->GetCacheFolder();
-    std::vector<std::string> files;
     std::error_code ec;
     if (fs::exists(cacheFolder, ec)) {
-        for (const auto& entry : fs::recursive_directory_iterator(cacheFolder, ec)) {
+        for (const auto& entry : fs::directory_iterator(cacheFolder, ec)) {
             if (entry.is_regular_file() && entry.path().extension() == ".cache") {
-                files.push_back(entry.path().string());
+                fs::remove(entry.path(), ec);
             }
         }
     }
 
-    for (const auto& it : files) {
-        // allow up to 3 times physical memory
-        // This means the render cache will be swapped out ... but I think that is still better than re-rendering
-        // Abandon loading render cache if we use too much memory
-        if (IsExcessiveMemoryUsage(3.0)) {
-            spdlog::get("render")->warn("Render cache loading abandoned due to too much memory use.");
-            break;
-        }
+    auto pack = cache->GetPack(cache->GetPackGeneration());
+    std::list<RenderCachePackItem*> stored;
+    if (pack == nullptr || !pack->Open(stored)) {
+        spdlog::get("render")->warn("Unable to open the render cache in {}.", cacheFolder);
+    }
 
-        auto rci = new RenderCacheItem(cache, it);
+    for (auto it : stored) {
+        auto rci = new RenderCacheItem(cache, *it);
+        delete it;
         if (!rci->IsPurged()) {
             cache->AddCacheItem(rci);
         } else {
             delete rci;
-            spdlog::get("render")->warn("Failed to load cache item {}.", (const char*)it.c_str());
         }
     }
 
-    spdlog::get("render")->debug("Cache contained {} files.", (int)files.size());
+    spdlog::get("render")->debug("Cache contained {} items.", (int)stored.size());
+
+    // shared items are read as effects ask for them, opening only builds the index
+    auto shared = cache->GetSharedPack(cache->GetSharedPackGeneration());
+    if (shared != nullptr && !shared->IsOpen()) {
+        std::list<RenderCachePackItem*> sharedItems;
+        if (shared->Open(sharedItems)) {
+            spdlog::get("render")->debug("Shared render cache contained {} items.", (int)sharedItems.size());
+        } else {
+            spdlog::get("render")->warn("Unable to open the shared render cache {}.", shared->GetFile());
+        }
+        for (auto it : sharedItems) {
+            delete it;
+        }
+    }
     TraceLog::ClearTraceMessages();
 }
 
@@ -86,6 +105,7 @@ RenderCache::RenderCache()
 RenderCache::~RenderCache()
 {
     Close();
+    CloseSharedPack();
 
     EnforceMaximumSize();
 }
@@ -96,6 +116,13 @@ void RenderCache::SetMaximumSizeMB(size_t mb)
     EnforceMaximumSize();
 }
 
+// What an item is worth keeping for: the render time each reuse saves for the
+// space it takes. Cheap washes score low, shader/video/text renders high.
+static double SavedMSPerByte(uint64_t renderNs, uint64_t bytes)
+{
+    return (double)renderNs / 1000000.0 / (double)std::max(bytes, (uint64_t)1);
+}
+
 void RenderCache::EnforceMaximumSize()
 {
     // zero means no limit
@@ -109,56 +136,176 @@ void RenderCache::EnforceMaximumSize()
     if (!fs::exists(_baseCache, ec))
         return;
 
-    // Calculate total size of cache directory
+    uintmax_t const maximum = (uintmax_t)_maximumSizeMB * 1024 * 1024;
+    std::set<std::string> open;
+    // a pack the load thread has not opened yet is just a file
+    auto sequencePack = GetPack(GetPackGeneration());
+    if (sequencePack != nullptr && !sequencePack->IsOpen()) {
+        sequencePack.reset();
+    }
+    auto shared = GetSharedPack(GetSharedPackGeneration());
+    if (shared != nullptr && !shared->IsOpen()) {
+        shared.reset();
+    }
+    for (auto pack : { sequencePack, shared }) {
+        if (pack != nullptr) {
+            open.insert(fs::path(pack->GetFile()).lexically_normal().string());
+        }
+    }
+
+    // Calculate total size of cache directory, dropping any pre pack cache files
+    // as nothing can use them
     uintmax_t total = 0;
+    std::list<std::string> packs;
     for (const auto& entry : fs::recursive_directory_iterator(_baseCache, ec)) {
-        if (entry.is_regular_file()) {
-            total += entry.file_size();
+        if (!entry.is_regular_file()) continue;
+        if (entry.path().extension() == ".cache") {
+            fs::remove(entry.path(), ec);
+            continue;
+        }
+        total += entry.file_size();
+        if (entry.path().extension() == ".pack" && open.find(entry.path().lexically_normal().string()) == open.end()) {
+            packs.push_back(entry.path().string());
         }
     }
-    if (total / 1024 / 1024 < _maximumSizeMB)
+    if (total <= maximum)
         return;
 
-    // get the size and last written date of all render cache entries
-    struct CacheEntry {
-        uintmax_t size = 0;
-        std::string name;
-        fs::file_time_type modified;
+    // Rank every item and drop the ones that save the least render time for
+    // their size until the rest fit.
+    struct Candidate {
+        RenderCachePack* pack = nullptr;
+        uint64_t id = 0;
+        uint64_t bytes = 0;
+        double score = 0;
 
-        bool operator<(const CacheEntry& ce) const
+        bool operator<(const Candidate& c) const
         {
-            return modified < ce.modified;
+            return score < c.score;
+        }
+    };
+    std::list<RenderCachePack*> opened;
+    std::vector<Candidate> candidates;
+    auto addCandidates = [&candidates](RenderCachePack* pack, std::list<RenderCachePackItem*>& items) {
+        for (auto item : items) {
+            candidates.push_back({ pack, item->id, item->bytes, SavedMSPerByte(item->renderNs, item->bytes) });
+            delete item;
         }
     };
 
-    std::list<CacheEntry> entries;
+    // the items of the packs in use are ranked in place. What evicting them
+    // frees only comes back once the pack is closed and compacted so each
+    // counts as what is live in it.
+    std::unique_lock<std::mutex> loadLock(_loadMutex);
+    for (auto pack : { sequencePack, shared }) {
+        if (pack == nullptr) continue;
+        uint64_t liveBytes = 0;
+        std::list<RenderCachePackItem*> items;
+        if (pack->ReadItems(items, liveBytes)) {
+            total = total - std::min((uintmax_t)pack->GetFileSize(), total) + liveBytes;
+            addCandidates(pack.get(), items);
+        }
+    }
 
-    for (const auto& entry : fs::recursive_directory_iterator(_baseCache, ec)) {
-        if (entry.is_regular_file() && entry.path().extension() == ".cache") {
-            CacheEntry ce;
-            ce.name = entry.path().string();
-            ce.size = entry.file_size();
-            ce.modified = entry.last_write_time();
-
-            if (ce.size / 1024 / 1024 > _maximumSizeMB / 2) {
-                // we always delete anything larger than half the maximum as these are essentially making the cache useless
-                fs::remove(ce.name, ec);
-                total -= ce.size;
+    for (const auto& it : packs) {
+        uintmax_t const before = fs::file_size(it, ec);
+        auto pack = new RenderCachePack(it, false);
+        std::list<RenderCachePackItem*> items;
+        if (!pack->Open(items)) {
+            delete pack;
+            continue;
+        }
+        // opening can compact it
+        total = total - before + pack->GetFileSize();
+        addCandidates(pack, items);
+        opened.push_back(pack);
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    std::set<RenderCachePack*> changed;
+    std::set<uint64_t> evicted; // from the sequence's pack
+    for (const auto& it : candidates) {
+        if (total <= maximum) break;
+        it.pack->DeleteItem(it.id);
+        changed.insert(it.pack);
+        if (it.pack == sequencePack.get()) {
+            evicted.insert(it.id);
+        }
+        // frames shared with another item stay so this can overstate what is freed
+        total -= std::min((uintmax_t)it.bytes, total);
+        _evictions++;
+        _evictedBytes += it.bytes;
+    }
+
+    // effects may still be reading the evicted frames
+    if (sequencePack != nullptr && changed.find(sequencePack.get()) != changed.end()) {
+        _compactPack = true;
+    }
+    if (shared != nullptr && changed.find(shared.get()) != changed.end()) {
+        _compactSharedPack = true;
+    }
+    loadLock.unlock();
+    DropItems(evicted);
+
+    for (auto pack : opened) {
+        if (changed.find(pack) != changed.end()) {
+            if (pack->GetItemCount() == 0) {
+                std::string const file = pack->GetFile();
+                pack->Close();
+                fs::remove(file, ec);
             } else {
-                entries.push_back(ce);
+                pack->Compact();
             }
         }
+        delete pack;
     }
 
-    entries.sort();
+    if (total > maximum) {
+        spdlog::get("render")->warn("Render cache cannot be held to {}MB, {}MB is still used with nothing left to evict.",
+            _maximumSizeMB, total / 1024 / 1024);
+    }
+    spdlog::get("render")->debug("Render cache size enforced: {} items evicted in total, {}MB of {}MB now used.",
+        _evictions.load(), total / 1024 / 1024, _maximumSizeMB);
+}
+
+void RenderCache::DropItems(const std::set<uint64_t>& ids)
+{
+    if (ids.empty()) return;
 
-    while (total / 1024 / 1024 > _maximumSizeMB && entries.size() > 0) {
-        if (fs::exists(entries.front().name, ec)) {
-            fs::remove(entries.front().name, ec);
-            total -= entries.front().size;
+    // only items no effect has claimed are in the lists, a claimed one keeps
+    // its frames until the pack is closed and is not saved again unless re-rendered
+    std::list<RenderCacheItem*> dropped;
+    {
+        std::unique_lock<std::recursive_mutex> lock(_cacheLock);
+        for (auto& it : _cache) {
+            if (it.second == nullptr) continue;
+            std::unique_lock<std::shared_mutex> ulock(it.second->lock);
+            auto& l = it.second->cache;
+            for (auto i = l.begin(); i != l.end();) {
+                if (!(*i)->IsShared() && ids.find((*i)->GetId()) != ids.end()) {
+                    dropped.push_back(*i);
+                    i = l.erase(i);
+                } else {
+                    ++i;
+                }
+            }
         }
-        entries.pop_front();
     }
+    for (auto it : dropped) {
+        spdlog::get("render")->info("RenderCache item evicted " + it->Description());
+        delete it;
+    }
+}
+
+RenderCacheStats RenderCache::GetStats() const
+{
+    RenderCacheStats stats;
+    stats.hits = _hits;
+    stats.misses = _misses;
+    stats.evictions = _evictions;
+    stats.evictedBytes = _evictedBytes;
+    stats.sharedItems = _sharedItems;
+    return stats;
 }
 
 void RenderCache::LoadCache()
@@ -229,6 +376,32 @@ void RenderCache::SetSequence(const std::string& path, const std::string& sequen
             spdlog::get("render")->debug("Opening render cache folder {}.", _cacheFolder);
         }
 
+        {
+            auto pack = std::make_shared<RenderCachePack>(_cacheFolder + GetPathSeparator() + RENDER_CACHE_PACK, UseMMap());
+            std::unique_lock<std::mutex> packLock(_packLock);
+            _pack = std::move(pack);
+        }
+
+        if (_shareAcrossSequences) {
+            std::string const sharedFolder = path + GetPathSeparator() + "RenderCache" + GetPathSeparator() + RENDER_CACHE_SHARED;
+            std::string const sharedFile = sharedFolder + GetPathSeparator() + RENDER_CACHE_PACK;
+            auto current = GetSharedPack(GetSharedPackGeneration());
+            if (current == nullptr || current->GetFile() != sharedFile) {
+                current.reset();
+                CloseSharedPack();
+                if (!fs::exists(sharedFolder, ec)) {
+                    spdlog::get("render")->debug("Creating render cache folder {}.", sharedFolder);
+                    fs::create_directory(sharedFolder, ec);
+                }
+                // opened by the load thread
+                auto pack = std::make_shared<RenderCachePack>(sharedFile, UseMMap());
+                std::unique_lock<std::mutex> packLock(_packLock);
+                _sharedPack = std::move(pack);
+            }
+        } else {
+            CloseSharedPack();
+        }
+
         LoadCache();
     }
 }
@@ -280,6 +453,96 @@ bool RenderCache::IsEffectOkForCaching(const SettingsMap& settings) const
     return true;
 }
 
+// Settings that do not change what an effect draws
+static bool IsIgnoredForSharing(const std::string& key)
+{
+    return key == "X_Effect_Locked" || key == "X_Effect_Description" || key == "X_Effect_RenderDisabled";
+}
+
+// A render can only be shared if it depends on nothing but the effect's settings,
+// its buffer and its model. Timing tracks, lyrics, MIDI and the audio are
+// different in every sequence, and a per model render draws buffers the key
+// does not describe.
+static bool IsEffectOkForSharing(Effect* effect)
+{
+    for (const auto& it : effect->GetSettings()) {
+        if (it.second.empty()) continue;
+        if (Contains(it.first, "Track")) return false;
+        if ((Contains(it.first, "Music") || Contains(it.first, "Audio")) && it.second != "0") return false;
+        if (Contains(it.second, "Type=Music") || Contains(it.second, "Type=Timing Track")) return false;
+        if (it.first == "B_CHOICE_BufferStyle" && StartsWith(it.second, "Per Model")) return false;
+    }
+    return true;
+}
+
+// 128 bit FNV-1a, two lanes with different offsets. The stored item's settings
+// are compared on a hit so a collision costs a render, not a wrong frame.
+class SharedKeyHash
+{
+    uint64_t _h1 = 0xCBF29CE484222325ULL;
+    uint64_t _h2 = 0x84222325CBF29CE4ULL;
+
+public:
+    void Add(const void* data, size_t size)
+    {
+        auto p = (const uint8_t*)data;
+        for (size_t i = 0; i < size; ++i) {
+            _h1 = (_h1 ^ p[i]) * 0x100000001B3ULL;
+            _h2 = (_h2 ^ p[i]) * 0x100000001B3ULL;
+            _h2 ^= _h2 >> 29;
+        }
+    }
+    void Add(const std::string& s)
+    {
+        Add(s.c_str(), s.size() + 1);
+    }
+    template<typename T>
+    void Add(T v)
+    {
+        static_assert(std::is_arithmetic_v<T>);
+        Add(&v, sizeof(v));
+    }
+    std::string Key() const
+    {
+        return fmt::format("Shared_{:016x}{:016x}", _h1, _h2);
+    }
+};
+
+// Effect name, settings, palette, buffer size, frame timing, random seed and
+// the model's node layout: everything two renders must agree on to be the same.
+// Empty if the effect's render cannot be shared.
+static std::string GetSharedKey(Effect* effect, RenderBuffer* buffer)
+{
+    if (buffer == nullptr || !IsEffectOkForSharing(effect)) return "";
+
+    SharedKeyHash h;
+    h.Add(effect->GetEffectName());
+    for (const auto& it : effect->GetSettings()) {
+        if (IsIgnoredForSharing(it.first)) continue;
+        h.Add(it.first);
+        h.Add((const std::string&)it.second);
+    }
+    for (const auto& it : effect->GetPaletteMap()) {
+        h.Add(it.first);
+        h.Add((const std::string&)it.second);
+    }
+    h.Add(buffer->BufferWi);
+    h.Add(buffer->BufferHt);
+    h.Add(buffer->frameTimeInMs);
+    h.Add(buffer->curEffEndPer - buffer->curEffStartPer);
+    // covers the model name, layer and start frame the random streams are seeded from
+    h.Add(buffer->GetRandomBaseSeed());
+    h.Add(buffer->GetNodeCount());
+    for (const auto& node : buffer->GetNodes()) {
+        h.Add(node->Coords.size());
+        for (uint32_t c = 0; c < node->Coords.size(); ++c) {
+            h.Add(node->Coords[c].bufX);
+            h.Add(node->Coords[c].bufY);
+        }
+    }
+    return h.Key();
+}
+
 RenderCache::PerEffectCache* RenderCache::GetPerEffectCache(const std::string &s) {
     std::unique_lock<std::recursive_mutex> lock(_cacheLock);
     PerEffectCache *r = _cache[s];
@@ -313,6 +576,11 @@ RenderCacheItem* RenderCache::GetItem(Effect* effect, const SettingsMap& setting
             
             //grab the write lock
             std::unique_lock<std::shared_mutex> ulock(cache->lock);
+            // the item can be evicted while no lock is held
+            it = std::find(l.begin(), l.end(), item);
+            if (it == l.end()) {
+                break;
+            }
             l.erase(it);
             spdlog::get("render")->info("RenderCache GetItem found an existing render cache item for effect {} on model {} on layer {} at start time {}ms.",
                 effect->GetEffectName(),
@@ -326,7 +594,33 @@ RenderCacheItem* RenderCache::GetItem(Effect* effect, const SettingsMap& setting
             return item;
         }
     }
-    lock.unlock();
+    if (lock.owns_lock()) {
+        lock.unlock();
+    }
+
+    auto shared = GetSharedPack(GetSharedPackGeneration());
+    std::string const sharedKey = shared == nullptr ? "" : GetSharedKey(effect, buffer);
+    if (!sharedKey.empty()) {
+        auto item = new RenderCacheItem(this, effect, buffer, sharedKey);
+        RenderCachePackItem stored;
+        if (shared->ReadItem(sharedKey, stored) && item->IsSameRender(stored)) {
+            delete item;
+            _sharedItems++;
+            spdlog::get("render")->info("RenderCache GetItem found a shared render cache item for effect {} on model {} on layer {} at start time {}ms.",
+                effect->GetEffectName(),
+                buffer->GetModelName(),
+                effect->GetParentEffectLayer()->GetLayerNumber(),
+                effect->GetStartTimeMS());
+            return new RenderCacheItem(this, stored, true);
+        }
+
+        spdlog::get("render")->info("RenderCache GetItem created a new shared render cache item for effect {} on model {} on layer {} at start time {}ms.",
+            effect->GetEffectName(),
+            buffer->GetModelName(),
+            effect->GetParentEffectLayer()->GetLayerNumber(),
+            effect->GetStartTimeMS());
+        return item;
+    }
 
     spdlog::get("render")->info("RenderCache GetItem created a new render cache item for effect {} on model {} on layer {} at start time {}ms.",
         effect->GetEffectName(),
@@ -341,7 +635,7 @@ void RenderCache::Close()
 {
     if (_cacheFolder == "") return;
 
-    spdlog::get("render")->debug("Closing render cache folder {}.", _cacheFolder);
+    spdlog::get("render")->debug("Closing render cache folder {}. Hits {}, misses {}, evictions {}.", _cacheFolder, _hits.load(), _misses.load(), _evictions.load());
 
     // wait for the cache load thread to finish
     if (_loadThread.joinable()) {
@@ -353,6 +647,21 @@ void RenderCache::Close()
     Purge(nullptr, false);
     _cacheFolder = "";
 
+    std::shared_ptr<RenderCachePack> pack;
+    {
+        // the pack itself goes once the last render thread using it lets go
+        std::unique_lock<std::mutex> packLock(_packLock);
+        pack = std::move(_pack);
+        _packGeneration++;
+    }
+    // items evicted while it was open are only dropped from the file once no
+    // render thread can be reading it
+    if (_compactPack && pack != nullptr && pack.use_count() == 1) {
+        pack->Compact();
+    }
+    _compactPack = false;
+    pack.reset();
+
     std::unique_lock<std::recursive_mutex> lock(_cacheLock);
     for (auto &a : _cache) {
         delete a.second;
@@ -362,6 +671,43 @@ void RenderCache::Close()
     spdlog::get("render")->debug("    Closed.");
 }
 
+void RenderCache::CloseSharedPack()
+{
+    // the load thread may still be opening it
+    if (_loadThread.joinable()) {
+        _loadThread.join();
+    }
+
+    std::shared_ptr<RenderCachePack> pack;
+    {
+        std::unique_lock<std::mutex> packLock(_packLock);
+        pack = std::move(_sharedPack);
+        _sharedGeneration++;
+    }
+    if (pack != nullptr) {
+        spdlog::get("render")->debug("Closing shared render cache {}.", pack->GetFile());
+        // items evicted while it was open are only dropped from the file once
+        // no render thread can be reading it
+        if (_compactSharedPack && pack.use_count() == 1) {
+            pack->Compact();
+        }
+    }
+    _compactSharedPack = false;
+}
+
+void RenderCache::PurgeShared()
+{
+    std::unique_lock<std::mutex> loadLock(_loadMutex);
+    auto shared = GetSharedPack(GetSharedPackGeneration());
+    if (shared != nullptr && shared->IsOpen()) {
+        spdlog::get("render")->debug("Purging shared render cache {}.", shared->GetFile());
+        shared->Clear();
+        // items effects still hold point at frames that are gone
+        std::unique_lock<std::mutex> packLock(_packLock);
+        _sharedGeneration++;
+    }
+}
+
 static bool doOnEffectsInternal(Element *em, std::function<bool(Effect*)>& func) {
     for (int l = 0; l < (int)em->GetEffectLayerCount(); l++) {
         EffectLayer* el = em->GetEffectLayer(l);
@@ -498,6 +844,13 @@ void RenderCache::Purge(SequenceElements* sequenceElements, bool dodelete)
             Element* em = sequenceElements->GetElement(i);
             purgeCache(em, dodelete);
         }
+
+        // every item is gone so the pack can start again rather than grow until compacted
+        auto pack = GetPack(GetPackGeneration());
+        if (dodelete && pack != nullptr) {
+            std::unique_lock<std::mutex> loadLock(_loadMutex);
+            pack->Clear();
+        }
     }
 }
 bool RenderCache::UseMMap() const {
@@ -517,26 +870,16 @@ RenderCacheItem::~RenderCacheItem()
     PurgeFrames();
 }
 
+std::shared_ptr<RenderCachePack> RenderCacheItem::GetPack() const
+{
+    // null once the pack this item's frames are in has been closed
+    return _shared ? _renderCache->GetSharedPack(_packGeneration) : _renderCache->GetPack(_packGeneration);
+}
+
 void RenderCacheItem::PurgeFrames()
 {
     _purged = true;
-    for (auto& it : _frames) {
-        for (int x = it.second.size() - 1; x >= 0; --x) {
-            if (it.second[x] != nullptr) {
-                if (!_mmap) {
-                    free(it.second[x]);
-                }
-                it.second[x] = nullptr;
-            }
-        }
-    }
-#ifdef USE_MMAP_RENDERCACHE
-    if (_mmap) {
-        munmap(_mmap, _mmapSize);
-        _mmap = nullptr;
-        _mmapSize = 0;
-    }
-#endif
+    _frames.clear();
 }
 
 std::string RenderCacheItem::GetModelName(RenderBuffer* buffer)
@@ -555,15 +898,35 @@ std::string RenderCacheItem::GetModelName(RenderBuffer* buffer)
     }
 }
 
-RenderCacheItem::RenderCacheItem(RenderCache* renderCache, Effect* effect, RenderBuffer* buffer) : _renderCache(renderCache)
+RenderCacheItem::RenderCacheItem(RenderCache* renderCache, Effect* effect, RenderBuffer* buffer, const std::string& sharedKey) : _renderCache(renderCache)
 {
-    _mmap = nullptr;
-    _mmapSize = 0;
+    _shared = !sharedKey.empty();
+    _packGeneration = _shared ? renderCache->GetSharedPackGeneration() : renderCache->GetPackGeneration();
     _purged = false;
     _dirty = true;
     std::string mname = GetModelName(buffer);
     assert(mname != "");
     _frameSize[mname] = sizeof(xlColor) * buffer->GetPixelCount();
+
+    if (_shared) {
+        // nothing about where the effect sits in the sequence, that is what lets it be shared
+        _key = sharedKey;
+        _effectName = effect->GetEffectName();
+        _properties["Effect"] = effect->GetEffectName();
+        _properties["Frames"] = std::to_string(buffer->curEffEndPer - buffer->curEffStartPer + 1);
+        _properties["FrameMS"] = std::to_string(buffer->frameTimeInMs);
+        _properties["Models"] = "-1";
+        for (const auto& it : effect->GetSettings()) {
+            if (!IsIgnoredForSharing(it.first)) {
+                _properties[it.first] = it.second;
+            }
+        }
+        for (const auto& it : effect->GetPaletteMap()) {
+            _properties[it.first] = it.second;
+        }
+        return;
+    }
+
     std::string elname = effect->GetParentEffectLayer()->GetParentElement()->GetFullName();
     Replace(elname, "/", "_");
     Replace(elname, "\\", "_");
@@ -571,12 +934,11 @@ RenderCacheItem::RenderCacheItem(RenderCache* renderCache, Effect* effect, Rende
     Replace(elname, "?", "_");
     Replace(elname, "*", "_");
     Replace(elname, "$", "_");
-    std::string file = fmt::format("{}_{}_{}_{}.cache",
+    _key = fmt::format("{}_{}_{}_{}",
             effect->GetEffectName(), elname,
             effect->GetParentEffectLayer()->GetLayerNumber(),
             effect->GetStartTimeMS());
     _effectName = effect->GetEffectName();
-    _cacheFile = renderCache->GetCacheFolder() + GetPathSeparator() + file;
     _properties["Effect"] = effect->GetEffectName();
     _properties["Element"] = effect->GetParentEffectLayer()->GetParentElement()->GetFullName();
     _properties["EffectLayer"] = std::to_string(effect->GetParentEffectLayer()->GetLayerNumber());
@@ -594,6 +956,37 @@ RenderCacheItem::RenderCacheItem(RenderCache* renderCache, Effect* effect, Rende
     }
 }
 
+RenderCacheItem::RenderCacheItem(RenderCache* renderCache, const RenderCachePackItem& stored, bool shared) : _renderCache(renderCache)
+{
+    _shared = shared;
+    _packGeneration = _shared ? renderCache->GetSharedPackGeneration() : renderCache->GetPackGeneration();
+    _id = stored.id;
+    _renderNs = stored.renderNs;
+    _key = stored.key;
+    _properties = stored.properties;
+    _frameSize = stored.frameSize;
+    _frames = stored.frames;
+    _purged = false;
+    _dirty = false;
+
+    auto it = _properties.find("Effect");
+    if (it != _properties.end()) {
+        _effectName = it->second;
+    } else {
+        _effectName = _key.substr(0, _key.find('_'));
+    }
+
+    // these are needed by IsMatch, shared items are found by key instead
+    if (_shared) return;
+    for (const auto& p : { "Effect", "Element", "EffectLayer", "StartMS", "EndMS", "Frames", "Models" }) {
+        if (_properties.find(p) == _properties.end()) {
+            spdlog::get("render")->debug("Render cache item {} is missing {}.", _key, p);
+            _purged = true;
+            break;
+        }
+    }
+}
+
 bool RenderCacheItem::IsMatch(Effect* effect, RenderBuffer* buffer)
 {
     if (_purged) return false;
@@ -671,29 +1064,44 @@ bool RenderCacheItem::IsMatch(Effect* effect, RenderBuffer* buffer)
     return true;
 }
 
+bool RenderCacheItem::IsSameRender(const RenderCachePackItem& stored) const
+{
+    if (stored.frameSize != _frameSize) return false;
+
+    // Models is only filled in when the item is saved
+    if (stored.properties.size() != _properties.size()) return false;
+    for (const auto& it : _properties) {
+        if (it.first == "Models") continue;
+        auto p = stored.properties.find(it.first);
+        if (p == stored.properties.end() || p->second != it.second) {
+            spdlog::get("render")->debug("RenderCache shared item {} differs in {}.", _key, it.first);
+            return false;
+        }
+    }
+    return true;
+}
+
 void RenderCacheItem::Delete()
 {
-    
-    if (!_purged && FileExists(_cacheFile)) {
-        std::error_code ec;
-        if (!fs::remove(_cacheFile, ec)) {
-            spdlog::get("render")->warn("Unable to remove cache file " + _cacheFile);
-        } else {
-            spdlog::get("render")->info("RenderCache removed file " + _cacheFile);
+    // other sequences may be using a shared render so it stays until evicted
+    if (!_purged && _id != 0 && !_shared) {
+        auto pack = GetPack();
+        if (pack != nullptr) {
+            pack->DeleteItem(_id);
+            spdlog::get("render")->info("RenderCache removed " + _key);
         }
     }
     PurgeFrames();
     _renderCache->RemoveItem(this);
 }
 
-void RenderCacheItem::AddFrame(RenderBuffer* buffer)
+void RenderCacheItem::AddFrame(RenderBuffer* buffer, uint64_t renderNs)
 {
-    
     if (buffer == nullptr) {
         spdlog::get("render")->error("RenderCacheItem::AddFrame was passed a null buffer");
         return;
     }
-    
+
     if (buffer->GetPixelCount() == 0) {
         spdlog::get("render")->error("RenderCacheItem::AddFrame was passed a buffer with no pixels in it");
         return;
@@ -702,14 +1110,9 @@ void RenderCacheItem::AddFrame(RenderBuffer* buffer)
     if (_purged) {
         return;
     }
-    if (_mmap) {
-        // need to undo the mmap so we can append frames
-        unmmap();
-    }
-    // allow up to 3 times physical memory
-    // This means the render cache will be swapped out ... but I think that is still better than re-rendering
-    if (IsExcessiveMemoryUsage(3.0)) {
-        spdlog::get("render")->error("RenderCacheItem::AddFrame failed memory available test. This is a bad sign. Rendering will be really slow.");
+
+    auto pack = GetPack();
+    if (pack == nullptr) {
         PurgeFrames();
         return;
     }
@@ -737,31 +1140,21 @@ void RenderCacheItem::AddFrame(RenderBuffer* buffer)
         return;
     }
 
-    if (_frames.find(mname) == _frames.end()) {
-        std::vector<unsigned char *> n;
-        _frames[mname] = n;
-    }
-
-    if ((size_t)frame >= _frames.at(mname).size()) {
+    auto& modelFrames = _frames[mname];
+    if ((size_t)frame >= modelFrames.size()) {
         int maxframe = std::max(frame+1,buffer->curEffEndPer - buffer->curEffStartPer + 1);
-        _frames.at(mname).resize(maxframe);
+        modelFrames.resize(maxframe, 0);
     }
 
-    unsigned char* frameBuffer = (unsigned char *)malloc(_frameSize.at(mname));
-    if (frameBuffer == nullptr) {
-        spdlog::get("render")->warn("RenderCacheItem::AddFrame failed to allocate frameBuffer.");
+    // identical frames are only stored once so this is often just a hash
+    uint64_t offset = pack->AddFrame((const uint8_t*)buffer->GetPixels(), _frameSize.at(mname));
+    if (offset == 0) {
+        spdlog::get("render")->warn("RenderCacheItem::AddFrame failed to store the frame.");
         PurgeFrames();
-        assert(false);
         return;
     }
-    memcpy(frameBuffer, buffer->GetPixels(), _frameSize.at(mname));
-
-    if (_frames.at(mname)[frame] != nullptr) {
-        free(_frames.at(mname)[frame]);
-        _frames.at(mname)[frame] = nullptr;
-    }
-
-    _frames.at(mname)[frame] = frameBuffer;
+    modelFrames[frame] = offset;
+    _renderNs += renderNs;
     _dirty = true;
 
     // Frames can arrive out of order (frame-parallel windows render a chunk
@@ -772,10 +1165,9 @@ void RenderCacheItem::AddFrame(RenderBuffer* buffer)
         _sawEndFrame = true;
     }
     if (_sawEndFrame) {
-        // if multi models in this cache then only call save when none of them have null pointers at the end
+        // if multi models in this cache then only call save when none of them are missing the last frame
         for (const auto& itm : _frames) {
-            if (itm.second.size() == 0 || itm.second.back() == nullptr) {
-                //spdlog::get("render")->warn("RenderCacheItem::AddFrame save abandoned due to null frame.");
+            if (itm.second.size() == 0 || itm.second.back() == 0) {
                 return;
             }
         }
@@ -804,88 +1196,53 @@ bool RenderCacheItem::GetFrame(RenderBuffer* buffer)
     }
 
     int frame = buffer->curPeriod - buffer->curEffStartPer;
-    if (frame >= 0 && (size_t)frame < modelFrames.size() && modelFrames[frame]) {
-        // its in memory ... read it from there
-        unsigned char* pc = modelFrames[frame];
-        if (buffer->GetPixels() != nullptr) {
-            memcpy(static_cast<void*>(buffer->GetPixels()), pc, _frameSize.at(mname));
-            return true;
-        }
+    bool hit = false;
+    if (frame >= 0 && (size_t)frame < modelFrames.size() && modelFrames[frame] != 0 && buffer->GetPixels() != nullptr) {
+        auto pack = GetPack();
+        hit = pack != nullptr && pack->ReadFrame(modelFrames[frame], (uint8_t*)buffer->GetPixels(), _frameSize.at(mname));
     }
-    return false;
+    _renderCache->RecordLookup(hit);
+    return hit;
 }
 
 void RenderCacheItem::Touch() const
 {
-    std::error_code ec;
-    fs::last_write_time(_cacheFile, fs::file_time_type::clock::now(), ec);
+    auto pack = GetPack();
+    if (pack != nullptr) {
+        pack->Touch();
+    }
 }
 
 void RenderCacheItem::Save()
 {
     if (_purged) return;
     if (!_dirty) return;
-    
-    if (_mmap) {
-        return;
-    }
-
-    
-    //spdlog::get("render")->debug("Saving render cache file {}.", (const char *)_cacheFile.c_str());
-
-    char zero = 0x00;
 
     // check all the data is there
     for (const auto& itm : _frames) {
         for (const auto& it : itm.second) {
             // we are missing data
-            //assert(false);
-            if (it == nullptr) return;
+            if (it == 0) return;
         }
     }
 
-    FILE* fp = std::fopen(_cacheFile.c_str(), "wb");
-
-    if (fp != nullptr) {
-        _properties["Models"] = std::to_string((int)_frames.size());
-        // write the header fields
-        for (const auto& it : _properties) {
-            std::fwrite(it.first.c_str(), 1, it.first.size(), fp);
-            std::fwrite(&zero, 1, 1, fp);
-            std::fwrite(it.second.c_str(), 1, it.second.size(), fp);
-            std::fwrite(&zero, 1, 1, fp);
-        }
-
-        std::fwrite("RC_HEADEREND", 1, 12, fp);
-        std::fwrite(&zero, 1, 1, fp);
-
-        for (const auto& it : _frames) {
-            std::fwrite(it.first.c_str(), 1, it.first.size(), fp);
-            std::fwrite(&zero, 1, 1, fp);
-            std::string numFrames = std::to_string((int)it.second.size());
-            std::fwrite(numFrames.c_str(), 1, numFrames.size(), fp);
-            std::fwrite(&zero, 1, 1, fp);
-            std::string fsize = std::to_string(_frameSize.at(it.first));
-            std::fwrite(fsize.c_str(), 1, fsize.size(), fp);
-            std::fwrite(&zero, 1, 1, fp);
-        }
-        _firstFrameOffset = std::ftell(fp);
-
-        // write the frames
-        for (const auto& itm : _frames) {
-            for (const auto& it : itm.second) {
-                assert(it != nullptr);
-                if (it != nullptr) {
-                    std::fwrite(it, 1, _frameSize.at(itm.first), fp);
-                }
-            }
-        }
-
-        std::fclose(fp);
-
-        remmap();
+    auto pack = GetPack();
+    if (pack == nullptr) return;
+
+    _properties["Models"] = std::to_string((int)_frames.size());
+
+    RenderCachePackItem item;
+    item.id = _id;
+    item.key = _key;
+    item.renderNs = _renderNs;
+    item.properties = _properties;
+    item.frameSize = _frameSize;
+    item.frames = _frames;
+    if (pack->WriteItem(item)) {
+        _id = item.id;
+        _dirty = false;
     } else {
-        spdlog::get("render")->warn("    Failed to create file.");
+        spdlog::get("render")->warn("    Failed to save render cache item {}.", _key);
     }
 }
 
@@ -898,186 +1255,7 @@ bool RenderCacheItem::IsDone(RenderBuffer* buffer) const
     if (it == _frames.end()) return false;
     auto const& modelFrames = it->second;
     if (frame < 0 || (size_t)frame >= modelFrames.size()) return false;
-    return modelFrames[frame] != nullptr;
-}
-
-RenderCacheItem::RenderCacheItem(RenderCache* renderCache, const std::string& filename) : _renderCache(renderCache)
-{
-    
-
-    _mmap = nullptr;
-    _mmapSize = 0;
-    _cacheFile = filename;
-    fs::path fnPath(_cacheFile);
-    _effectName = fnPath.stem().string();
-    int idx = _effectName.find('_');
-    _effectName = _effectName.substr(0, idx);
-    _purged = false;
-    _dirty = false;
-
-    FILE* fp = std::fopen(_cacheFile.c_str(), "rb");
-
-    if (fp != nullptr) {
-        char headerBuffer[8192];
-        memset(headerBuffer, 0x00, sizeof(headerBuffer));
-        std::fread(headerBuffer, 1, sizeof(headerBuffer), fp);
-
-        char* ps = headerBuffer;
-
-        while (strcmp(ps, "RC_HEADEREND") != 0) {
-            std::string key(ps);
-            ps += strlen(ps) + 1;
-            std::string value(ps);
-            ps += strlen(ps) + 1;
-
-            if (key == "") {
-                // file looks corrupt
-                spdlog::get("render")->debug("Cache file {} appears corrupt.", (const char*)filename.c_str());
-                _purged = true;
-                std::fclose(fp);
-                return;
-            } else {
-                _properties[key] = value;
-            }
-        }
-        ps += strlen(ps) + 1;
-
-        int models = std::atoi(_properties["Models"].c_str());
-
-        for (int i = 0; i < models; i++) {
-            std::string model(ps);
-            ps += strlen(ps) + 1;
-            std::string frames(ps);
-            ps += strlen(ps) + 1;
-            int frameCount = std::atoi(frames.c_str());
-            std::string frameSize(ps);
-            ps += strlen(ps) + 1;
-            long fsz = std::strtol(frameSize.c_str(), nullptr, 10);
-
-            std::vector<unsigned char *> n;
-            _frames[model] = n;
-            _frames.at(model).resize(frameCount);
-            _frameSize[model] = fsz;
-        }
-
-        _firstFrameOffset = ps - headerBuffer;
-#ifdef USE_MMAP_RENDERCACHE
-        if (renderCache->UseMMap()) {
-            struct stat st;
-            fstat(fileno(fp), &st);
-            _mmapSize = st.st_size;
-            _mmap = (uint8_t*)mmap(nullptr, _mmapSize, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
-
-            if (_mmap == MAP_FAILED) {
-                _mmap = nullptr;
-                _mmapSize = 0;
-            } else {
-                // validate that the file is large enough for all frame data
-                size_t expectedSize = _firstFrameOffset;
-                for (auto& itm : _frames) {
-                    expectedSize += itm.second.size() * _frameSize.at(itm.first);
-                }
-                if (_mmapSize < expectedSize) {
-                    spdlog::get("render")->warn("Cache file {} is truncated (expected {} bytes, got {}). Skipping mmap.",
-                        filename, expectedSize, _mmapSize);
-                    munmap(_mmap, _mmapSize);
-                    _mmap = nullptr;
-                    _mmapSize = 0;
-                    // fall through to fread path
-                } else {
-                    size_t cur = _firstFrameOffset;
-                    for (auto& itm : _frames) {
-                        for (int i = 0; i < (int)itm.second.size(); i++) {
-                            itm.second[i] = &_mmap[cur];
-                            cur += _frameSize.at(itm.first);
-                        }
-                    }
-                    std::fclose(fp);
-                    return;
-                }
-            }
-        }
-#endif
-        std::fseek(fp, _firstFrameOffset, SEEK_SET);
-        for (auto& itm : _frames) {
-            for (int i = 0; i < (int)itm.second.size(); i++) {
-                uint8_t* frameBuffer = (uint8_t *)malloc(_frameSize.at(itm.first));
-
-                if (frameBuffer == nullptr) {
-                    std::fclose(fp);
-                    PurgeFrames();
-                    spdlog::get("render")->debug("Render Cache Item file {} fails due to memory allocation issue.", filename);
-                    return;
-                }
-
-                std::fread(frameBuffer, 1, _frameSize.at(itm.first), fp);
-                itm.second[i] = frameBuffer;
-            }
-        }
-        std::fclose(fp);
-    }
+    return modelFrames[frame] != 0;
 }
 
-void RenderCacheItem::unmmap() {
-#ifdef USE_MMAP_RENDERCACHE
-    if (_mmap) {
-        for (auto& it : _frames) {
-            for (int x = it.second.size() - 1; x >= 0; --x) {
-                if (it.second[x]) {
-                    uint8_t* frameBuffer = (uint8_t *)malloc(_frameSize.at(it.first));
-                    memcpy(frameBuffer, it.second[x], _frameSize.at(it.first));
-                    it.second[x] = frameBuffer;
-                }
-            }
-        }
-        munmap(_mmap, _mmapSize);
-        _mmap = nullptr;
-        _mmapSize = 0;
-    }
-#endif
-}
-void RenderCacheItem::remmap() {
-#ifdef USE_MMAP_RENDERCACHE
-    if (_mmap) return;
-    if (!_renderCache->UseMMap()) return;
-
-    FILE* fp = std::fopen(_cacheFile.c_str(), "rb");
-    if (fp != nullptr) {
-        struct stat st;
-        fstat(fileno(fp), &st);
-        _mmapSize = st.st_size;
-        _mmap = (uint8_t*)mmap(nullptr, _mmapSize, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
-        std::fclose(fp);
-        if (_mmap == MAP_FAILED) {
-            _mmap = nullptr;
-            _mmapSize = 0;
-            return;
-        }
-        // validate file is large enough for all frame data
-        size_t expectedSize = _firstFrameOffset;
-        for (auto& itm : _frames) {
-            expectedSize += itm.second.size() * _frameSize.at(itm.first);
-        }
-        if (_mmapSize < expectedSize) {
-            munmap(_mmap, _mmapSize);
-            _mmap = nullptr;
-            _mmapSize = 0;
-            return;
-        }
-        size_t cur = _firstFrameOffset;
-        for (auto& itm : _frames) {
-            for (int i = 0; i < (int)itm.second.size(); i++) {
-                if (itm.second[i]) {
-                    free(itm.second[i]);
-                    itm.second[i] = nullptr;
-                }
-                itm.second[i] = &_mmap[cur];
-                cur += _frameSize.at(itm.first);
-            }
-        }
-    }
-#endif
-}
-
-
 #pragma endregion RenderCacheItem
@@ -10,9 +10,13 @@
  * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <list>
 #include <map>
+#include <set>
+#include <memory>
 #include <vector>
 #include <mutex>
 #include <shared_mutex>
@@ -21,6 +25,8 @@
 
 class Effect;
 class RenderCache;
+class RenderCachePack;
+struct RenderCachePackItem;
 class SequenceElements;
 class RenderBuffer;
 class SettingsMap;
@@ -29,41 +35,53 @@ class SettingsMap;
 // hot-path eligibility check compares an enum instead of doing string compares.
 enum class RenderCacheMode { Disabled, LockedOnly, Enabled };
 
+struct RenderCacheStats {
+    uint64_t hits = 0;         // frames served from the cache
+    uint64_t misses = 0;       // frames of cacheable effects that had to be rendered
+    uint64_t evictions = 0;    // items dropped to stay under the maximum size
+    uint64_t evictedBytes = 0;
+    uint64_t sharedItems = 0;  // effects whose render was found in the show wide tier
+};
+
+// A cached render of one effect. Frames live compressed in the sequence's
+// RenderCachePack, the item only holds where each frame is in it. Shared items
+// live in the show wide pack instead and are keyed by a hash of everything the
+// render depends on rather than by where the effect is in the sequence.
 class RenderCacheItem
 {
     RenderCache* _renderCache = nullptr;
-    std::string _cacheFile;
+    bool _shared = false;
+    uint32_t _packGeneration = 0;
+    uint64_t _id = 0; // pack id once saved
+    uint64_t _renderNs = 0; // render time of the frames, what each reuse saves
+    std::string _key;
     std::string _effectName;
     std::map<std::string, std::string> _properties;
-    std::map<std::string, std::vector<uint8_t *>> _frames;
+    std::map<std::string, std::vector<uint64_t>> _frames; // pack offsets, 0 until the frame is added
     std::map<std::string, long> _frameSize;
     bool _purged = false;
     bool _dirty = false;
     bool _sawEndFrame = false;
     static std::string GetModelName(RenderBuffer* buffer);
-
-    
-    uint8_t *_mmap = nullptr;
-    size_t _mmapSize = 0;
-    size_t _firstFrameOffset = 0;
-
-    void unmmap();
-    void remmap();
+    std::shared_ptr<RenderCachePack> GetPack() const;
 
 public:
-    RenderCacheItem(RenderCache* renderCache, const std::string& file);
-    RenderCacheItem(RenderCache* renderCache, Effect* effect, RenderBuffer* buffer);
+    RenderCacheItem(RenderCache* renderCache, const RenderCachePackItem& stored, bool shared = false);
+    RenderCacheItem(RenderCache* renderCache, Effect* effect, RenderBuffer* buffer, const std::string& sharedKey = "");
     virtual ~RenderCacheItem();
     bool GetFrame(RenderBuffer* buffer);
-    void AddFrame(RenderBuffer* buffer);
+    void AddFrame(RenderBuffer* buffer, uint64_t renderNs);
     void PurgeFrames();
     bool IsPurged() const { return _purged; }
     bool IsMatch(Effect* effect, RenderBuffer* buffer);
+    bool IsSameRender(const RenderCachePackItem& stored) const;
+    bool IsShared() const { return _shared; }
+    uint64_t GetId() const { return _id; }
     void Delete();
     void Save();
     void Touch() const;
     bool IsDone(RenderBuffer* buffer) const;
-    const std::string& Description() const { return _cacheFile; }
+    const std::string& Description() const { return _key; }
     const std::string& EffectName() const { return _effectName; }
 };
 
@@ -85,17 +103,37 @@ class RenderCache
     std::thread _loadThread;
     size_t _maximumSizeMB = 0;
     std::string _baseCache = "";
+    // The packs are swapped under _packLock and handed out as shared pointers so
+    // a render thread reading or adding a frame keeps the pack alive while the
+    // UI thread closes it.
+    mutable std::mutex _packLock;
+    std::shared_ptr<RenderCachePack> _pack;
+    uint32_t _packGeneration = 0; // bumped each time a pack is closed so stale items can tell
+    bool _compactPack = false; // items were evicted while it was open
+    bool _shareAcrossSequences = false;
+    std::shared_ptr<RenderCachePack> _sharedPack; // stays open from sequence to sequence
+    uint32_t _sharedGeneration = 0;
+    bool _compactSharedPack = false; // items were evicted while it was open
+    std::atomic<uint64_t> _hits = 0;
+    std::atomic<uint64_t> _misses = 0;
+    std::atomic<uint64_t> _evictions = 0;
+    std::atomic<uint64_t> _evictedBytes = 0;
+    std::atomic<uint64_t> _sharedItems = 0;
 
     void Close();
+    void CloseSharedPack();
     void LoadCache();
     
     PerEffectCache* GetPerEffectCache(const std::string &s);
     void EnforceMaximumSize();
+    // Deletes the unclaimed items of the sequence's pack with these ids
+    void DropItems(const std::set<uint64_t>& ids);
 
     public:
 		RenderCache();
 		virtual ~RenderCache();
         inline bool IsEnabled() const { return _mode != RenderCacheMode::Disabled; }
+        inline bool IsLockedOnly() const { return _mode == RenderCacheMode::LockedOnly; }
         void SetRenderCacheFolder(const std::string& path);
         void SetSequence(const std::string& path, const std::string& sequenceFile);
 		RenderCacheItem* GetItem(Effect* effect, const SettingsMap& settings, RenderBuffer* buffer);
@@ -123,4 +161,29 @@ class RenderCache
         bool IsEffectOkForCaching(const SettingsMap& settings) const;
         bool UseMMap() const;
         void SetMaximumSizeMB(size_t mb);
+        // Keeps renders that do not depend on anything sequence specific in a
+        // second, show wide pack so the same effect on the same model hits in
+        // every sequence. Takes effect from the next SetSequence.
+        void SetShareAcrossSequences(bool share) { _shareAcrossSequences = share; }
+        bool IsSharedAcrossSequences() const { return _shareAcrossSequences; }
+        // Drops every render in the show wide pack
+        void PurgeShared();
+        std::shared_ptr<RenderCachePack> GetPack(uint32_t generation) const {
+            std::unique_lock<std::mutex> lock(_packLock);
+            return generation == _packGeneration ? _pack : nullptr;
+        }
+        uint32_t GetPackGeneration() const {
+            std::unique_lock<std::mutex> lock(_packLock);
+            return _packGeneration;
+        }
+        std::shared_ptr<RenderCachePack> GetSharedPack(uint32_t generation) const {
+            std::unique_lock<std::mutex> lock(_packLock);
+            return generation == _sharedGeneration ? _sharedPack : nullptr;
+        }
+        uint32_t GetSharedPackGeneration() const {
+            std::unique_lock<std::mutex> lock(_packLock);
+            return _sharedGeneration;
+        }
+        void RecordLookup(bool hit) { (hit ? _hits : _misses)++; }
+        RenderCacheStats GetStats() const;
 };
@@ -0,0 +1,746 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "RenderCachePack.h"
+#include "utils/FastHash.h"
+
+#include <cstring>
+#include <filesystem>
+#include <set>
+#include <unordered_map>
+
+#include <zstd.h>
+
+#include <log.h>
+
+#ifdef _WIN32
+#define ftello _ftelli64
+#define fseeko _fseeki64
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// file:   "XLRCPACK" uint32 version uint32 0, then records
+// record: uint32 type uint32 payload length, payload
+//   FRAME   uint64 hash1 uint64 hash2 uint32 size uint32 0, zstd compressed frame
+//   ITEM    uint64 id uint64 renderNs uint64 bytes, serialised RenderCachePackItem
+//   DELETE  uint64 id
+#define RCPACK_MAGIC "XLRCPACK"
+#define RCPACK_VERSION 2
+#define RCPACK_HEADERSIZE 16
+#define RCPACK_RECORDHEADERSIZE 8
+#define RCPACK_FRAMEHEADERSIZE 24
+
+#define RCPACK_FRAME 1
+#define RCPACK_ITEM 2
+#define RCPACK_DELETE 3
+
+// frames change little from one to the next so the fastest level gets most of the gain
+#define RCPACK_COMPRESSIONLEVEL 1
+
+namespace
+{
+    struct FrameHeader {
+        uint64_t hash1;
+        uint64_t hash2;
+        uint32_t size;
+        uint32_t unused;
+    };
+    static_assert(sizeof(FrameHeader) == RCPACK_FRAMEHEADERSIZE);
+
+    // compression context per render thread so AddFrame does not allocate one per frame
+    struct CompressContext {
+        ZSTD_CCtx* cctx = ZSTD_createCCtx();
+        std::vector<uint8_t> buffer;
+        ~CompressContext() { ZSTD_freeCCtx(cctx); }
+    };
+
+    void WriteU32(std::vector<uint8_t>& out, uint32_t v) {
+        out.insert(out.end(), (uint8_t*)&v, (uint8_t*)&v + sizeof(v));
+    }
+
+    void WriteU64(std::vector<uint8_t>& out, uint64_t v) {
+        out.insert(out.end(), (uint8_t*)&v, (uint8_t*)&v + sizeof(v));
+    }
+
+    void WriteString(std::vector<uint8_t>& out, const std::string& s) {
+        WriteU32(out, (uint32_t)s.size());
+        out.insert(out.end(), s.begin(), s.end());
+    }
+
+    class Reader {
+    public:
+        Reader(const uint8_t* data, size_t size) : _data(data), _size(size) {}
+
+        bool U32(uint32_t& v) { return Read(&v, sizeof(v)); }
+        bool U64(uint64_t& v) { return Read(&v, sizeof(v)); }
+        bool String(std::string& s) {
+            uint32_t len = 0;
+            if (!U32(len) || _pos + len > _size) return false;
+            s.assign((const char*)_data + _pos, len);
+            _pos += len;
+            return true;
+        }
+
+    private:
+        bool Read(void* v, size_t len) {
+            if (_pos + len > _size) return false;
+            memcpy(v, _data + _pos, len);
+            _pos += len;
+            return true;
+        }
+
+        const uint8_t* _data;
+        size_t _size;
+        size_t _pos = 0;
+    };
+
+    void SerialiseItem(const RenderCachePackItem& item, std::vector<uint8_t>& out) {
+        out.clear();
+        WriteU64(out, item.id);
+        WriteU64(out, item.renderNs);
+        WriteU64(out, item.bytes);
+        WriteString(out, item.key);
+        WriteU32(out, (uint32_t)item.properties.size());
+        for (const auto& it : item.properties) {
+            WriteString(out, it.first);
+            WriteString(out, it.second);
+        }
+        WriteU32(out, (uint32_t)item.frames.size());
+        for (const auto& it : item.frames) {
+            WriteString(out, it.first);
+            auto size = item.frameSize.find(it.first);
+            WriteU32(out, size == item.frameSize.end() ? 0 : (uint32_t)size->second);
+            WriteU32(out, (uint32_t)it.second.size());
+            for (auto o : it.second) {
+                WriteU64(out, o);
+            }
+        }
+    }
+
+    RenderCachePackItem* ParseItem(const uint8_t* data, size_t size) {
+        Reader r(data, size);
+        auto item = new RenderCachePackItem();
+        uint32_t count = 0;
+        bool ok = r.U64(item->id) && r.U64(item->renderNs) && r.U64(item->bytes) && r.String(item->key) && r.U32(count);
+        for (uint32_t i = 0; ok && i < count; i++) {
+            std::string k;
+            std::string v;
+            ok = r.String(k) && r.String(v);
+            item->properties[k] = v;
+        }
+        ok = ok && r.U32(count);
+        for (uint32_t i = 0; ok && i < count; i++) {
+            std::string model;
+            uint32_t frameSize = 0;
+            uint32_t frames = 0;
+            ok = r.String(model) && r.U32(frameSize) && r.U32(frames) && (uint64_t)frames * 8 <= size;
+            if (ok) {
+                item->frameSize[model] = frameSize;
+                auto& f = item->frames[model];
+                f.resize(frames);
+                for (uint32_t j = 0; ok && j < frames; j++) {
+                    ok = r.U64(f[j]);
+                }
+            }
+        }
+        if (!ok) {
+            delete item;
+            return nullptr;
+        }
+        return item;
+    }
+}
+
+#pragma region Constructors and Destructors
+RenderCachePack::RenderCachePack(const std::string& file, bool useMMap) :
+    _file(file), _useMMap(useMMap) {
+}
+
+RenderCachePack::~RenderCachePack() {
+    Close();
+}
+#pragma endregion
+
+#pragma region Open and Close
+bool RenderCachePack::OpenFile(bool truncate) {
+
+    if (!truncate) {
+        _fp = std::fopen(_file.c_str(), "r+b");
+        if (_fp != nullptr) {
+            char header[RCPACK_HEADERSIZE];
+            uint32_t version = 0;
+            if (std::fread(header, 1, sizeof(header), _fp) == sizeof(header) && memcmp(header, RCPACK_MAGIC, 8) == 0) {
+                memcpy(&version, header + 8, sizeof(version));
+            }
+            if (version == RCPACK_VERSION) {
+                fseeko(_fp, 0, SEEK_END);
+                _size = ftello(_fp);
+                return true;
+            }
+            spdlog::get("render")->warn("Render cache pack {} is not a version {} pack, starting a new one.", _file, RCPACK_VERSION);
+            std::fclose(_fp);
+            _fp = nullptr;
+        }
+    }
+
+    _fp = std::fopen(_file.c_str(), "w+b");
+    if (_fp == nullptr) {
+        spdlog::get("render")->error("Unable to create render cache pack {}.", _file);
+        return false;
+    }
+    char header[RCPACK_HEADERSIZE];
+    memset(header, 0x00, sizeof(header));
+    memcpy(header, RCPACK_MAGIC, 8);
+    uint32_t const version = RCPACK_VERSION;
+    memcpy(header + 8, &version, sizeof(version));
+    std::fwrite(header, 1, sizeof(header), _fp);
+    std::fflush(_fp);
+    _size = RCPACK_HEADERSIZE;
+    return true;
+}
+
+bool RenderCachePack::Open(std::list<RenderCachePackItem*>& items) {
+
+    std::unique_lock<std::mutex> lock(_lock);
+    if (_fp != nullptr) return false;
+    if (!OpenFile(false)) return false;
+
+    std::map<uint64_t, RenderCachePackItem*> live;
+    uint64_t liveBytes = 0;
+    Scan(live, liveBytes);
+
+    // compact once more than half the pack is frames and items nothing uses
+    // any more, as long as that is worth the rewrite
+    uint64_t const garbage = _size - liveBytes;
+    if (garbage > liveBytes && garbage > 4 * 1024 * 1024) {
+        spdlog::get("render")->info("Compacting render cache pack {}: {} of {} bytes in use.", _file, liveBytes, _size);
+        if (CompactFile(live)) {
+            for (auto& it : live) {
+                delete it.second;
+            }
+            live.clear();
+            if (!OpenFile(false)) return false;
+            Scan(live, liveBytes);
+        }
+    }
+
+    for (auto& it : live) {
+        items.push_back(it.second);
+    }
+    Map();
+
+    spdlog::get("render")->debug("Render cache pack {} opened with {} items, {} frames, {} bytes.", _file, items.size(), _frameIndex.size(), _size);
+    return true;
+}
+
+void RenderCachePack::Close() {
+
+    std::unique_lock<std::mutex> lock(_lock);
+    Unmap();
+    if (_fp != nullptr) {
+        std::fclose(_fp);
+        _fp = nullptr;
+    }
+    _frameIndex.clear();
+    _frameSizes.clear();
+    _keys.clear();
+    _ids.clear();
+    _itemOffsets.clear();
+    _size = 0;
+}
+
+bool RenderCachePack::Scan(std::map<uint64_t, RenderCachePackItem*>& live, uint64_t& liveBytes) {
+
+    _frameIndex.clear();
+    _frameSizes.clear();
+    _keys.clear();
+    _ids.clear();
+    _itemOffsets.clear();
+
+    auto& frames = _frameSizes;
+    std::map<uint64_t, uint32_t> itemSizes;
+    std::map<uint64_t, uint64_t> itemOffsets;
+    std::vector<uint8_t> payload;
+
+    uint64_t pos = RCPACK_HEADERSIZE;
+    fseeko(_fp, pos, SEEK_SET);
+    while (pos < _size) {
+        uint32_t header[2];
+        if (pos + RCPACK_RECORDHEADERSIZE > _size || std::fread(header, 1, sizeof(header), _fp) != sizeof(header)) break;
+        uint32_t const type = header[0];
+        uint32_t const length = header[1];
+        if (pos + RCPACK_RECORDHEADERSIZE + length > _size) break;
+
+        bool ok = true;
+        if (type == RCPACK_FRAME) {
+            FrameHeader fh;
+            ok = length >= sizeof(fh) && std::fread(&fh, 1, sizeof(fh), _fp) == sizeof(fh);
+            if (ok) {
+                _frameIndex[{ fh.hash1, fh.hash2, fh.size }] = pos;
+                frames[pos] = RCPACK_RECORDHEADERSIZE + length;
+                fseeko(_fp, pos + RCPACK_RECORDHEADERSIZE + length, SEEK_SET);
+            }
+        } else if (type == RCPACK_ITEM || type == RCPACK_DELETE) {
+            payload.resize(length);
+            ok = std::fread(payload.data(), 1, length, _fp) == length;
+            if (ok && type == RCPACK_DELETE) {
+                uint64_t id = 0;
+                ok = length >= sizeof(id);
+                if (ok) {
+                    memcpy(&id, payload.data(), sizeof(id));
+                    auto it = live.find(id);
+                    if (it != live.end()) {
+                        _keys.erase(it->second->key);
+                        delete it->second;
+                        live.erase(it);
+                    }
+                }
+            } else if (ok) {
+                auto item = ParseItem(payload.data(), payload.size());
+                // every frame must be one already in the pack
+                if (item != nullptr) {
+                    for (auto const& m : item->frames) {
+                        for (auto o : m.second) {
+                            ok = ok && frames.find(o) != frames.end();
+                        }
+                    }
+                    if (!ok) {
+                        delete item;
+                        item = nullptr;
+                        ok = true;
+                    }
+                }
+                if (item != nullptr) {
+                    auto old = _keys.find(item->key);
+                    if (old != _keys.end()) {
+                        delete live[old->second];
+                        live.erase(old->second);
+                    }
+                    _keys[item->key] = item->id;
+                    live[item->id] = item;
+                    itemSizes[item->id] = RCPACK_RECORDHEADERSIZE + length;
+                    itemOffsets[item->id] = pos;
+                    _nextId = std::max(_nextId, item->id + 1);
+                } else {
+                    spdlog::get("render")->warn("Render cache pack {} item at {} is corrupt, ignored.", _file, pos);
+                }
+            }
+        } else {
+            ok = false;
+        }
+
+        if (!ok) break;
+        pos += RCPACK_RECORDHEADERSIZE + length;
+    }
+
+    if (pos < _size) {
+        // a record was cut short, most likely by a crash mid write, drop it and anything after
+        spdlog::get("render")->warn("Render cache pack {} is damaged at {} of {} bytes, truncating.", _file, pos, _size);
+        std::error_code ec;
+        std::fclose(_fp);
+        fs::resize_file(_file, pos, ec);
+        _fp = std::fopen(_file.c_str(), "r+b");
+        _size = pos;
+    }
+
+    std::set<uint64_t> used;
+    liveBytes = RCPACK_HEADERSIZE;
+    for (auto const& it : live) {
+        _ids[it.first] = it.second->key;
+        _itemOffsets[it.first] = itemOffsets[it.first];
+        liveBytes += itemSizes[it.first];
+        for (auto const& m : it.second->frames) {
+            for (auto o : m.second) {
+                if (used.insert(o).second) {
+                    liveBytes += frames[o];
+                }
+            }
+        }
+    }
+    return _fp != nullptr;
+}
+
+bool RenderCachePack::Compact() {
+
+    std::unique_lock<std::mutex> lock(_lock);
+    if (_fp == nullptr) return false;
+    Unmap();
+
+    std::map<uint64_t, RenderCachePackItem*> live;
+    uint64_t liveBytes = 0;
+    Scan(live, liveBytes);
+    bool const res = liveBytes < _size && CompactFile(live);
+    for (auto& it : live) {
+        delete it.second;
+    }
+    if (res) {
+        live.clear();
+        if (!OpenFile(false)) return false;
+        Scan(live, liveBytes);
+        for (auto& it : live) {
+            delete it.second;
+        }
+    }
+    Map();
+    return res;
+}
+
+bool RenderCachePack::CompactFile(const std::map<uint64_t, RenderCachePackItem*>& live) {
+
+    std::string const tmp = _file + ".tmp";
+    FILE* out = std::fopen(tmp.c_str(), "wb");
+    if (out == nullptr) {
+        spdlog::get("render")->warn("Unable to create {} to compact the render cache pack.", tmp);
+        return false;
+    }
+
+    char header[RCPACK_HEADERSIZE];
+    fseeko(_fp, 0, SEEK_SET);
+    bool ok = std::fread(header, 1, sizeof(header), _fp) == sizeof(header) && std::fwrite(header, 1, sizeof(header), out) == sizeof(header);
+    uint64_t outPos = RCPACK_HEADERSIZE;
+
+    std::unordered_map<uint64_t, uint64_t> moved; // old offset -> new offset
+    std::vector<uint8_t> record;
+    std::vector<uint8_t> payload;
+    for (auto const& it : live) {
+        if (!ok) break;
+        RenderCachePackItem item = *it.second;
+        for (auto& m : item.frames) {
+            for (auto& o : m.second) {
+                auto mv = moved.find(o);
+                if (mv != moved.end()) {
+                    o = mv->second;
+                    continue;
+                }
+                uint32_t rh[2];
+                fseeko(_fp, o, SEEK_SET);
+                ok = ok && std::fread(rh, 1, sizeof(rh), _fp) == sizeof(rh);
+                if (!ok) break;
+                record.resize(RCPACK_RECORDHEADERSIZE + rh[1]);
+                memcpy(record.data(), rh, sizeof(rh));
+                ok = std::fread(record.data() + sizeof(rh), 1, rh[1], _fp) == rh[1] &&
+                     std::fwrite(record.data(), 1, record.size(), out) == record.size();
+                moved[o] = outPos;
+                o = outPos;
+                outPos += record.size();
+            }
+        }
+        SerialiseItem(item, payload);
+        uint32_t rh[2] = { RCPACK_ITEM, (uint32_t)payload.size() };
+        ok = ok && std::fwrite(rh, 1, sizeof(rh), out) == sizeof(rh) &&
+             std::fwrite(payload.data(), 1, payload.size(), out) == payload.size();
+        outPos += sizeof(rh) + payload.size();
+    }
+    ok = std::fclose(out) == 0 && ok;
+
+    std::error_code ec;
+    if (!ok) {
+        spdlog::get("render")->warn("Compacting render cache pack {} failed.", _file);
+        fs::remove(tmp, ec);
+        return false;
+    }
+
+    std::fclose(_fp);
+    _fp = nullptr;
+    fs::rename(tmp, _file, ec);
+    if (ec) {
+        spdlog::get("render")->warn("Unable to replace render cache pack {}: {}.", _file, ec.message());
+        fs::remove(tmp, ec);
+    }
+    // the caller reopens whichever file is now in place
+    return true;
+}
+#pragma endregion
+
+#pragma region Frames
+uint64_t RenderCachePack::Append(uint32_t type, const void* header, size_t headerSize, const void* data, size_t dataSize) {
+
+    // caller holds _lock
+    if (_fp == nullptr) return 0;
+
+    uint32_t rh[2] = { type, (uint32_t)(headerSize + dataSize) };
+    uint64_t const pos = _size;
+    fseeko(_fp, pos, SEEK_SET);
+    bool ok = std::fwrite(rh, 1, sizeof(rh), _fp) == sizeof(rh);
+    if (ok && headerSize > 0) ok = std::fwrite(header, 1, headerSize, _fp) == headerSize;
+    if (ok && dataSize > 0) ok = std::fwrite(data, 1, dataSize, _fp) == dataSize;
+    if (!ok) {
+        // leave the partial record for the next scan to trim
+        spdlog::get("render")->warn("Failed writing to render cache pack {}.", _file);
+        fseeko(_fp, 0, SEEK_END);
+        _size = ftello(_fp);
+        return 0;
+    }
+    _size = pos + sizeof(rh) + headerSize + dataSize;
+    return pos;
+}
+
+uint64_t RenderCachePack::AddFrame(const uint8_t* data, size_t size) {
+
+    if (data == nullptr || size == 0 || size > UINT32_MAX) return 0;
+
+    FrameKey key;
+    key.size = (uint32_t)size;
+    FastHash::Hash128(data, size, key.hash1, key.hash2);
+    uint64_t existing = 0;
+
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        auto it = _frameIndex.find(key);
+        if (it != _frameIndex.end()) {
+            existing = it->second;
+        }
+    }
+    if (existing != 0 && SameFrame(existing, data, size, false)) {
+        _framesShared++;
+        return existing;
+    }
+
+    // compress outside the lock so render threads only serialise on the write
+    static thread_local CompressContext ctx;
+    ctx.buffer.resize(ZSTD_compressBound(size));
+    size_t const compressed = ZSTD_compressCCtx(ctx.cctx, ctx.buffer.data(), ctx.buffer.size(), data, size, RCPACK_COMPRESSIONLEVEL);
+    if (ZSTD_isError(compressed)) {
+        spdlog::get("render")->warn("Render cache frame compression failed: {}.", ZSTD_getErrorName(compressed));
+        return 0;
+    }
+
+    std::unique_lock<std::mutex> lock(_lock);
+    auto it = _frameIndex.find(key);
+    if (it != _frameIndex.end() && it->second != existing && SameFrame(it->second, data, size, true)) {
+        // another thread stored the same frame while we compressed
+        _framesShared++;
+        return it->second;
+    }
+    FrameHeader fh = { key.hash1, key.hash2, key.size, 0 };
+    uint64_t const pos = Append(RCPACK_FRAME, &fh, sizeof(fh), ctx.buffer.data(), compressed);
+    if (pos != 0) {
+        // on a hash collision the frame already indexed keeps its entry and
+        // this one is stored beside it unshared
+        if (it == _frameIndex.end()) {
+            _frameIndex[key] = pos;
+        }
+        _frameSizes[pos] = (uint32_t)(RCPACK_RECORDHEADERSIZE + sizeof(fh) + compressed);
+        _framesAdded++;
+    }
+    return pos;
+}
+
+bool RenderCachePack::ReadFrame(uint64_t offset, uint8_t* data, size_t size) {
+    return ReadFrame(offset, data, size, false);
+}
+
+bool RenderCachePack::ReadFrame(uint64_t offset, uint8_t* data, size_t size, bool locked) {
+
+    if (offset < RCPACK_HEADERSIZE || data == nullptr) return false;
+
+    uint32_t rh[2];
+    FrameHeader fh;
+
+    {
+        // decompress straight from the mapping while it cannot be unmapped under us
+        std::shared_lock<std::shared_mutex> mapLock(_mapLock);
+        if (_mmap != nullptr && offset + RCPACK_RECORDHEADERSIZE + RCPACK_FRAMEHEADERSIZE <= _mmapSize) {
+            memcpy(rh, _mmap + offset, sizeof(rh));
+            memcpy(&fh, _mmap + offset + sizeof(rh), sizeof(fh));
+            if (rh[0] != RCPACK_FRAME || rh[1] < sizeof(fh) || offset + sizeof(rh) + rh[1] > _mmapSize) return false;
+            if (fh.size != size) return false;
+            size_t const res = ZSTD_decompress(data, size, _mmap + offset + sizeof(rh) + sizeof(fh), rh[1] - sizeof(fh));
+            return !ZSTD_isError(res) && res == size;
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(_lock, std::defer_lock);
+    if (!locked) lock.lock();
+    if (_fp == nullptr || offset + RCPACK_RECORDHEADERSIZE + RCPACK_FRAMEHEADERSIZE > _size) return false;
+    fseeko(_fp, offset, SEEK_SET);
+    if (std::fread(rh, 1, sizeof(rh), _fp) != sizeof(rh) || rh[0] != RCPACK_FRAME || rh[1] < sizeof(fh)) return false;
+    if (std::fread(&fh, 1, sizeof(fh), _fp) != sizeof(fh)) return false;
+    if (fh.size != size) return false;
+    size_t const length = rh[1] - sizeof(fh);
+    static thread_local std::vector<uint8_t> buffer;
+    buffer.resize(length);
+    if (std::fread(buffer.data(), 1, length, _fp) != length) return false;
+    size_t const res = ZSTD_decompress(data, size, buffer.data(), length);
+    return !ZSTD_isError(res) && res == size;
+}
+
+bool RenderCachePack::SameFrame(uint64_t offset, const uint8_t* data, size_t size, bool locked) {
+    // a matching hash is not proof, the stored bytes have to match too
+    static thread_local std::vector<uint8_t> stored;
+    stored.resize(size);
+    return ReadFrame(offset, stored.data(), size, locked) && memcmp(stored.data(), data, size) == 0;
+}
+#pragma endregion
+
+#pragma region Items
+bool RenderCachePack::WriteItem(RenderCachePackItem& item) {
+
+    std::unique_lock<std::mutex> lock(_lock);
+    if (_fp == nullptr) return false;
+
+    std::set<uint64_t> used;
+    item.bytes = 0;
+    for (const auto& m : item.frames) {
+        for (auto o : m.second) {
+            if (used.insert(o).second) {
+                auto size = _frameSizes.find(o);
+                if (size != _frameSizes.end()) item.bytes += size->second;
+            }
+        }
+    }
+
+    uint64_t const old = item.id;
+    item.id = _nextId++;
+    std::vector<uint8_t> payload;
+    SerialiseItem(item, payload);
+    uint64_t const pos = Append(RCPACK_ITEM, nullptr, 0, payload.data(), payload.size());
+    if (pos == 0) {
+        item.id = old;
+        return false;
+    }
+    std::fflush(_fp);
+
+    auto k = _keys.find(item.key);
+    if (k != _keys.end()) {
+        _ids.erase(k->second);
+        _itemOffsets.erase(k->second);
+    }
+    _keys[item.key] = item.id;
+    _ids[item.id] = item.key;
+    _itemOffsets[item.id] = pos;
+    return true;
+}
+
+void RenderCachePack::DeleteItem(uint64_t id) {
+
+    std::unique_lock<std::mutex> lock(_lock);
+    auto it = _ids.find(id);
+    if (it == _ids.end()) return;
+
+    Append(RCPACK_DELETE, nullptr, 0, &id, sizeof(id));
+    std::fflush(_fp);
+    auto k = _keys.find(it->second);
+    if (k != _keys.end() && k->second == id) {
+        _keys.erase(k);
+    }
+    _ids.erase(it);
+    _itemOffsets.erase(id);
+}
+
+bool RenderCachePack::ReadItem(const std::string& key, RenderCachePackItem& item) {
+
+    std::unique_lock<std::mutex> lock(_lock);
+    if (_fp == nullptr) return false;
+
+    auto k = _keys.find(key);
+    if (k == _keys.end()) return false;
+    auto o = _itemOffsets.find(k->second);
+    if (o == _itemOffsets.end()) return false;
+
+    uint32_t rh[2];
+    fseeko(_fp, o->second, SEEK_SET);
+    if (std::fread(rh, 1, sizeof(rh), _fp) != sizeof(rh) || rh[0] != RCPACK_ITEM) return false;
+    std::vector<uint8_t> payload(rh[1]);
+    if (std::fread(payload.data(), 1, payload.size(), _fp) != payload.size()) return false;
+
+    auto stored = ParseItem(payload.data(), payload.size());
+    if (stored == nullptr) return false;
+    item = *stored;
+    delete stored;
+    return true;
+}
+
+bool RenderCachePack::ReadItems(std::list<RenderCachePackItem*>& items, uint64_t& liveBytes) {
+
+    std::unique_lock<std::mutex> lock(_lock);
+    if (_fp == nullptr) return false;
+
+    std::set<uint64_t> used;
+    std::vector<uint8_t> payload;
+    liveBytes = RCPACK_HEADERSIZE;
+    for (auto const& it : _itemOffsets) {
+        uint32_t rh[2];
+        fseeko(_fp, it.second, SEEK_SET);
+        if (std::fread(rh, 1, sizeof(rh), _fp) != sizeof(rh) || rh[0] != RCPACK_ITEM) continue;
+        payload.resize(rh[1]);
+        if (std::fread(payload.data(), 1, payload.size(), _fp) != payload.size()) continue;
+
+        auto item = ParseItem(payload.data(), payload.size());
+        if (item == nullptr) continue;
+        liveBytes += RCPACK_RECORDHEADERSIZE + rh[1];
+        for (auto const& m : item->frames) {
+            for (auto o : m.second) {
+                if (used.insert(o).second) {
+                    auto size = _frameSizes.find(o);
+                    if (size != _frameSizes.end()) liveBytes += size->second;
+                }
+            }
+        }
+        items.push_back(item);
+    }
+    return true;
+}
+
+size_t RenderCachePack::GetItemCount() {
+    std::unique_lock<std::mutex> lock(_lock);
+    return _ids.size();
+}
+
+void RenderCachePack::Clear() {
+
+    std::unique_lock<std::mutex> lock(_lock);
+    if (_fp == nullptr) return;
+    Unmap();
+    std::fclose(_fp);
+    _fp = nullptr;
+    _frameIndex.clear();
+    _frameSizes.clear();
+    _keys.clear();
+    _ids.clear();
+    _itemOffsets.clear();
+    OpenFile(true);
+}
+
+void RenderCachePack::Touch() const {
+    std::error_code ec;
+    fs::last_write_time(_file, fs::file_time_type::clock::now(), ec);
+}
+
+void RenderCachePack::Map() {
+#ifndef _WIN32
+    std::unique_lock<std::shared_mutex> mapLock(_mapLock);
+    if (!_useMMap || _fp == nullptr || _mmap != nullptr) return;
+    std::fflush(_fp);
+    struct stat st;
+    if (fstat(fileno(_fp), &st) != 0 || st.st_size <= RCPACK_HEADERSIZE) return;
+    void* m = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fileno(_fp), 0);
+    if (m == MAP_FAILED) return;
+    _mmap = (uint8_t*)m;
+    _mmapSize = st.st_size;
+#endif
+}
+
+void RenderCachePack::Unmap() {
+    std::unique_lock<std::shared_mutex> mapLock(_mapLock);
+#ifndef _WIN32
+    if (_mmap != nullptr) {
+        munmap(_mmap, _mmapSize);
+    }
+#endif
+    _mmap = nullptr;
+    _mmapSize = 0;
+}
+#pragma endregion
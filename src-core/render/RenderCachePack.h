@@ -0,0 +1,133 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A cache item as stored in the pack. Frames are the pack offsets of each
+// model's frames, 0 for a frame that has not been added yet.
+struct RenderCachePackItem {
+    uint64_t id = 0;
+    std::string key;
+    uint64_t renderNs = 0; // time it took to render the frames, what a hit saves
+    uint64_t bytes = 0;    // stored size of the distinct frames it uses, set by WriteItem
+    std::map<std::string, std::string> properties;
+    std::map<std::string, long> frameSize;
+    std::map<std::string, std::vector<uint64_t>> frames;
+};
+
+// Append only store for every render cache item of a sequence.
+//
+// Frames are zstd compressed and content addressed: a frame identical to one
+// already in the pack (static effects, Off/On holds, repeated loops) is not
+// written again and items simply share its offset. Items are written once all
+// their frames are present and are superseded by a later item with the same key
+// or by a delete record. Nothing is rewritten in place, so the pack is
+// compacted when it is opened if more than half of it is no longer referenced.
+//
+// Existing frames are read through a memory map where the platform render cache
+// uses one, frames appended since the pack was opened are read from the file.
+class RenderCachePack
+{
+public:
+    RenderCachePack(const std::string& file, bool useMMap);
+    ~RenderCachePack();
+
+    RenderCachePack(const RenderCachePack&) = delete;
+    RenderCachePack& operator=(const RenderCachePack&) = delete;
+
+    // Scans (and if worthwhile compacts) the pack. Returns the live items which
+    // the caller takes ownership of.
+    bool Open(std::list<RenderCachePackItem*>& items);
+    void Close();
+    bool IsOpen() const { return _fp != nullptr; }
+
+    // Returns the offset of the stored frame or 0 if it could not be written.
+    // Safe to call from several render threads at once.
+    uint64_t AddFrame(const uint8_t* data, size_t size);
+    // Decompresses the frame at offset into data which must be size bytes
+    bool ReadFrame(uint64_t offset, uint8_t* data, size_t size);
+
+    // Writes the item, superseding any earlier one with the same key, and sets its id and bytes
+    bool WriteItem(RenderCachePackItem& item);
+    void DeleteItem(uint64_t id);
+    // Reads the live item with this key, false if there is none
+    bool ReadItem(const std::string& key, RenderCachePackItem& item);
+    size_t GetItemCount();
+    // Reads every live item, which the caller takes ownership of, and the size
+    // compacting would leave the pack at. For ranking a pack that is in use.
+    bool ReadItems(std::list<RenderCachePackItem*>& items, uint64_t& liveBytes);
+    // Rewrites the pack with only what live items use. Only call with no items
+    // outside the pack referring to it as every offset changes.
+    bool Compact();
+    // Drops everything in the pack
+    void Clear();
+    // Marks the pack as recently used for size enforcement
+    void Touch() const;
+
+    const std::string& GetFile() const { return _file; }
+    uint64_t GetFileSize() const { return _size; }
+    uint64_t GetFramesAdded() const { return _framesAdded; }
+    uint64_t GetFramesShared() const { return _framesShared; }
+
+private:
+    struct FrameKey {
+        uint64_t hash1 = 0;
+        uint64_t hash2 = 0;
+        uint32_t size = 0;
+        bool operator==(const FrameKey& k) const { return hash1 == k.hash1 && hash2 == k.hash2 && size == k.size; }
+    };
+    struct FrameKeyHash {
+        size_t operator()(const FrameKey& k) const { return (size_t)k.hash1; }
+    };
+
+    bool OpenFile(bool truncate);
+    bool Scan(std::map<uint64_t, RenderCachePackItem*>& live, uint64_t& liveBytes);
+    bool CompactFile(const std::map<uint64_t, RenderCachePackItem*>& live);
+    uint64_t Append(uint32_t type, const void* header, size_t headerSize, const void* data, size_t dataSize);
+    // locked is true when the caller already holds _lock
+    bool ReadFrame(uint64_t offset, uint8_t* data, size_t size, bool locked);
+    bool SameFrame(uint64_t offset, const uint8_t* data, size_t size, bool locked);
+    void Map();
+    void Unmap();
+
+    std::string _file;
+    bool _useMMap = false;
+    FILE* _fp = nullptr;
+    uint64_t _size = 0;
+    uint64_t _nextId = 1;
+
+    // guards the file, the frame index and the key map
+    std::mutex _lock;
+    std::unordered_map<FrameKey, uint64_t, FrameKeyHash> _frameIndex;
+    std::unordered_map<uint64_t, uint32_t> _frameSizes; // frame offset -> record size
+    std::map<std::string, uint64_t> _keys; // key -> live item id
+    std::map<uint64_t, std::string> _ids;  // live item id -> key
+    std::map<uint64_t, uint64_t> _itemOffsets; // live item id -> offset of its record
+
+    // held shared while reading through _mmap and exclusively to map or unmap.
+    // Map and Unmap are only called with _lock held so it is always taken second.
+    std::shared_mutex _mapLock;
+    uint8_t* _mmap = nullptr;
+    size_t _mmapSize = 0;
+
+    std::atomic<uint64_t> _framesAdded = 0;
+    std::atomic<uint64_t> _framesShared = 0; // adds satisfied by a frame already in the pack
+};
@@ -48,6 +48,7 @@
 #include "Parallel.h"
 #include "utils/RangeWorkPool.h"
 #include "utils/ExternalHooks.h"
+#include "utils/PerfTrace.h"
 #include "GPURenderUtils.h"
 #include "RenderProfile.h"
 #include "RenderCache.h"
@@ -79,7 +80,10 @@ static bool xldbgEffSumMatch(const std::string& model) {
 // XL_RENDER_PROFILE=1 diagnostic: accumulate per-row / per-effect render timing
 // and dump aggregate tables to stderr when the batch completes.  Checked before
 // any clock call so it costs nothing when unset (see RenderProfile.h).
-static const bool profRender = (getenv("XL_RENDER_PROFILE") != nullptr);
+// A profile sink turns the accumulation on without the dump.
+static const bool profRenderDump = (getenv("XL_RENDER_PROFILE") != nullptr);
+static bool profRender = profRenderDump;
+static RenderEngine::RenderProfileSink profRenderSink;
 
 // XL_RENDER_MEM=1 diagnostic: report what the render is spending memory on -
 // per-row buffer bytes at setup, clone-slot growth, and the process footprint
@@ -1213,6 +1217,42 @@ public:
         return frame - (ef->GetStartTimeMS() / frameTime);
     }
 
+    // The topmost layer that hides everything under it this frame, or
+    // numLayers if there is none.  Layers are rendered bottom up, so this looks
+    // ahead using the settings loaded for each layer's current effect: a layer
+    // whose effect starts this frame has not loaded its settings yet, so it is
+    // never the occluder, and if one sits under the occluder nothing is
+    // skipped as it could turn out to be a canvas reading the skipped layers.
+    // XL_NO_OCCLUSION_SKIP=1 turns the skipping off for A/B comparisons.
+    int FindOccludingLayer(int frame, Element *el, EffectLayerInfo &info, PixelBufferClass *buffer, int numLayers) {
+        static const bool noOcclusionSkip = (getenv("XL_NO_OCCLUSION_SKIP") != nullptr);
+        if (noOcclusionSkip || !info.processLayer.empty() || numLayers < 2) {
+            return numLayers;
+        }
+        int occluder = numLayers;
+        for (int layer = 0; layer < numLayers; ++layer) {
+            EffectLayer* elayer = el->GetEffectLayer(layer);
+            if (elayer == nullptr) {
+                return numLayers;
+            }
+            std::unique_lock<std::recursive_mutex> elayerLock(elayer->GetLock());
+            Effect* ef = findEffectForFrame(elayer, frame, info.currentEffectIdxs[layer]);
+            bool settled = ef == info.currentEffects[layer] &&
+                           (ef == nullptr || ef->GetEffectIndex() != EffectManager::eff_DUPLICATE);
+            if (occluder < numLayers) {
+                if (!settled || (ef != nullptr && buffer->IsCanvasMix(layer))) {
+                    return numLayers;
+                }
+            } else if (settled && ef != nullptr && buffer->IsLayerOpaque(layer)) {
+                RenderableEffect* reff = _ctx->GetEffectManager().GetEffect(ef->GetEffectIndex());
+                if (reff != nullptr && reff->IsOpaque(info.settingsMaps[layer])) {
+                    occluder = layer;
+                }
+            }
+        }
+        return occluder;
+    }
+
     // Ground truth for touching seqData[frame], re-checked at output time:
     // the frame-entry gate's answer can go stale because effect edits land
     // without any lock this slice holds (effect add takes only the layer
@@ -1227,7 +1267,7 @@ public:
             gateMissWarned = true;
             spdlog::warn("Render gate miss on {} frame {}: output produced on a frame the entry gate cleared as empty (concurrent effect edit, or a gate coverage bug). Output skipped; frame marked for re-render.", name, frame);
         }
-        rowToRender->SetDirtyRange(frame * seqData->FrameTime(), (frame + 1) * seqData->FrameTime());
+        SetRowDirtyRange(frame * seqData->FrameTime(), (frame + 1) * seqData->FrameTime());
         return false;
     }
 
@@ -1257,6 +1297,8 @@ public:
             partOfCanvas[x] = false;
         }
 
+        const int occluder = inheritedDuplicateSourceModel.empty() ? FindOccludingLayer(frame, el, info, buffer, numLayers) : numLayers;
+
         // To support canvas mix type we must render them bottom to top
         for (int layer = effectiveNumLayers - 1; layer >= 0; --layer) {
             // Layer restriction (tier-2 capture pre-pass): skip layers not opted in.
@@ -1372,6 +1414,19 @@ public:
                 suppress = buffer->GetSuppressUntil(layer) > GetEffectFrame(ef, frame, mainBuffer->GetFrameTimeInMS());
             }
 
+            if (layer > occluder && !freeze && ef != nullptr) {
+                // Hidden under an opaque layer: an effect whose frames do not
+                // depend on the frames before them can simply not be rendered.
+                RenderableEffect* reff = _ctx->GetEffectManager().GetEffect(ef->GetEffectIndex());
+                if (reff != nullptr && reff->GetEffectiveFrameParallelism(info.settingsMaps[layer]) == RenderableEffect::FrameParallelism::Pure) {
+                    info.validLayers[layer] = false;
+                    if (profRender) {
+                        ++profile.occludedLayerFrames;
+                    }
+                    continue;
+                }
+            }
+
             SetRenderingStatus(frame, &info.settingsMaps[layer], layer, info.submodel, strand, -1, true);
             bool b = info.effectStates[layer];
 
@@ -1619,11 +1674,12 @@ public:
                 // of a group includes gap channels owned by rows this one is
                 // not ordered against, which made span hashes racy artifacts
                 uint64_t h = 1469598103934665603ULL;
+                auto fd = seqData->Read(frame);
                 for (const auto& n : buffer->BufferForLayer(0, -1).GetNodes()) {
                     uint32_t start = n->ActChan;
                     uint32_t cnt = n->GetChanCount();
                     if (start + cnt <= seqData->NumChannels()) {
-                        const uint8_t* d = &((*seqData)[frame][start]);
+                        const uint8_t* d = fd[start];
                         for (uint32_t i = 0; i < cnt; i++) {
                             h ^= d[i];
                             h *= 1099511628211ULL;
@@ -2971,7 +3027,7 @@ public:
             const std::string inh = InheritedDuplicateSourceModel(frame);
             for (const auto& a : subModelInfos) {
                 if (abort) {
-                    rowToRender->SetDirtyRange(frame * seqData->FrameTime(), endFrame * seqData->FrameTime());
+                    SetRowDirtyRange(frame * seqData->FrameTime(), endFrame * seqData->FrameTime());
                     break;
                 }
                 ProduceFrame(frame, a->element, *a, a->buffer.get(), a->strand, supportsModelBlending ? true : cleared, inh);
@@ -2980,7 +3036,7 @@ public:
         if (!nodeBuffers.empty()) {
             for (const auto& it : nodeBuffers) {
                 if (abort) {
-                    rowToRender->SetDirtyRange(frame * seqData->FrameTime(), endFrame * seqData->FrameTime());
+                    SetRowDirtyRange(frame * seqData->FrameTime(), endFrame * seqData->FrameTime());
                     break;
                 }
                 ProduceNode(frame, it.first, it.second.get(), cleared);
@@ -2995,14 +3051,14 @@ public:
         OutputFrame(frame, rowToRender, mainModelInfo, mainBuffer, -1);
         for (const auto& a : subModelInfos) {
             if (abort) {
-                rowToRender->SetDirtyRange(frame * seqData->FrameTime(), endFrame * seqData->FrameTime());
+                SetRowDirtyRange(frame * seqData->FrameTime(), endFrame * seqData->FrameTime());
                 break;
             }
             OutputFrame(frame, a->element, *a, a->buffer.get(), a->strand);
         }
         for (const auto& it : nodeBuffers) {
             if (abort) {
-                rowToRender->SetDirtyRange(frame * seqData->FrameTime(), endFrame * seqData->FrameTime());
+                SetRowDirtyRange(frame * seqData->FrameTime(), endFrame * seqData->FrameTime());
                 break;
             }
             OutputNode(frame, it.first, it.second.get());
@@ -3020,7 +3076,7 @@ public:
             const std::string inh = InheritedDuplicateSourceModel(frame);
             for (const auto& a : subModelInfos) {
                 if (abort) {
-                    rowToRender->SetDirtyRange(frame * seqData->FrameTime(), endFrame * seqData->FrameTime());
+                    SetRowDirtyRange(frame * seqData->FrameTime(), endFrame * seqData->FrameTime());
                     break;
                 }
                 ProduceFrame(frame, a->element, *a, a->buffer.get(), a->strand, supportsModelBlending ? true : cleared, inh);
@@ -3030,7 +3086,7 @@ public:
         if (!nodeBuffers.empty()) {
             for (const auto& it : nodeBuffers) {
                 if (abort) {
-                    rowToRender->SetDirtyRange(frame * seqData->FrameTime(), endFrame * seqData->FrameTime());
+                    SetRowDirtyRange(frame * seqData->FrameTime(), endFrame * seqData->FrameTime());
                     break;
                 }
                 ProduceNode(frame, it.first, it.second.get(), cleared);
@@ -3070,7 +3126,7 @@ public:
                 origChangeCount != rowToRender->getChangeCount() ||
                 (!HasNext() && rowToRender->HasParkedRenderJobs())) {
             //we're bailing out but make sure this range is reconsidered
-            rowToRender->SetDirtyRange(frame * seqData->FrameTime(), endFrame * seqData->FrameTime());
+            SetRowDirtyRange(frame * seqData->FrameTime(), endFrame * seqData->FrameTime());
             return FrameResult::Stop;
         }
 
@@ -3182,6 +3238,9 @@ public:
             rowToRender->DetachRenderJob();
             attachedToRow = false;
         }
+        // With compressed sequence data the frames this row wrote sit in
+        // resident blocks, compress the ones the render has moved on from.
+        seqData->CompressIdleBlocks();
         schedPhase = SchedPhase::Done;
         engine->NotifyJobFinished(rpi);
     }
@@ -3189,6 +3248,10 @@ public:
     // One scheduling slice: runs from wherever the job left off until it
     // completes or suspends.  The pool may call this many times per job.
     virtual void Process() override {
+        if (PerfTrace::IsEnabled() && traceName == nullptr) {
+            traceName = PerfTrace::Intern(name);
+        }
+        PerfTrace::Span span("render", traceName, "frame", (int)currentFrame, "endFrame", (int)endFrame);
         try {
             ProcessSlice();
         } catch (...) {
@@ -3254,7 +3317,7 @@ public:
                 // row's parked queue by AbortRender).  Mark the range for
                 // re-render and go straight to the END handshake so downstream
                 // renderers converge; never take row ownership.
-                rowToRender->SetDirtyRange(startFrame * seqData->FrameTime(), endFrame * seqData->FrameTime());
+                SetRowDirtyRange(startFrame * seqData->FrameTime(), endFrame * seqData->FrameTime());
                 currentFrame = END_OF_RENDER_FRAME;
                 schedPhase = SchedPhase::Finish;
                 FinishRender();
@@ -3289,8 +3352,11 @@ public:
             }
             BeginSliceProfile();
             if (rowToRender->HasParkedRenderJobs() && !HasNext()) {
-                // newer jobs for this model are parked, bail fast and let them handle this
+                // newer jobs for this model are parked, bail fast and let them handle this.
+                // The newer job may be for another dirty window of the row, so hand it
+                // this one through the dirty range its ComputeRenderRange picks up.
                 m_logger->debug("Rendering thread exiting early.");
+                SetRowDirtyRange(startFrame * seqData->FrameTime(), endFrame * seqData->FrameTime());
                 currentFrame = END_OF_RENDER_FRAME; // this is needed otherwise the job does not look done
                 CompleteJob();
                 return;
@@ -3331,7 +3397,7 @@ public:
                     }
                     if (abort || origChangeCount != rowToRender->getChangeCount() ||
                             (!HasNext() && rowToRender->HasParkedRenderJobs())) {
-                        rowToRender->SetDirtyRange(a * seqData->FrameTime(), endFrame * seqData->FrameTime());
+                        SetRowDirtyRange(a * seqData->FrameTime(), endFrame * seqData->FrameTime());
                         stopped = true;
                     } else {
                         // streams FrameDone + currentFrame per frame; returns the
@@ -3340,6 +3406,15 @@ public:
                     }
                 }
                 while (!stopped && resumeFrame <= endFrame) {
+                    if (IsBackground() && !abort && _engine->HasForegroundJobsQueued()) {
+                        // Cache warming only uses spare capacity: give the thread
+                        // to the queued user render and resume at resumeFrame once
+                        // the pool has nothing better to do.  Last touch of
+                        // members before the requeue, like trySuspendUntil.
+                        EndSliceProfile();
+                        Requeue();
+                        return;
+                    }
                     // Frame-parallel fast path: render a contiguous run of frames
                     // whose every layer is Pure or Snapshottable in parallel clones.
                     // Snapshottable layers get a serial capture pre-pass first (see
@@ -3421,6 +3496,11 @@ public:
         // Suspended and parked jobs hold no thread; wake them so they can run
         // their bail path (dirty range, END handshake, completion) promptly.
         NudgeIfSuspended();
+        if (IsBackground()) {
+            // A queued background job would otherwise wait behind every
+            // foreground job - possibly one parked on the row it owns.
+            _engine->PromoteJob(this);
+        }
     }
 
     ModelElement* GetModelElement() const { return rowToRender; }
@@ -3429,6 +3509,15 @@ public:
 
 private:
 
+    // A background (cache warming) job renders over data that was loaded with
+    // the sequence, so a range it gives up on is still valid and must not
+    // trigger a re-render.
+    void SetRowDirtyRange(int startMS, int endMS) {
+        if (!IsBackground()) {
+            rowToRender->SetDirtyRange(startMS, endMS);
+        }
+    }
+
     void initialize(int layer, int frame, Effect *el, SettingsMap &settingsMap, PixelBufferClass *buffer) {
         bool layerEnabled = true;
         if (el == nullptr || el->GetEffectIndex() == -1) {
@@ -3530,6 +3619,7 @@ private:
 
     ModelElement *rowToRender;
     std::string name;
+    const char* traceName = nullptr; // name as PerfTrace holds it
     PixelBufferClass *mainBuffer;
     int numLayers;
     std::atomic_int startFrame;
@@ -3686,6 +3776,40 @@ static bool HasEffects(ModelElement *me) {
     return false;
 }
 
+// true if any effect on the row, its submodels or its strands is locked
+static bool HasLockedEffects(ModelElement *me) {
+    auto layerHasLocked = [](EffectLayer* layer) {
+        for (const auto& e : layer->GetEffects()) {
+            if (e->IsLocked()) {
+                return true;
+            }
+        }
+        return false;
+    };
+    for (size_t x = 0; x < me->GetEffectLayerCount(); ++x) {
+        if (layerHasLocked(me->GetEffectLayer(x))) {
+            return true;
+        }
+    }
+    for (int x = 0; x < me->GetSubModelAndStrandCount(); ++x) {
+        Element *sm = me->GetSubModel(x);
+        for (size_t l = 0; l < sm->GetEffectLayerCount(); ++l) {
+            if (layerHasLocked(sm->GetEffectLayer(l))) {
+                return true;
+            }
+        }
+    }
+    for (int x = 0; x < me->GetStrandCount(); ++x) {
+        StrandElement *se = me->GetStrand(x);
+        for (int n = 0; n < se->GetNodeLayerCount(); ++n) {
+            if (layerHasLocked(se->GetNodeLayer(n))) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 // OnProgressBarDoubleClick, OnRenderStatusTimerTrigger, UpdateRenderStatus,
 // RenderDone - all moved to RenderUI.cpp (wx UI handlers / progress-bar updates).
 
@@ -3845,7 +3969,24 @@ void RenderEngine::Render(SequenceElements& seqElements,
                           std::unique_ptr<IRenderProgressSink> sink, bool clear,
                           std::function<void(bool)>&& callback)
 {
+    // Cache warming jobs on these rows would hold row ownership (and so
+    // this render) until the pool runs dry.
+    AbortBackgroundRenders(models);
     _abortedRenderJobs = 0;
+    RenderBatch(seqElements, seqData, models, restrictToModels, startFrame, endFrame, std::move(sink), clear, std::move(callback),
+                RenderPriority::Default, nullptr);
+}
+
+void RenderEngine::RenderBatch(SequenceElements& seqElements,
+                               SequenceData& seqData,
+                               const std::list<Model*>& models,
+                               const std::list<Model *> &restrictToModels,
+                               int startFrame, int endFrame,
+                               std::unique_ptr<IRenderProgressSink> sink, bool clear,
+                               std::function<void(bool)>&& callback,
+                               RenderPriority priority,
+                               const std::list<Model*>* queueFirst)
+{
 
 #ifdef __APPLE__
     // Precompute the largest size each video file is used at so the decoder can
@@ -3915,7 +4056,9 @@ void RenderEngine::Render(SequenceElements& seqElements,
                     // No progress sink == per-edit micro-batch (RenderEffectForModel);
                     // jump the JobPool queue ahead of a queued Render All so the
                     // grid/preview don't wait for its backlog to drain.
-                    if (sink == nullptr) {
+                    if (priority == RenderPriority::Background) {
+                        job->SetBackground(true);
+                    } else if (priority == RenderPriority::High || (priority == RenderPriority::Default && sink == nullptr)) {
                         job->SetHighPriority(true);
                     }
                     if (seqElements.SupportsModelBlending()) {
@@ -4026,6 +4169,7 @@ void RenderEngine::Render(SequenceElements& seqElements,
     pi->aggregators = aggregators;
     pi->jobsRemaining.store((int)count);
     pi->totalJobs = (int)count;
+    pi->background = priority == RenderPriority::Background;
 
     // Link every live job to rpi so completion can signal.
     for (row = 0; row < (size_t)numRows; ++row) {
@@ -4035,9 +4179,41 @@ void RenderEngine::Render(SequenceElements& seqElements,
     _renderProgressInfo.push_back(pi);
     if (_onRenderStatusTimerStart) _onRenderStatusTimerStart();
 
+    // Rows are queued in model order, except that queueFirst's rows (the
+    // rows on screen, for cache warming) go first in that order.  Only the
+    // queue order changes; the dependency edges above still follow the
+    // models list.
+    std::vector<size_t> pushOrder;
+    pushOrder.reserve(numRows);
+    if (queueFirst != nullptr) {
+        std::vector<bool> queued(numRows, false);
+        for (const auto& m : *queueFirst) {
+            size_t r = 0;
+            for (auto it = models.begin(); it != models.end(); ++it, ++r) {
+                if (*it == m) {
+                    if (!queued[r]) {
+                        queued[r] = true;
+                        pushOrder.push_back(r);
+                    }
+                    break;
+                }
+            }
+        }
+        for (row = 0; row < (size_t)numRows; ++row) {
+            if (!queued[row]) {
+                pushOrder.push_back(row);
+            }
+        }
+    } else {
+        for (row = 0; row < (size_t)numRows; ++row) {
+            pushOrder.push_back(row);
+        }
+    }
+
     // First pass: push jobs that have no upstream dependencies so they can
     // start rendering while we finish setup on the rest.
-    for (row = 0; row < (size_t)numRows; ++row) {
+    for (size_t i = 0; i < pushOrder.size(); ++i) {
+        row = pushOrder[i];
         if (jobs[row]) {
             if (aggregators[row]->getNumAggregated() == 0) {
                 jobs[row]->setPreviousFrameDone(END_OF_RENDER_FRAME);
@@ -4052,7 +4228,8 @@ void RenderEngine::Render(SequenceElements& seqElements,
     logger_render->debug("Job pool start size {}.", (int)_jobPool.size());
 
     // Second pass: push the dependent jobs.
-    for (row = 0; row < (size_t)numRows; ++row) {
+    for (size_t i = 0; i < pushOrder.size(); ++i) {
+        row = pushOrder[i];
         if (jobs[row] && aggregators[row]->getNumAggregated() != 0) {
             _jobPool.PushJob(jobs[row]);
         }
@@ -4066,40 +4243,62 @@ void RenderEngine::Render(SequenceElements& seqElements,
     }
 }
 
-static void addModelsUpTo(std::list<Model*> &models, const std::list<Model *> &toAdd, Model *upTo) {
-    for (auto it = toAdd.begin(); it != toAdd.end(); ++it) {
-        bool add = true;
-        for (auto it2 = models.begin(); it2 != models.end() && add; ++it2) {
-            if (*it2 == *it) {
-                add = false;
-            }
+// A row needs re-rendering over [startMS, endMS] only if something on it
+// (main layers, submodels, strands or nodes) covers part of that time - an
+// empty row contributes nothing to the channels being rebuilt.
+static bool HasEffectsInTimeRange(ModelElement *me, int startMS, int endMS) {
+    for (size_t x = 0; x < me->GetEffectLayerCount(); ++x) {
+        if (me->GetEffectLayer(x)->HasEffectsInTimeRange(startMS, endMS)) {
+            return true;
         }
-        if (add) {
-            models.push_back(*it);
+    }
+    for (int x = 0; x < me->GetSubModelAndStrandCount(); ++x) {
+        Element *sm = me->GetSubModel(x);
+        for (size_t l = 0; l < sm->GetEffectLayerCount(); ++l) {
+            if (sm->GetEffectLayer(l)->HasEffectsInTimeRange(startMS, endMS)) {
+                return true;
+            }
         }
-        if (upTo == *it) {
-            return;
+    }
+    for (int x = 0; x < me->GetStrandCount(); ++x) {
+        StrandElement *se = me->GetStrand(x);
+        for (int n = 0; n < se->GetNodeLayerCount(); ++n) {
+            if (se->GetNodeLayer(n)->HasEffectsInTimeRange(startMS, endMS)) {
+                return true;
+            }
         }
     }
+    return false;
 }
 
-static void addModelsFrom(std::list<Model*> &models, const std::list<Model *> &toAdd, Model *from) {
-    bool found = false;
-    for (auto it = toAdd.begin(); it != toAdd.end(); ++it) {
-        if (!found && from != *it) {
-            continue;
-        }
-        found = true;
-        bool add = true;
-        for (auto it2 = models.begin(); it2 != models.end() && add; ++it2) {
-            if (*it2 == *it) {
-                add = false;
+// The rows a re-render of the changed models over [startMS, endMS] has to
+// include: the changed models themselves plus every row sharing channels with
+// them (groups, submodel-style overlaps, blended rows) that has an effect in
+// the window.  Returned in render tree order, which Render's dependency edges
+// rely on.
+static std::list<Model*> RowsToRerender(SequenceElements& seqElements, const std::list<RenderTreeData*>& tree,
+                                        const std::list<RenderTreeData*>& changed, int startMS, int endMS) {
+    std::set<Model*> rows;
+    for (const auto& c : changed) {
+        rows.insert(c->model);
+        for (const auto& m : c->renderOrder) {
+            if (rows.find(m) != rows.end()) {
+                continue;
+            }
+            Element *el = seqElements.GetElement(m->GetName());
+            if (el != nullptr && el->GetType() == ElementType::ELEMENT_TYPE_MODEL &&
+                    HasEffectsInTimeRange(dynamic_cast<ModelElement*>(el), startMS, endMS)) {
+                rows.insert(m);
             }
         }
-        if (add) {
-            models.push_back(*it);
+    }
+    std::list<Model*> models;
+    for (const auto& it : tree) {
+        if (rows.find(it->model) != rows.end()) {
+            models.push_back(it->model);
         }
     }
+    return models;
 }
 
 void RenderEngine::RenderDirtyModels(SequenceElements& _sequenceElements, SequenceData& _seqData,
@@ -4116,66 +4315,499 @@ void RenderEngine::RenderDirtyModels(SequenceElements& _sequenceElements, Sequen
     if (numRows == 0) {
         return;
     }
-    int startms = 9999999;
-    int endms = -1;
-    std::list<Model *> models;
-    std::list<Model *> restricts;
+
+    // One batch per dirty window of each changed row.  Windows of rows that
+    // share channels and overlap in time are merged below as those have to
+    // clear and re-render together.
+    struct DirtyBatch {
+        std::list<RenderTreeData*> changed;
+        int startFrame;
+        int endFrame;
+    };
+    const int frameTime = _seqData.FrameTime();
+    const int lastFrame = (int)_seqData.NumFrames() - 1;
+    std::vector<DirtyBatch> batches;
+    int spanStart = INT_MAX;
+    int spanEnd = -1;
     for (int x = 0; x < numRows; x++) {
         Element *el = _sequenceElements.GetElement(x);
-        if (el->GetType() != ElementType::ELEMENT_TYPE_TIMING) {
-            int st, ed;
-            el->GetDirtyRange(st, ed);
-            if (st != -1) {
-                startms = std::min(startms, st);
-                endms = std::max(endms, ed);
-                for (auto it = _renderTree.data.begin(); it != _renderTree.data.end(); ++it) {
-                    if ((*it)->model->GetName() == el->GetModelName()) {
-                        restricts.push_back((*it)->model);
-                        addModelsUpTo(models, (*it)->renderOrder, (*it)->model);
+        if (el->GetType() == ElementType::ELEMENT_TYPE_TIMING) {
+            continue;
+        }
+        int st, ed;
+        el->GetDirtyRange(st, ed);
+        if (st == -1) {
+            continue;
+        }
+        RenderTreeData *data = nullptr;
+        for (const auto& it : _renderTree.data) {
+            if (it->model->GetName() == el->GetModelName()) {
+                data = it;
+                break;
+            }
+        }
+        if (data == nullptr) {
+            continue;
+        }
+        // the jobs would otherwise widen themselves to the whole dirty span
+        for (const auto& w : el->GetAndResetDirtyWindows()) {
+            int sf = std::max(w.first / frameTime - 1, 0);
+            int ef = std::min(std::max(w.second, 0) / frameTime + 1, lastFrame);
+            if (ef < sf) {
+                continue;
+            }
+            batches.push_back({ { data }, sf, ef });
+            spanStart = std::min(spanStart, sf);
+            spanEnd = std::max(spanEnd, ef);
+        }
+    }
+    if (batches.empty()) {
+        return;
+    }
+
+    auto sharesChannels = [](const DirtyBatch& a, const DirtyBatch& b) {
+        for (const auto& da : a.changed) {
+            for (const auto& db : b.changed) {
+                if (da == db || std::find(da->renderOrder.begin(), da->renderOrder.end(), db->model) != da->renderOrder.end()) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < batches.size() && !merged; ++i) {
+            for (size_t j = i + 1; j < batches.size() && !merged; ++j) {
+                DirtyBatch& a = batches[i];
+                DirtyBatch& b = batches[j];
+                if (a.startFrame <= b.endFrame + 1 && b.startFrame <= a.endFrame + 1 && sharesChannels(a, b)) {
+                    a.startFrame = std::min(a.startFrame, b.startFrame);
+                    a.endFrame = std::max(a.endFrame, b.endFrame);
+                    for (const auto& c : b.changed) {
+                        if (std::find(a.changed.begin(), a.changed.end(), c) == a.changed.end()) {
+                            a.changed.push_back(c);
+                        }
                     }
+                    batches.erase(batches.begin() + j);
+                    merged = true;
                 }
             }
         }
     }
-    if (restricts.empty()) {
+
+    // The comparison is every row overlapping a changed row re-rendered over
+    // one window spanning every change, which is what a dirty render used to do.
+    std::set<Model*> overlapping;
+    DirtyRenderStats stats;
+    for (const auto& b : batches) {
+        std::list<Model*> models = RowsToRerender(_sequenceElements, _renderTree.data, b.changed,
+                                                  b.startFrame * frameTime, (b.endFrame + 1) * frameTime);
+        std::list<Model*> restricts;
+        for (const auto& c : b.changed) {
+            restricts.push_back(c->model);
+            overlapping.insert(c->renderOrder.begin(), c->renderOrder.end());
+        }
+        ++stats.batches;
+        stats.rowFrames += (long long)models.size() * (b.endFrame - b.startFrame + 1);
+        RenderAroundPlayhead(_sequenceElements, _seqData, models, restricts, b.startFrame, b.endFrame);
+    }
+    stats.skippedRowFrames = std::max(0LL, (long long)overlapping.size() * (spanEnd - spanStart + 1) - stats.rowFrames);
+    _lastDirtyRenderStats = stats;
+    spdlog::get("render")->debug("Dirty render: {} batches, {} row frames rendered, {} row frames skipped.",
+                                 stats.batches, stats.rowFrames, stats.skippedRowFrames);
+}
+
+void RenderEngine::SignalAbort() {
+    while (!_renderAhead.groups.empty()) {
+        DropRenderAheadGroup(_renderAhead.groups.front().id);
+    }
+    for (auto rpi : _renderProgressInfo) {
+        for (size_t row = 0; row < (size_t)rpi->numRows; ++row) {
+            if (rpi->jobs[row]) {
+                rpi->jobs[row]->AbortRender();
+                ++_abortedRenderJobs;
+            }
+        }
+    }
+}
+
+void RenderEngine::AbortBackgroundRenders(const std::list<Model*>& models) {
+    for (auto rpi : _renderProgressInfo) {
+        if (!rpi->background) {
+            continue;
+        }
+        for (size_t row = 0; row < (size_t)rpi->numRows; ++row) {
+            RenderJob* job = static_cast<RenderJob*>(rpi->jobs[row]);
+            if (job == nullptr) {
+                continue;
+            }
+            bool overlaps = models.empty();
+            for (auto it = models.begin(); it != models.end() && !overlaps; ++it) {
+                overlaps = (*it)->GetName() == job->GetModelElement()->GetModelName();
+            }
+            if (overlaps) {
+                job->AbortRender();
+            }
+        }
+    }
+}
+
+void RenderEngine::WarmRenderCache(SequenceElements& seqElements, SequenceData& seqData, unsigned int modelsChangeCount) {
+    if (!_renderCache.IsEnabled() || seqData.NumFrames() == 0 || seqElements.GetElementCount() == 0) {
         return;
     }
-    for (auto x = models.begin(); x != models.end(); ++x) {
-        for (auto it = _renderTree.data.begin(); it != _renderTree.data.end(); ++it) {
-            if ((*it)->model == *x) {
-                addModelsFrom(models, (*it)->renderOrder, (*it)->model);
+    BuildRenderTree(seqElements, modelsChangeCount);
+    if (_renderTree.data.empty()) {
+        return;
+    }
+
+    // Only locked effects are cached in locked only mode so the other rows
+    // would render for nothing.
+    std::list<Model*> models = _renderTree.GetModels();
+    if (_renderCache.IsLockedOnly()) {
+        models.remove_if([&seqElements](Model* m) {
+            ModelElement* me = dynamic_cast<ModelElement*>(seqElements.GetElement(m->GetName()));
+            return me == nullptr || !HasLockedEffects(me);
+        });
+        if (models.empty()) {
+            return;
+        }
+    }
+
+    // Rows on screen first, then the rest of the current view; models not in
+    // the view keep render tree order.
+    std::list<Model*> order;
+    auto addRow = [&models, &order](Row_Information_Struct* ri) {
+        if (ri == nullptr || ri->element == nullptr || ri->element->GetType() == ElementType::ELEMENT_TYPE_TIMING) {
+            return;
+        }
+        const std::string& name = ri->element->GetModelName();
+        for (const auto& it : models) {
+            if (it->GetName() == name) {
+                if (std::find(order.begin(), order.end(), it) == order.end()) {
+                    order.push_back(it);
+                }
+                return;
             }
         }
+    };
+    for (size_t i = 0; i < seqElements.GetVisibleRowInformationSize(); ++i) {
+        addRow(seqElements.GetVisibleRowInformation(i));
     }
-    if (startms < 0) {
-        startms = 0;
+    for (int i = 0; i < seqElements.GetRowInformationSize(); ++i) {
+        addRow(seqElements.GetRowInformation(i));
     }
-    if (endms < 0) {
-        endms = 0;
+
+    spdlog::debug("Warming render cache: {} models, {} on screen first.", models.size(), order.size());
+
+    auto start = std::chrono::steady_clock::now();
+    // Never clears: until a row's job gets to a frame, that frame keeps the
+    // data loaded from the fseq.
+    RenderBatch(seqElements, seqData, models, {}, 0, seqData.NumFrames() - 1, nullptr, false,
+                [start](bool aborted) {
+                    spdlog::info("Render cache warming {} after {}ms.", aborted ? "stopped" : "done",
+                                 (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+                },
+                RenderPriority::Background, &order);
+}
+
+// ---- render ahead playback ----
+
+// How far past the playhead render ahead keeps the re-render of an edit, and
+// so the length of the pieces it is cut into.
+static const int RENDER_AHEAD_MS = 3000;
+
+// The latest end of the effects on the row that run across ms, or -1 if none
+// does, in which case a render starting at ms starts every effect it sees from
+// its beginning just like a full render.
+static int CrossingEndMS(ModelElement *me, int ms) {
+    int end = -1;
+    auto layerRunsAcross = [ms, &end](EffectLayer* layer) {
+        for (const auto& e : layer->GetEffects()) {
+            if (e->GetStartTimeMS() < ms && e->GetEndTimeMS() > ms) {
+                end = std::max(end, e->GetEndTimeMS());
+            }
+        }
+    };
+    for (size_t x = 0; x < me->GetEffectLayerCount(); ++x) {
+        layerRunsAcross(me->GetEffectLayer(x));
     }
-    int startframe = startms /_seqData.FrameTime() - 1;
-    if (startframe < 0) {
-        startframe = 0;
+    for (int x = 0; x < me->GetSubModelAndStrandCount(); ++x) {
+        Element *sm = me->GetSubModel(x);
+        for (size_t l = 0; l < sm->GetEffectLayerCount(); ++l) {
+            layerRunsAcross(sm->GetEffectLayer(l));
+        }
     }
-    int endframe = endms / _seqData.FrameTime() + 1;
-    if (endframe >= (int)_seqData.NumFrames()) {
-        endframe = _seqData.NumFrames() - 1;
+    for (int x = 0; x < me->GetStrandCount(); ++x) {
+        StrandElement *se = me->GetStrand(x);
+        for (int n = 0; n < se->GetNodeLayerCount(); ++n) {
+            layerRunsAcross(se->GetNodeLayer(n));
+        }
     }
-    if (endframe < startframe) {
+    return end;
+}
+
+void RenderEngine::StartRenderAhead(int playFrame, int frameTime) {
+    _renderAhead.active = true;
+    _renderAhead.playFrame = playFrame;
+    _renderAhead.aheadFrames = std::max(RENDER_AHEAD_MS / std::max(frameTime, 1), 1);
+    _renderAhead.underruns = 0;
+    _renderAhead.lastUnderrunFrame = -1;
+}
+
+void RenderEngine::StopRenderAhead() {
+    if (!_renderAhead.active) {
         return;
     }
-    Render(_sequenceElements, _seqData, models, restricts, startframe, endframe, nullptr, true, [] (bool) {});
+    _renderAhead.active = false;
+    if (_renderAhead.underruns > 0) {
+        spdlog::get("render")->info("Render ahead playback stopped with {} underruns.", _renderAhead.underruns);
+    }
+    // Nothing is waiting on the rest any more: one render per group.  The
+    // running piece is left alone, its callback finds no group.
+    std::list<RenderAheadGroup> groups;
+    groups.swap(_renderAhead.groups);
+    for (const auto& g : groups) {
+        if (g.pending.empty()) {
+            continue;
+        }
+        Render(*g.seqElements, *g.seqData, g.models, g.restrictToModels,
+               g.pending.front().first, g.pending.back().second, nullptr, true, [] (bool) {});
+    }
 }
 
-void RenderEngine::SignalAbort() {
-    for (auto rpi : _renderProgressInfo) {
+bool RenderEngine::IsFrameReady(int frame) const {
+    for (const auto& rpi : _renderProgressInfo) {
+        if (rpi->background || rpi->completed.load()) {
+            continue;
+        }
         for (size_t row = 0; row < (size_t)rpi->numRows; ++row) {
-            if (rpi->jobs[row]) {
-                rpi->jobs[row]->AbortRender();
-                ++_abortedRenderJobs;
+            IRenderJobStatus* job = rpi->jobs[row];
+            if (job == nullptr) {
+                continue;
+            }
+            int cur = job->GetCurrentFrame();
+            if (cur != END_OF_RENDER_FRAME && cur <= frame && frame >= job->GetStartFrame() && frame <= job->GetEndFrame()) {
+                return false;
+            }
+        }
+    }
+    for (const auto& g : _renderAhead.groups) {
+        for (const auto& p : g.pending) {
+            if (frame >= p.first && frame <= p.second) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void RenderEngine::ReportUnderrun(int frame) {
+    ++_renderAhead.underruns;
+    // one line per stretch of unready frames, not one per frame
+    if (_renderAhead.lastUnderrunFrame == -1 || frame < _renderAhead.lastUnderrunFrame ||
+            frame - _renderAhead.lastUnderrunFrame > _renderAhead.aheadFrames) {
+        spdlog::get("render")->info("Render ahead underrun: frame {} played before it was rendered ({} so far).",
+                                    frame, _renderAhead.underruns);
+    }
+    _renderAhead.lastUnderrunFrame = frame;
+}
+
+void RenderEngine::RenderAroundPlayhead(SequenceElements& seqElements, SequenceData& seqData,
+                                        const std::list<Model*>& models,
+                                        const std::list<Model*>& restrictToModels,
+                                        int startFrame, int endFrame) {
+    if (!_renderAhead.active) {
+        Render(seqElements, seqData, models, restrictToModels, startFrame, endFrame, nullptr, true, [] (bool) {});
+        return;
+    }
+
+    // A group still working on these rows is folded into this render, its
+    // pieces would otherwise re-render the rows in the old order.
+    std::set<Model*> rows(models.begin(), models.end());
+    std::set<Model*> restricts(restrictToModels.begin(), restrictToModels.end());
+    for (auto it = _renderAhead.groups.begin(); it != _renderAhead.groups.end(); ) {
+        bool overlaps = false;
+        for (const auto& m : it->restrictToModels) {
+            overlaps = overlaps || restricts.find(m) != restricts.end();
+        }
+        if (!overlaps) {
+            ++it;
+            continue;
+        }
+        rows.insert(it->models.begin(), it->models.end());
+        restricts.insert(it->restrictToModels.begin(), it->restrictToModels.end());
+        for (const auto& p : it->pending) {
+            startFrame = std::min(startFrame, p.first);
+            endFrame = std::max(endFrame, p.second);
+        }
+        if (it->runningStart != -1) {
+            startFrame = std::min(startFrame, it->runningStart);
+            endFrame = std::max(endFrame, it->runningEnd);
+        }
+        it = _renderAhead.groups.erase(it);
+    }
+
+    // The jobs of the first piece would widen themselves to the rows' whole
+    // dirty range.
+    const int frameTime = seqData.FrameTime();
+    for (const auto& m : restricts) {
+        Element* el = seqElements.GetElement(m->GetName());
+        if (el == nullptr) {
+            continue;
+        }
+        for (const auto& w : el->GetAndResetDirtyWindows()) {
+            startFrame = std::min(startFrame, std::max(w.first / frameTime, 0));
+            endFrame = std::max(endFrame, std::max(w.second, 0) / frameTime);
+        }
+    }
+    startFrame = std::max(startFrame, 0);
+    endFrame = std::min(endFrame, (int)seqData.NumFrames() - 1);
+    if (endFrame < startFrame) {
+        return;
+    }
+
+    RenderAheadGroup g;
+    g.id = _renderAhead.nextGroupId++;
+    g.seqElements = &seqElements;
+    g.seqData = &seqData;
+    for (const auto& it : _renderTree.data) {
+        // Render's dependency edges rely on render tree order
+        if (rows.find(it->model) != rows.end()) {
+            g.models.push_back(it->model);
+        }
+        if (restricts.find(it->model) != restricts.end()) {
+            g.restrictToModels.push_back(it->model);
+        }
+    }
+
+    // Pieces of aheadFrames, each cut moved to the nearest frame within a
+    // quarter piece where no effect on the rows runs across it so effect state
+    // is not restarted part way through an effect.  With no such frame nearby
+    // the piece runs on to the next one, or to the end of the range.
+    std::vector<ModelElement*> elements;
+    for (const auto& m : g.models) {
+        Element* el = seqElements.GetElement(m->GetName());
+        if (el != nullptr && el->GetType() == ElementType::ELEMENT_TYPE_MODEL) {
+            elements.push_back(dynamic_cast<ModelElement*>(el));
+        }
+    }
+    auto crossingEnd = [&elements, frameTime](int frame) {
+        int end = -1;
+        for (const auto& el : elements) {
+            end = std::max(end, CrossingEndMS(el, frame * frameTime));
+        }
+        return end;
+    };
+    auto isClean = [&crossingEnd](int frame) {
+        return crossingEnd(frame) == -1;
+    };
+    // the first clean frame from frame on, jumping past the effects in the way,
+    // or -1 if there is none up to endFrame
+    auto nextClean = [&crossingEnd, frameTime, endFrame](int frame) {
+        while (frame <= endFrame) {
+            int end = crossingEnd(frame);
+            if (end == -1) {
+                return frame;
             }
+            frame = std::max(frame + 1, (end + frameTime - 1) / frameTime);
         }
+        return -1;
+    };
+    const int piece = _renderAhead.aheadFrames;
+    const int reach = std::max(piece / 4, 1);
+    int pieceStart = startFrame;
+    while (pieceStart <= endFrame) {
+        int cut = pieceStart + piece;
+        if (cut + reach > endFrame) {
+            g.pending.push_back({ pieceStart, endFrame });
+            break;
+        }
+        int clean = -1;
+        for (int d = 0; d <= reach && clean == -1; ++d) {
+            if (isClean(cut - d)) {
+                clean = cut - d;
+            } else if (isClean(cut + d)) {
+                clean = cut + d;
+            }
+        }
+        if (clean == -1) {
+            clean = nextClean(cut + reach + 1);
+        }
+        if (clean == -1) {
+            g.pending.push_back({ pieceStart, endFrame });
+            break;
+        }
+        g.pending.push_back({ pieceStart, clean - 1 });
+        pieceStart = clean;
+    }
+
+    spdlog::get("render")->debug("Render ahead: frames {}-{} of {} rows in {} pieces, playhead at {}.",
+                                 startFrame, endFrame, g.models.size(), g.pending.size(), _renderAhead.playFrame);
+    int id = g.id;
+    _renderAhead.groups.push_back(std::move(g));
+    RenderNextAheadPiece(id);
+}
+
+void RenderEngine::RenderNextAheadPiece(int groupId) {
+    auto g = std::find_if(_renderAhead.groups.begin(), _renderAhead.groups.end(),
+                          [groupId](const RenderAheadGroup& g) { return g.id == groupId; });
+    if (g == _renderAhead.groups.end()) {
+        return;
     }
+    g->runningStart = g->runningEnd = -1;
+    if (g->pending.empty()) {
+        _renderAhead.groups.erase(g);
+        return;
+    }
+
+    // The piece at or after the playhead, else the closest one behind it
+    const int play = _renderAhead.playFrame;
+    auto next = std::find_if(g->pending.begin(), g->pending.end(),
+                             [play](const std::pair<int, int>& p) { return p.second >= play; });
+    if (next == g->pending.end()) {
+        next = std::prev(g->pending.end());
+    }
+    bool atPlayhead = next->second >= play && next->first <= play + _renderAhead.aheadFrames;
+    g->runningStart = next->first;
+    g->runningEnd = next->second;
+    g->pending.erase(next);
+
+    AbortBackgroundRenders(g->models);
+    _abortedRenderJobs = 0;
+    RenderBatch(*g->seqElements, *g->seqData, g->models, g->restrictToModels, g->runningStart, g->runningEnd, nullptr, true,
+                [this, groupId](bool aborted) {
+                    if (aborted) {
+                        DropRenderAheadGroup(groupId);
+                    } else {
+                        RenderNextAheadPiece(groupId);
+                    }
+                },
+                atPlayhead ? RenderPriority::High : RenderPriority::Normal, nullptr);
+}
+
+void RenderEngine::DropRenderAheadGroup(int groupId) {
+    auto g = std::find_if(_renderAhead.groups.begin(), _renderAhead.groups.end(),
+                          [groupId](const RenderAheadGroup& g) { return g.id == groupId; });
+    if (g == _renderAhead.groups.end()) {
+        return;
+    }
+    const int frameTime = g->seqData->FrameTime();
+    for (const auto& m : g->restrictToModels) {
+        Element* el = g->seqElements->GetElement(m->GetName());
+        if (el == nullptr) {
+            continue;
+        }
+        if (g->runningStart != -1) {
+            el->SetDirtyRange(g->runningStart * frameTime, g->runningEnd * frameTime);
+        }
+        for (const auto& p : g->pending) {
+            el->SetDirtyRange(p.first * frameTime, p.second * frameTime);
+        }
+    }
+    _renderAhead.groups.erase(g);
 }
 
 // RenderGridToSeqData - moved to RenderUI.cpp (creates WxRenderProgressSink)
@@ -4251,40 +4883,153 @@ void RenderEngine::RenderEffectForModel(const std::string &model, int startms, i
             }
             std::list<Model *> m;
             m.push_back(it->model);
+            std::list<Model *> rows = RowsToRerender(_sequenceElements, _renderTree.data, { it }, startframe * _seqData.FrameTime(),
+                                                     (endframe + 1) * _seqData.FrameTime());
 
-            spdlog::debug("Rendering {} models {} frames.", m.size(), endframe - startframe + 1);
+            spdlog::debug("Rendering {} of {} overlapping models {} frames.", rows.size(), it->renderOrder.size(), endframe - startframe + 1);
 
-            Render(_sequenceElements, _seqData, it->renderOrder, m, startframe, endframe, nullptr, true, [] (bool) {});
+            RenderAroundPlayhead(_sequenceElements, _seqData, rows, m, startframe, endframe);
         }
     }
 }
 
+namespace {
+// Collects an exported model into a SequenceData of its own
+class SequenceDataModelWriter : public RenderEngine::ModelDataWriter {
+public:
+    std::unique_ptr<SequenceData> data;
+    int chansPerNode = 0;
+
+    bool Start(unsigned int numChannels, int cpn, unsigned int numFrames, unsigned int frameTime) override {
+        data = std::make_unique<SequenceData>();
+        data->init(numChannels, numFrames, frameTime, false);
+        chansPerNode = cpn;
+        return true;
+    }
+    void WriteFrame(unsigned int frame, const unsigned char* d) override {
+        memcpy(&(*data)[frame][0], d, data->NumChannels());
+    }
+};
+
+// How one model is pulled out of a frame.  Plain RGB nodes round trip through
+// the node unchanged, so they become straight copies, merged into runs where
+// nodes are laid out back to back.  Any other node type (white, RGBW, ...)
+// is converted by the node itself as it always has been.
+struct ModelExportPlan {
+    struct Step {
+        int node = -1; // -1 for a copy run
+        unsigned int src = 0;
+        unsigned int dst = 0;
+        unsigned int len = 0;
+    };
+    Model* model = nullptr;
+    RenderEngine::ModelDataWriter* writer = nullptr;
+    std::unique_ptr<PixelBufferClass> buffer;
+    std::vector<Step> steps;
+    std::vector<unsigned char> frame;
+    unsigned int firstChannel = 0;
+    bool converts = false;
+
+    void AddCopy(unsigned int src, unsigned int dst) {
+        if (!steps.empty() && steps.back().node == -1 &&
+            steps.back().src + steps.back().len == src && steps.back().dst + steps.back().len == dst) {
+            ++steps.back().len;
+        } else {
+            steps.push_back({ -1, src, dst, 1 });
+        }
+    }
+};
+}
+
 RenderEngine::ExportedModelData RenderEngine::ExportModelData(const std::string& modelName, SequenceData& sourceData) {
     ExportedModelData result;
 
-    Model* model = _ctx.GetModel(modelName);
-    if (model == nullptr)
+    SequenceDataModelWriter writer;
+    if (ExportModelsData({ { modelName, &writer } }, sourceData) == 0)
         return result;
 
-    PixelBufferClass buffer(&_ctx);
-    buffer.InitBuffer(*model, 1, sourceData.FrameTime());
+    result.data = std::move(writer.data);
+    result.chansPerNode = writer.chansPerNode;
+    return result;
+}
+
+int RenderEngine::ExportModelsData(const std::vector<std::pair<std::string, ModelDataWriter*>>& models, SequenceData& sourceData) {
+    const unsigned int srcChannels = sourceData.NumChannels();
+    const std::type_info& baseTI = typeid(NodeBaseClass);
 
-    auto exportData = std::make_unique<SequenceData>();
-    exportData->init(model->GetActChanCount(), sourceData.NumFrames(), sourceData.FrameTime(), false);
+    std::vector<std::unique_ptr<ModelExportPlan>> plans;
+    for (const auto& it : models) {
+        Model* model = _ctx.GetModel(it.first);
+        if (model == nullptr || it.second == nullptr)
+            continue;
 
-    int firstChan = model->NodeStartChannel(0);
-    for (size_t frame = 0; frame < sourceData.NumFrames(); ++frame) {
-        for (size_t x = 0; x < buffer.GetNodeCount(); ++x) {
-            int ostart = model->NodeStartChannel(x);
-            int nstart = ostart - firstChan;
-            buffer.SetNodeChannelValues(x, &sourceData[frame][ostart]);
-            buffer.GetNodeChannelValues(x, &((*exportData)[frame][nstart]));
+        auto plan = std::make_unique<ModelExportPlan>();
+        plan->model = model;
+        plan->writer = it.second;
+        plan->buffer = std::make_unique<PixelBufferClass>(&_ctx);
+        plan->buffer->InitBuffer(*model, 1, sourceData.FrameTime());
+        const unsigned int numChannels = model->GetActChanCount();
+        if (!it.second->Start(numChannels, plan->buffer->GetChanCountPerNode(), sourceData.NumFrames(), sourceData.FrameTime()))
+            continue;
+        plan->frame.resize(numChannels + 8); // slack as nodes write their full channel count
+        plan->firstChannel = model->NodeStartChannel(0);
+
+        for (size_t x = 0; x < plan->buffer->GetNodeCount(); ++x) {
+            unsigned int ostart = model->NodeStartChannel(x);
+            unsigned int nstart = ostart - plan->firstChannel;
+            NodeBaseClass* node = model->GetNode(x);
+            if (node != nullptr && typeid(*node) == baseTI) {
+                for (int c = 0; c < 3; ++c) {
+                    uint8_t o = node->GetChannelOffsetBase(c);
+                    if (o != 255 && ostart + o < srcChannels && nstart + o < numChannels) {
+                        plan->AddCopy(ostart + o, nstart + o);
+                    }
+                }
+            } else if (ostart < srcChannels && nstart < numChannels) {
+                plan->steps.push_back({ (int)x, ostart, nstart, 0 });
+                plan->converts = true;
+            }
         }
+        plans.push_back(std::move(plan));
     }
 
-    result.data = std::move(exportData);
-    result.chansPerNode = buffer.GetChanCountPerNode();
-    return result;
+    // walk each frame front to back
+    std::sort(plans.begin(), plans.end(), [](const auto& a, const auto& b) { return a->firstChannel < b->firstChannel; });
+
+    const SequenceData& src = sourceData;
+    std::vector<unsigned char> nodeSrc(16);
+    for (unsigned int frame = 0; frame < src.NumFrames(); ++frame) {
+        auto fd = src[frame];
+        const unsigned char* fdata = fd[0];
+        for (auto& plan : plans) {
+            unsigned char* out = plan->frame.data();
+            if (plan->converts) {
+                // a node conversion need not write every channel, each frame starts clean
+                memset(out, 0, plan->frame.size());
+            }
+            for (const auto& step : plan->steps) {
+                if (step.node == -1) {
+                    memcpy(&out[step.dst], &fdata[step.src], step.len);
+                } else {
+                    // nodes read their full channel count, pad a node at the very end of the frame
+                    const unsigned char* in = &fdata[step.src];
+                    if (step.src + nodeSrc.size() > srcChannels) {
+                        std::fill(nodeSrc.begin(), nodeSrc.end(), 0);
+                        memcpy(nodeSrc.data(), in, srcChannels - step.src);
+                        in = nodeSrc.data();
+                    }
+                    plan->buffer->SetNodeChannelValues(step.node, in);
+                    plan->buffer->GetNodeChannelValues(step.node, &out[step.dst]);
+                }
+            }
+            plan->writer->WriteFrame(frame, out);
+        }
+    }
+
+    for (auto& plan : plans) {
+        plan->writer->Finish();
+    }
+    return (int)plans.size();
 }
 
 // XL_VERIFY_STATELESS oracle (see xldbgVerifyStateless).  The frame has just
@@ -4471,6 +5216,9 @@ bool RenderEngine::RenderEffectFromMap(bool suppress, Effect* effectObj, int lay
                                 }
                                 else if (effectObj != nullptr && reff->SupportsRenderCache(SettingsMap) && _renderCache.IsEnabled()) {
                                     if (!effectObj->GetFrame(*rb, _renderCache, SettingsMap)) {
+                                        // timed whether or not profiling is on: the render
+                                        // time is what the cache ranks items by on eviction
+                                        auto const renderStart = std::chrono::steady_clock::now();
                                         // Serial advance+draw: a migrated Snapshottable
                                         // effect advances here, then Render draws the
                                         // returned snapshot - identical to the draw pass.
@@ -4493,7 +5241,7 @@ bool RenderEngine::RenderEffectFromMap(bool suppress, Effect* effectObj, int lay
                                             // and that is where the cache actually pays off.)
                                         } else {
                                             GPURenderUtils::waitForRenderCompletion(rb);
-                                            effectObj->AddFrame(*rb, _renderCache);
+                                            effectObj->AddFrame(*rb, _renderCache, xlProfNs(renderStart, std::chrono::steady_clock::now()));
                                         }
                                     }
                                 }
@@ -4541,6 +5289,8 @@ bool RenderEngine::RenderEffectFromMap(bool suppress, Effect* effectObj, int lay
                 }
                 if (effProf != nullptr) {
                     effProf->addEffect(reff->Name(), xlProfNs(eff0, std::chrono::steady_clock::now()));
+                    effProf->bufferCells += b->GetPixelCount();
+                    effProf->occupiedCells += b->GetOccupiedCount();
                 }
             }
         }
@@ -4566,6 +5316,14 @@ void RenderEngine::RequeueJob(Job* job) {
     _jobPool.PushJob(job);
 }
 
+void RenderEngine::PromoteJob(Job* job) {
+    _jobPool.PromoteJob(job);
+}
+
+bool RenderEngine::HasForegroundJobsQueued() const {
+    return _jobPool.HasForegroundJobsQueued();
+}
+
 size_t RenderEngine::RecommendedPoolSize() {
     size_t hw = std::thread::hardware_concurrency();
     // Cap the GPU term: big-GPU Macs report 40-76 cores and the pool doesn't
@@ -4574,6 +5332,11 @@ size_t RenderEngine::RecommendedPoolSize() {
     return std::max<size_t>(8, hw + gpu + 4);
 }
 
+void RenderEngine::SetRenderProfileSink(RenderProfileSink sink) {
+    profRenderSink = std::move(sink);
+    profRender = profRenderDump || (bool)profRenderSink;
+}
+
 // How long a batch may go without ANY row advancing a frame before the log
 // says so and names the outstanding rows.  Generous on purpose: one frame of a
 // whole-house group on a slow box is seconds, not a minute, so a whole minute
@@ -4760,7 +5523,7 @@ static void DumpRenderProfile(RenderProgressInfo* rpi, long long elapsedMS) {
         return s;
     };
     const bool gpuOn = GPURenderUtils::IsEnabled();
-    const char* rowFmt = "%-28.28s %6llu %5llu %9.1f %9.1f %8.1f %8.1f %9.1f %9.1f %9.1f %8.1f %9.1f %9.1f %5.1f %5.1f  %s\n";
+    const char* rowFmt = "%-28.28s %6llu %5llu %9.1f %9.1f %8.1f %8.1f %9.1f %9.1f %9.1f %8.1f %9.1f %9.1f %5.1f %5.1f %5.1f  %s\n";
 
     fprintf(stderr, "\n=== XL_RENDER_PROFILE  frames %d-%d  wall %lldms  jobs %d  suspends %d  suspended %.1fms ===\n",
             rpi->startFrame, rpi->endFrame, elapsedMS, rpi->totalJobs,
@@ -4791,22 +5554,25 @@ static void DumpRenderProfile(RenderProgressInfo* rpi, long long elapsedMS) {
         fprintf(stderr, "GPU rendering OFF - `effect` is the whole cost; `gpu`/`gpuWait` are expected to be 0.\n");
     }
 
-    fprintf(stderr, "%-28s %6s %5s %9s %9s %8s %8s %9s %9s %9s %8s %9s %9s %5s %5s  %s\n",
-            "model", "frames", "slices", "effect", "gpu", "blurZ", "trans", "blend", "getCol", "setCol", "gpuWait", "suspend", "wall", "%gpu", "%sus", "top effects (ms)");
+    fprintf(stderr, "%-28s %6s %5s %9s %9s %8s %8s %9s %9s %9s %8s %9s %9s %5s %5s %5s  %s\n",
+            "model", "frames", "slices", "effect", "gpu", "blurZ", "trans", "blend", "getCol", "setCol", "gpuWait", "suspend", "wall", "%gpu", "%sus", "%occ", "top effects (ms)");
     for (const auto& r : rows) {
         const RenderJobProfile* p = r.p;
         fprintf(stderr, rowFmt,
                 r.name.c_str(), (unsigned long long)p->frames, (unsigned long long)p->slices,
                 ms(p->effectNs), ms(p->gpuBusyNs), ms(p->blurZoomNs), ms(p->transitionNs), ms(p->blendNs), ms(p->getColorsNs), ms(p->setColorsNs),
                 ms(p->gpuWaitNs), ms(p->suspendedNs), ms(p->wallNs()),
-                pct(p->gpuWaitNs, p->wallNs()), pct(p->suspendedNs, p->wallNs()),
+                pct(p->gpuWaitNs, p->wallNs()), pct(p->suspendedNs, p->wallNs()), pct(p->occupiedCells, p->bufferCells),
                 topEffects(p).c_str());
     }
     fprintf(stderr, rowFmt,
             "TOTAL", (unsigned long long)total.frames, (unsigned long long)total.slices,
             ms(total.effectNs), ms(total.gpuBusyNs), ms(total.blurZoomNs), ms(total.transitionNs), ms(total.blendNs), ms(total.getColorsNs), ms(total.setColorsNs),
             ms(total.gpuWaitNs), ms(total.suspendedNs), ms(total.wallNs()),
-            pct(total.gpuWaitNs, total.wallNs()), pct(total.suspendedNs, total.wallNs()), "");
+            pct(total.gpuWaitNs, total.wallNs()), pct(total.suspendedNs, total.wallNs()), pct(total.occupiedCells, total.bufferCells), "");
+    if (total.occludedLayerFrames > 0) {
+        fprintf(stderr, "%llu layer-frames not rendered, hidden under an opaque layer\n", (unsigned long long)total.occludedLayerFrames);
+    }
 
     // Per-effect table, ranked by cpu+gpu.  Keys are the union of the CPU and GPU
     // maps: GPU-only rows appear for stage work no effect owns ("(gpu blend)" etc).
@@ -4854,16 +5620,27 @@ void RenderEngine::NotifyJobFinished(RenderProgressInfo* rpi) {
     // only at debug to keep interactive editing from spamming the log.
     auto elapsedMS = std::chrono::duration_cast<std::chrono::milliseconds>(
                          std::chrono::steady_clock::now() - rpi->startTime).count();
-    spdlog::log(rpi->progressSink ? spdlog::level::info : spdlog::level::debug,
+    spdlog::log(rpi->progressSink || rpi->background ? spdlog::level::info : spdlog::level::debug,
                 "Render batch complete: {} jobs over frames {}-{}, {} suspensions ({}ms), {} row parks, {}ms, {}",
                 rpi->totalJobs, rpi->startFrame, rpi->endFrame,
                 rpi->suspendCount.load(), (long long)(rpi->suspendedNs.load() / 1000000),
                 rpi->parkCount.load(), (long long)elapsedMS,
-                rpi->progressSink ? "background" : "interactive");
+                rpi->background ? "cache warming" : rpi->progressSink ? "background" : "interactive");
 
-    if (profRender) {
+    if (profRenderDump) {
         DumpRenderProfile(rpi, (long long)elapsedMS);
     }
+    if (profRenderSink) {
+        RenderJobProfile total;
+        for (int i = 0; i < rpi->numRows; ++i) {
+            IRenderJobStatus* j = rpi->jobs[i];
+            const RenderJobProfile* p = j == nullptr ? nullptr : j->GetRenderProfile();
+            if (p != nullptr && p->slices != 0) {
+                total.merge(*p);
+            }
+        }
+        profRenderSink(total, (long long)elapsedMS, rpi->startFrame, rpi->endFrame);
+    }
     if (xldbgRenderMem) {
         RenderMemoryGovernor& gov = RenderMemoryGovernor::Get();
         fprintf(stderr, "XL_RENDER_MEM BATCH clones=%llu (%.1f MB) dropped=%llu peakFootprint=%llu MB soft=%llu MB\n",
@@ -16,6 +16,8 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 class Effect;
 class IRenderProgressSink;
@@ -25,6 +27,7 @@ class JobPool;
 class Model;
 class RenderCache;
 class RenderContext;
+struct RenderJobProfile;
 class RenderProgressInfo;
 class RenderTreeData;
 class SequenceData;
@@ -47,6 +50,13 @@ public:
     // and iPad pool setup so the heuristic lives in one place.
     static size_t RecommendedPoolSize();
 
+    // Receives the merged stage/effect profile of every completed render
+    // batch, on the thread of the batch's last job.  Setting a sink turns on
+    // render profiling (as XL_RENDER_PROFILE does, without the stderr dump)
+    // so it must be set before rendering starts.  Used by the benchmark.
+    typedef std::function<void(const RenderJobProfile& total, long long elapsedMS, int startFrame, int endFrame)> RenderProfileSink;
+    static void SetRenderProfileSink(RenderProfileSink sink);
+
     // ---- render tree ----
     void BuildRenderTree(SequenceElements& elements, unsigned int modelsChangeCount);
 
@@ -61,6 +71,16 @@ public:
     void RenderDirtyModels(SequenceElements& elements, SequenceData& seqData,
                            bool suspendRender, unsigned int modelsChangeCount);
 
+    // What the last RenderDirtyModels call rendered, in rows x frames, and how
+    // much less that was than re-rendering every row overlapping a change over
+    // one window spanning every change.
+    struct DirtyRenderStats {
+        int batches = 0;
+        long long rowFrames = 0;
+        long long skippedRowFrames = 0;
+    };
+    const DirtyRenderStats& GetLastDirtyRenderStats() const { return _lastDirtyRenderStats; }
+
     void RenderEffectForModel(const std::string& model, int startms, int endms,
                               SequenceElements& elements, SequenceData& seqData,
                               bool suspendRender, unsigned int modelsChangeCount,
@@ -74,6 +94,48 @@ public:
     };
     ExportedModelData ExportModelData(const std::string& modelName, SequenceData& sourceData);
 
+    // Receives one model's channel data, a frame at a time, from ExportModelsData.
+    class ModelDataWriter {
+    public:
+        virtual ~ModelDataWriter() = default;
+        // Called before any frames.  Returning false leaves the model out of the export.
+        virtual bool Start(unsigned int numChannels, int chansPerNode, unsigned int numFrames, unsigned int frameTime) = 0;
+        // Called for every frame in frame order.  data holds numChannels bytes.
+        virtual void WriteFrame(unsigned int frame, const unsigned char* data) = 0;
+        virtual void Finish() {}
+    };
+    // Extracts any number of models in a single pass over the frames: each
+    // frame is read once, front to back, and handed out to every model's writer
+    // before moving on to the next, rather than sweeping the whole sequence
+    // once per model.  Returns the number of models exported.
+    int ExportModelsData(const std::vector<std::pair<std::string, ModelDataWriter*>>& models, SequenceData& sourceData);
+
+    // Low priority pass, run after a sequence is opened, that renders every
+    // row into the render cache (and the sequence data) on threads the pool
+    // would otherwise leave idle, starting with the rows on screen.  Its jobs
+    // yield to any queued user render between frames, and a user render that
+    // touches the same rows stops them.  Does nothing with the cache disabled.
+    void WarmRenderCache(SequenceElements& elements, SequenceData& seqData,
+                         unsigned int modelsChangeCount);
+    // Stops cache warming on these models, or on every model if empty.
+    void AbortBackgroundRenders(const std::list<Model*>& models = {});
+
+    // ---- render ahead playback ----
+    // While a sequence plays with render ahead on, an edit's re-render is cut
+    // into pieces a few seconds long that are queued one after another: the
+    // piece at the playhead first, at high priority, then the pieces ahead of
+    // it and last the frames already played.  Playback checks IsFrameReady for
+    // every frame it outputs and reports the ones that were not with
+    // ReportUnderrun.  All of this runs on the UI thread.
+    void StartRenderAhead(int playFrame, int frameTime);
+    void SetRenderAheadPlayhead(int frame) { _renderAhead.playFrame = frame; }
+    // Queues whatever is still waiting as ordinary renders.
+    void StopRenderAhead();
+    bool IsRenderAheadActive() const { return _renderAhead.active; }
+    bool IsFrameReady(int frame) const;
+    void ReportUnderrun(int frame);
+    int GetRenderAheadUnderruns() const { return _renderAhead.underruns; }
+
     void SignalAbort();
     bool IsRenderDone() const { return _renderProgressInfo.empty(); }
 
@@ -92,6 +154,10 @@ public:
     // Push a render job (back) onto the pool — used by suspended jobs waking
     // up and by row-ownership handoff between jobs.
     void RequeueJob(Job* job);
+    // Background job support: jump an aborted job ahead of foreground work,
+    // and tell a running one there is foreground work waiting for its thread.
+    void PromoteJob(Job* job);
+    bool HasForegroundJobsQueued() const;
 
     // Watchdog: if a batch makes no progress while the pool is idle, a
     // wake-up was lost — requeue suspended jobs so the batch can finish.
@@ -128,6 +194,52 @@ public:
     void SetOnAllRenderJobsComplete(std::function<void()> fn) { _onAllRenderJobsComplete = std::move(fn); }
 
 private:
+    // JobPool queue for a batch's jobs.  Default is Render's rule: high
+    // priority unless the batch has a progress sink (Render All, batch
+    // render).  Background is cache warming.
+    enum class RenderPriority { Default, High, Normal, Background };
+    // queueFirst, if given, lists the models whose rows are queued first.
+    void RenderBatch(SequenceElements& seqElements, SequenceData& seqData,
+                     const std::list<Model*>& models,
+                     const std::list<Model*>& restrictToModels,
+                     int startFrame, int endFrame,
+                     std::unique_ptr<IRenderProgressSink> sink, bool clear,
+                     std::function<void(bool)>&& callback,
+                     RenderPriority priority,
+                     const std::list<Model*>* queueFirst);
+
+    // Render, or with render ahead active the first piece of it with the
+    // rest left pending on a group that queues the next piece as each one
+    // completes.
+    void RenderAroundPlayhead(SequenceElements& seqElements, SequenceData& seqData,
+                              const std::list<Model*>& models,
+                              const std::list<Model*>& restrictToModels,
+                              int startFrame, int endFrame);
+    void RenderNextAheadPiece(int groupId);
+    // Marks what a render ahead group had left as dirty so the next render of
+    // its rows picks it up.
+    void DropRenderAheadGroup(int groupId);
+
+    struct RenderAheadGroup {
+        int id = 0;
+        SequenceElements* seqElements = nullptr;
+        SequenceData* seqData = nullptr;
+        std::list<Model*> models;
+        std::list<Model*> restrictToModels;
+        std::list<std::pair<int, int>> pending; // frame ranges, in time order
+        int runningStart = -1;                  // the piece queued now
+        int runningEnd = -1;
+    };
+    struct RenderAheadState {
+        bool active = false;
+        int playFrame = 0;
+        int aheadFrames = 0;
+        int underruns = 0;
+        int lastUnderrunFrame = -1;
+        int nextGroupId = 1;
+        std::list<RenderAheadGroup> groups;
+    };
+
     RenderContext& _ctx;
     JobPool& _jobPool;
     RenderCache& _renderCache;
@@ -135,6 +247,8 @@ private:
     RenderTree _renderTree;
     std::list<RenderProgressInfo*> _renderProgressInfo;
     int _abortedRenderJobs = 0;
+    DirtyRenderStats _lastDirtyRenderStats;
+    RenderAheadState _renderAhead;
     // Watchdog bookkeeping.  _stallCheckLock serializes CheckForStalledRender:
     // on iPad it is polled from more than one thread (main-actor timer plus
     // background drain loops).  _lastStallCheck throttles the per-job scan.
@@ -47,6 +47,11 @@ struct RenderJobProfile {
     uint64_t frames = 0;        // frames actually rendered
     uint64_t slices = 0;        // ProcessSlice entries
     uint64_t suspends = 0;      // suspension count
+    uint64_t occludedLayerFrames = 0; // layer renders skipped, hidden under an opaque layer
+    // Buffer cells behind each effect render, and how many of them a node
+    // actually samples; occupiedCells/bufferCells is the row's occupancy.
+    uint64_t bufferCells = 0;
+    uint64_t occupiedCells = 0;
 
     // GPU execution, attributed back to the effect that encoded the work (see
     // GpuCommandBufferTag).  gpuBusyNs is Σ of per-command-buffer GPU windows,
@@ -96,6 +101,9 @@ struct RenderJobProfile {
         frames += o.frames;
         slices += o.slices;
         suspends += o.suspends;
+        occludedLayerFrames += o.occludedLayerFrames;
+        bufferCells += o.bufferCells;
+        occupiedCells += o.occupiedCells;
         gpuBusyNs += o.gpuBusyNs;
         gpuSharedNs += o.gpuSharedNs;
         gpuCbs += o.gpuCbs;
@@ -48,6 +48,7 @@ public:
     AggregatorRenderer** aggregators; // owned array
     IRenderProgressSink* progressSink; // owned; deleted when render group completes
     std::list<Model*> restriction;
+    bool background = false; // render cache warming (RenderEngine::WarmRenderCache)
 
     // Completion tracking. jobsRemaining is decremented by each RenderJob as it
     // reaches its Done state (normal, aborted, or early-bail paths).  When it
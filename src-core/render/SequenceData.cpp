@@ -8,10 +8,13 @@
  * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <new>
 
 #include <log.h>
+#include <zstd.h>
 
 #include "utils/Base64.h"
 #include "render/SequenceData.h"
@@ -37,6 +40,14 @@ const unsigned char SequenceData::FrameData::_constzero = 0;
 // memory.  Most users sequences will likely fit in this anyway
 static const size_t MAX_BLOCK_SIZE = 1024 * 1024 * 1024;
 
+// Compressed storage block size. Big enough that zstd finds the redundancy
+// between frames, small enough that touching a frame decompresses little
+static const size_t COMPRESSED_BLOCK_SIZE = 8 * 1024 * 1024;
+// A written block is left alone this long before CompressIdleBlocks compresses
+// it, so rows still rendering into it do not get it compressed over and over
+static const uint32_t BLOCK_IDLE_MS = 2000;
+static const int BLOCK_COMPRESSION_LEVEL = 1;
+
 #ifdef USE_MMAP_BLOCKS
 std::list<std::unique_ptr<SequenceData::DataBlock>> SequenceData::HUGE_BLOCK_CACHE;
 #include <thread>
@@ -128,6 +139,21 @@ bool SequenceData::ShouldUseFileBacked(size_t totalSize) {
 #endif
 }
 
+// XL_SEQDATA_COMPRESS=1 forces compressed storage on, =0 forces it off
+bool SequenceData::ShouldUseCompressed(size_t totalSize) {
+    const char* env = getenv("XL_SEQDATA_COMPRESS");
+    if (env != nullptr && *env != 0) {
+        return *env != '0';
+    }
+#if defined(__APPLE__)
+    return false; // file-backed blocks already cover this
+#else
+    // Use compressed if sequence would consume >50% of physical memory
+    uint64_t physMB = GetPhysicalMemorySizeMB();
+    return physMB > 0 && totalSize / (1024 * 1024) > physMB / 2;
+#endif
+}
+
 SequenceData::~SequenceData()
 {
     Cleanup();
@@ -147,6 +173,16 @@ SequenceData::DataBlock::~DataBlock()
 void SequenceData::Cleanup()
 {
     _frames.clear();
+    if (_blocks != nullptr) {
+        for (unsigned int b = 0; b < _numBlocks; ++b) {
+            free(_blocks[b].data);
+        }
+        delete[] _blocks;
+        _blocks = nullptr;
+        _numBlocks = 0;
+        _framesPerBlock = 0;
+        _residentBytes = 0;
+    }
 #ifdef USE_MMAP_BLOCKS
     for (auto& p : _dataBlocks) {
         if (p.get() && p.get()->type == BlockType::HUGE_PAGE) {
@@ -347,7 +383,10 @@ void SequenceData::init(unsigned int numChannels, unsigned int numFrames, unsign
     _frameTime = frameTime;
     _bytesPerFrame = roundTo4(numChannels);
 
-    if (numFrames > 0 && numChannels > 0) {
+    if (numFrames > 0 && numChannels > 0 && ShouldUseCompressed((size_t)_bytesPerFrame * (size_t)_numFrames)) {
+        InitCompressed();
+    }
+    else if (numFrames > 0 && numChannels > 0) {
         _frames.reserve(numFrames);
         size_t sizeRemaining = (size_t)_bytesPerFrame * (size_t)_numFrames;
         size_t blockSize = 0;
@@ -380,6 +419,167 @@ void SequenceData::init(unsigned int numChannels, unsigned int numFrames, unsign
 }
 
 
+void SequenceData::InitCompressed()
+{
+    _framesPerBlock = std::max((unsigned int)(COMPRESSED_BLOCK_SIZE / _bytesPerFrame), 1u);
+    _numBlocks = (_numFrames + _framesPerBlock - 1) / _framesPerBlock;
+    _blocks = new FrameBlock[_numBlocks];
+    for (unsigned int b = 0; b < _numBlocks; ++b) {
+        _blocks[b].firstFrame = b * _framesPerBlock;
+        _blocks[b].numFrames = std::min(_framesPerBlock, _numFrames - _blocks[b].firstFrame);
+    }
+    _frames.reserve(_numFrames);
+    for (unsigned int frame = 0; frame < _numFrames; ++frame) {
+        _frames.push_back(FrameData(_numChannels, nullptr));
+    }
+
+    // an eighth of memory keeps a good stretch of the show hot without
+    // putting back the memory pressure compressing was meant to remove
+    const size_t blockBytes = (size_t)_framesPerBlock * _bytesPerFrame;
+    uint64_t physMB = GetPhysicalMemorySizeMB();
+    uint64_t budgetMB = std::clamp<uint64_t>(physMB / 8, 256, 4096);
+    _residentBudget = std::max((size_t)(budgetMB * 1024 * 1024), blockBytes * 4);
+
+    spdlog::info("SequenceData using compressed blocks for {} bytes ({} frames, {} channels), {} frames per block, {} MB resident.",
+                 (size_t)_bytesPerFrame * _numFrames, _numFrames, _numChannels, _framesPerBlock, _residentBudget / (1024 * 1024));
+}
+
+void SequenceData::LoadBlock(FrameBlock& b) const
+{
+    std::unique_lock<std::mutex> lock(b.lock);
+    // an eviction that saw this block being touched backs out and leaves it resident
+    if (b.state == BlockState::RESIDENT) {
+        return;
+    }
+    const size_t bytes = (size_t)b.numFrames * _bytesPerFrame;
+    unsigned char* data = (unsigned char*)(b.compressed.empty() ? calloc(1, bytes) : malloc(bytes));
+    if (data == nullptr) {
+        spdlog::critical("Error allocating memory for frame data block. Frames={}, Channels={}, Memory={}.", b.numFrames, _numChannels, bytes);
+        // the caller is about to use the frames, carrying on would dereference null
+        throw std::bad_alloc();
+    }
+    if (!b.compressed.empty()) {
+        size_t r = ZSTD_decompress(data, bytes, b.compressed.data(), b.compressed.size());
+        if (ZSTD_isError(r) || r != bytes) {
+            spdlog::error("Failed to decompress frame data block at frame {}: {}", b.firstFrame, ZSTD_isError(r) ? ZSTD_getErrorName(r) : "short block");
+            memset(data, 0, bytes);
+        }
+    }
+    b.data = data;
+    for (unsigned int f = 0; f < b.numFrames; ++f) {
+        _frames[b.firstFrame + f]._data = data + (size_t)f * _bytesPerFrame;
+    }
+    _residentBytes += bytes;
+    b.state = BlockState::RESIDENT;
+    lock.unlock();
+
+    if (_residentBytes > _residentBudget) {
+        TrimBlocks(_residentBudget, false);
+    }
+}
+
+// Caller holds the block's lock and it is resident. Returns false if the block
+// was pinned for writing while it was being compressed, in which case it stays dirty.
+bool SequenceData::CompressBlock(FrameBlock& b) const
+{
+    thread_local std::vector<uint8_t> scratch;
+
+    if (b.pins != 0) {
+        return false;
+    }
+    // cleared before reading so a writer that pins during the compress re-marks it
+    b.dirty = false;
+    const size_t bytes = (size_t)b.numFrames * _bytesPerFrame;
+    scratch.resize(ZSTD_compressBound(bytes));
+    size_t r = ZSTD_compress(scratch.data(), scratch.size(), b.data, bytes, BLOCK_COMPRESSION_LEVEL);
+    if (ZSTD_isError(r)) {
+        spdlog::error("Failed to compress frame data block at frame {}: {}", b.firstFrame, ZSTD_getErrorName(r));
+        b.dirty = true;
+        return false;
+    }
+    b.compressed.assign(scratch.begin(), scratch.begin() + r);
+    return !b.dirty;
+}
+
+// Caller holds the block's lock and it is resident.
+bool SequenceData::EvictBlock(FrameBlock& b) const
+{
+    if (b.pins != 0) {
+        return false;
+    }
+    if (b.dirty && !CompressBlock(b)) {
+        return false;
+    }
+    // Pin adds the pin then reads state, this stores state then reads the
+    // pins, so either the pin sees EVICTING and waits on the lock in
+    // LoadBlock or this sees the pin and backs out.
+    b.state = BlockState::EVICTING;
+    if (b.pins != 0 || b.dirty) {
+        b.state = BlockState::RESIDENT;
+        return false;
+    }
+    for (unsigned int f = 0; f < b.numFrames; ++f) {
+        _frames[b.firstFrame + f]._data = nullptr;
+    }
+    free(b.data);
+    b.data = nullptr;
+    _residentBytes -= (size_t)b.numFrames * _bytesPerFrame;
+    b.state = BlockState::COMPRESSED;
+    return true;
+}
+
+void SequenceData::TrimBlocks(size_t target, bool compressIdle) const
+{
+    // one thread trimming at a time is plenty, the others just carry on
+    std::unique_lock<std::mutex> lock(_evictLock, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return;
+    }
+
+    if (compressIdle) {
+        for (unsigned int i = 0; i < _numBlocks; ++i) {
+            FrameBlock& b = _blocks[i];
+            if (b.state != BlockState::RESIDENT || !b.dirty || b.pins != 0 || AccessClock() - b.lastUse < BLOCK_IDLE_MS) {
+                continue;
+            }
+            std::unique_lock<std::mutex> bl(b.lock, std::try_to_lock);
+            if (bl.owns_lock() && b.state == BlockState::RESIDENT) {
+                CompressBlock(b);
+            }
+        }
+    }
+
+    // least recently used first, skipping blocks that are pinned or that were
+    // pinned again between being picked and being evicted
+    std::vector<FrameBlock*> candidates;
+    for (unsigned int i = 0; i < _numBlocks; ++i) {
+        if (_blocks[i].state == BlockState::RESIDENT && _blocks[i].pins == 0) {
+            candidates.push_back(&_blocks[i]);
+        }
+    }
+    const uint32_t now = AccessClock();
+    std::sort(candidates.begin(), candidates.end(), [now](const FrameBlock* a, const FrameBlock* b) {
+        return now - a->lastUse > now - b->lastUse;
+    });
+    for (FrameBlock* victim : candidates) {
+        if (_residentBytes <= target) {
+            break;
+        }
+        std::unique_lock<std::mutex> bl(victim->lock);
+        if (victim->state == BlockState::RESIDENT) {
+            EvictBlock(*victim);
+        }
+    }
+    // anything still over budget is pinned, it is trimmed once it is released
+}
+
+void SequenceData::CompressIdleBlocks() const
+{
+    if (_blocks == nullptr) {
+        return;
+    }
+    TrimBlocks(_residentBudget, true);
+}
 
 // This encodes the sequence data grouped by channel
 std::string SequenceData::base64_encode()
@@ -388,7 +588,7 @@ std::string SequenceData::base64_encode()
     data.reserve(NumChannels() * NumFrames());
     for (size_t channel = 0; channel < NumChannels(); channel++) {
         for (size_t frame = 0; frame < NumFrames(); frame++) {
-            data.push_back((*this)[frame][channel]);
+            data.push_back(*Read(frame)[channel]);
             }
         }
     return Base64::Encode(data.data(), data.size());
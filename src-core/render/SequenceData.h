@@ -10,7 +10,10 @@
  * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cstdint>
 #include <cstring>
 #include <list>
 #include <memory>
@@ -88,10 +91,86 @@ public:
     };
 #ifdef USE_MMAP_BLOCKS
     static std::list<std::unique_ptr<DataBlock>> HUGE_BLOCK_CACHE;
-#endif    
+#endif
+
+    // Compressed storage: consecutive frames are grouped into blocks that are
+    // held zstd compressed and decompressed into memory when a frame in them is
+    // accessed. Resident blocks are evicted least recently used first once they
+    // exceed the budget, compressing them again if they were written to. A block
+    // is never compressed or evicted while a FrameRef into it is alive.
+    enum class BlockState : uint8_t {
+        COMPRESSED,
+        RESIDENT,
+        EVICTING
+    };
+    class FrameBlock {
+    public:
+        std::mutex lock;
+        std::atomic<BlockState> state = BlockState::COMPRESSED;
+        std::atomic<uint32_t> pins = 0;    // live FrameRefs into the block
+        std::atomic<uint32_t> lastUse = 0; // AccessClock() of the last access
+        std::atomic<bool> dirty = false;   // written to since it was last compressed
+        unsigned char* data = nullptr;     // the frames while resident
+        std::vector<uint8_t> compressed;   // empty until the block is first compressed, which means all zero
+        unsigned int firstFrame = 0;
+        unsigned int numFrames = 0;
+    };
+
+    // Handle to a frame that keeps its block resident for as long as it is
+    // alive. The temporary returned by operator[] lives to the end of the full
+    // expression, so &seqData[frame][0] passed to a call is safe; to use the
+    // data beyond that, hold on to the handle itself.
+    template<bool WRITE>
+    class FrameRefT {
+        const SequenceData* _seq;
+        FrameBlock* _block;
+        FrameData* _frame;
+        friend class SequenceData;
+
+        FrameRefT(const SequenceData* s, FrameBlock* b, FrameData* f) : _seq(s), _block(b), _frame(f) {
+            if (_block != nullptr) {
+                _seq->Pin(*_block, WRITE);
+            }
+        }
+        FrameRefT(const FrameRefT&) = delete;
+        FrameRefT& operator=(const FrameRefT&) = delete;
+
+    public:
+        FrameRefT(FrameRefT&& r) noexcept : _seq(r._seq), _block(r._block), _frame(r._frame) {
+            r._block = nullptr;
+        }
+        ~FrameRefT() {
+            if (_block != nullptr) {
+                _seq->Unpin(*_block, WRITE);
+            }
+        }
+
+        void Zero() requires WRITE {
+            _frame->Zero();
+        }
+        void Zero(unsigned int start, unsigned int count) requires WRITE {
+            _frame->Zero(start, count);
+        }
+        [[nodiscard]] unsigned char& operator[](unsigned int channel) requires WRITE {
+            return (*_frame)[channel];
+        }
+        [[nodiscard]] const unsigned char* operator[](unsigned int channel) const requires (!WRITE) {
+            return (*(const FrameData*)_frame)[channel];
+        }
+    };
+    using FrameRef = FrameRefT<true>;
+    using ConstFrameRef = FrameRefT<false>;
+
     FrameData _invalidFrame;
-    std::vector<FrameData> _frames;
+    mutable std::vector<FrameData> _frames;
     std::list<std::unique_ptr<DataBlock>> _dataBlocks;
+
+    FrameBlock* _blocks = nullptr;
+    unsigned int _numBlocks = 0;
+    unsigned int _framesPerBlock = 0;
+    size_t _residentBudget = 0;
+    mutable std::atomic<size_t> _residentBytes = 0;
+    mutable std::mutex _evictLock;
     
     unsigned int _bytesPerFrame;
     unsigned int _numChannels;
@@ -105,6 +184,54 @@ public:
     unsigned char *checkBlockPtr(unsigned char *block, size_t sizeRemaining);
     static unsigned char *AllocBlock(size_t requested, size_t &szAllocated, BlockType &bt, bool fileBacked = false);
     static bool ShouldUseFileBacked(size_t totalSize);
+    static bool ShouldUseCompressed(size_t totalSize);
+
+    void InitCompressed();
+    static uint32_t AccessClock() {
+        return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    // Every frame access pins, so a thread only reads the clock when it moves to
+    // another block and every PINS_PER_CLOCK pins while it stays in one.
+    static constexpr uint32_t PINS_PER_CLOCK = 32;
+    // The pin has to be visible before the state is read, which is what stops
+    // EvictBlock freeing a block someone is just starting to use.
+    void Pin(FrameBlock& b, bool write) const {
+        b.pins.fetch_add(1);
+        thread_local const FrameBlock* lastBlock = nullptr;
+        thread_local uint32_t pinsSinceClock = 0;
+        if (&b != lastBlock || ++pinsSinceClock >= PINS_PER_CLOCK) {
+            lastBlock = &b;
+            pinsSinceClock = 0;
+            uint32_t now = AccessClock();
+            if (b.lastUse.load(std::memory_order_relaxed) != now) {
+                b.lastUse.store(now, std::memory_order_relaxed);
+            }
+        }
+        if (write && !b.dirty.load(std::memory_order_relaxed)) {
+            b.dirty.store(true);
+        }
+        if (b.state.load() != BlockState::RESIDENT) {
+            try {
+                LoadBlock(b);
+            } catch (...) {
+                // the handle is never constructed so nothing would unpin it
+                b.pins.fetch_sub(1);
+                throw;
+            }
+        }
+    }
+    // Writes through the handle may have landed after a compress that started
+    // before the pin cleared dirty, so a writer marks the block again on release.
+    void Unpin(FrameBlock& b, bool write) const {
+        if (write) {
+            b.dirty.store(true);
+        }
+        b.pins.fetch_sub(1);
+    }
+    void LoadBlock(FrameBlock& b) const;
+    bool CompressBlock(FrameBlock& b) const;
+    bool EvictBlock(FrameBlock& b) const;
+    void TrimBlocks(size_t target, bool compressIdle) const;
 public:
     SequenceData();
     virtual ~SequenceData();
@@ -113,20 +240,35 @@ public:
     unsigned int TotalTime() const { return _numFrames * _frameTime; }
     bool OK(unsigned int frame, unsigned int channel) const { return frame < _numFrames && channel < _numChannels; }
     
-    [[nodiscard]] FrameData& operator[](unsigned int frame)
+    [[nodiscard]] FrameRef operator[](unsigned int frame)
     {
         if (frame >= _numFrames) {
-            return _invalidFrame;
+            return FrameRef(this, nullptr, &_invalidFrame);
         }
-        return _frames[frame];
+        return FrameRef(this, _blocks != nullptr ? &_blocks[frame / _framesPerBlock] : nullptr, &_frames[frame]);
+    }
+    [[nodiscard]] ConstFrameRef operator[](unsigned int frame) const
+    {
+        return Read(frame);
     }
-    [[nodiscard]] const FrameData& operator[](unsigned int frame) const
+    // Read only access from a non-const SequenceData. Playback and output use
+    // this so that looking at a frame does not mark its block for recompressing.
+    [[nodiscard]] ConstFrameRef Read(unsigned int frame) const
     {
         if (frame >= _numFrames) {
-            return _invalidFrame;
+            return ConstFrameRef(this, nullptr, const_cast<FrameData*>(&_invalidFrame));
         }
-        return _frames[frame];
+        return ConstFrameRef(this, _blocks != nullptr ? &_blocks[frame / _framesPerBlock] : nullptr, &_frames[frame]);
+    }
+
+    [[nodiscard]] bool IsCompressed() const
+    {
+        return _blocks != nullptr;
     }
+    // Compresses blocks that were written to but have since gone idle and
+    // evicts down to the resident budget. Called as rows finish rendering so
+    // the work is done behind the render rather than when a block is next needed.
+    void CompressIdleBlocks() const;
     
     [[nodiscard]] unsigned int NumChannels() const
     {
@@ -142,7 +284,7 @@ public:
     }
     [[nodiscard]] bool IsValidData() const
     {
-        return !_dataBlocks.empty();
+        return !_dataBlocks.empty() || _blocks != nullptr;
     }
 
     // encodes contents of SeqData in channel order
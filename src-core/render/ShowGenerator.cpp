@@ -0,0 +1,622 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "ShowGenerator.h"
+#include "xLightsVersion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+
+#include <spdlog/fmt/fmt.h>
+
+#include <log.h>
+
+// space between models in the layout
+#define SHOWGEN_SPACING 120.0f
+
+namespace
+{
+    // An int slider (hi >= lo) or a choice (choices not empty) effect setting
+    struct EffectParam {
+        const char* key;
+        int lo;
+        int hi;
+        std::vector<const char*> choices;
+    };
+
+    struct EffectTemplate {
+        const char* name;
+        std::vector<EffectParam> params;
+    };
+
+    // Effects that render from their settings alone ... no files, media or models
+    // of a particular shape needed
+    const std::vector<EffectTemplate>& EffectTemplates() {
+        static const std::vector<EffectTemplate> templates = {
+            { "On", {} },
+            { "Color Wash", { { "E_CHECKBOX_ColorWash_HFade", 0, 1, {} }, { "E_CHECKBOX_ColorWash_VFade", 0, 1, {} } } },
+            { "Bars", { { "E_SLIDER_Bars_BarCount", 1, 5, {} }, { "E_CHOICE_Bars_Direction", 0, 0, { "up", "down", "expand", "compress", "Left", "Right" } } } },
+            { "Butterfly", { { "E_SLIDER_Butterfly_Style", 1, 10, {} }, { "E_SLIDER_Butterfly_Chunks", 1, 10, {} }, { "E_CHOICE_Butterfly_Colors", 0, 0, { "Rainbow", "Palette" } } } },
+            { "Spirals", { { "E_SLIDER_Spirals_Count", 1, 5, {} }, { "E_SLIDER_Spirals_Thickness", 0, 100, {} } } },
+            { "Twinkle", { { "E_SLIDER_Twinkle_Count", 2, 100, {} }, { "E_SLIDER_Twinkle_Steps", 2, 400, {} } } },
+            { "Plasma", { { "E_SLIDER_Plasma_Style", 1, 10, {} }, { "E_SLIDER_Plasma_Line_Density", 1, 10, {} }, { "E_SLIDER_Plasma_Speed", 0, 100, {} } } },
+            { "Pinwheel", { { "E_SLIDER_Pinwheel_Arms", 1, 20, {} }, { "E_SLIDER_Pinwheel_Twist", -360, 360, {} }, { "E_SLIDER_Pinwheel_Thickness", 0, 100, {} } } },
+            { "Meteors", { { "E_SLIDER_Meteors_Count", 1, 100, {} }, { "E_SLIDER_Meteors_Length", 1, 100, {} }, { "E_CHOICE_Meteors_Effect", 0, 0, { "Down", "Up", "Left", "Right", "Implode", "Explode" } } } },
+            { "Fire", { { "E_SLIDER_Fire_Height", 1, 100, {} }, { "E_SLIDER_Fire_HueShift", 0, 100, {} } } },
+            { "Shockwave", { { "E_SLIDER_Shockwave_CenterX", 0, 100, {} }, { "E_SLIDER_Shockwave_CenterY", 0, 100, {} }, { "E_SLIDER_Shockwave_End_Radius", 0, 750, {} } } },
+            { "Curtain", { { "E_CHOICE_Curtain_Edge", 0, 0, { "left", "center", "right", "bottom", "middle", "top" } }, { "E_CHOICE_Curtain_Effect", 0, 0, { "open", "close", "open then close", "close then open" } }, { "E_SLIDER_Curtain_Swag", 0, 10, {} } } },
+            { "Marquee", { { "E_SLIDER_Marquee_Band_Size", 1, 100, {} }, { "E_SLIDER_Marquee_Skip_Size", 0, 100, {} } } },
+            { "Snowflakes", { { "E_SLIDER_Snowflakes_Count", 1, 100, {} }, { "E_SLIDER_Snowflakes_Type", 0, 9, {} }, { "E_SLIDER_Snowflakes_Speed", 0, 50, {} } } },
+            { "Galaxy", { { "E_SLIDER_Galaxy_CenterX", 0, 100, {} }, { "E_SLIDER_Galaxy_CenterY", 0, 100, {} }, { "E_SLIDER_Galaxy_Start_Width", 0, 255, {} } } },
+            { "Wave", { { "E_CHOICE_Wave_Type", 0, 0, { "Sine", "Triangle", "Square" } } } }
+        };
+        return templates;
+    }
+
+    const EffectTemplate* FindTemplate(const std::string& name) {
+        for (const auto& t : EffectTemplates()) {
+            if (name == t.name) return &t;
+        }
+        return nullptr;
+    }
+
+    bool SaveDocument(pugi::xml_document& doc, const std::string& file) {
+        if (!doc.save_file(file.c_str(), "  ")) {
+            spdlog::error("ShowGenerator: Unable to write '{}'.", file);
+            return false;
+        }
+        return true;
+    }
+}
+
+#pragma region Constructors and Destructors
+ShowGenerator::ShowGenerator(const ShowGeneratorOptions& options) :
+    _options(options), _rng(options.seed) {
+
+    _options.frameMS = std::max(_options.frameMS, 1);
+    _options.durationMS = std::max(_options.durationMS, _options.frameMS);
+    _options.layers = std::max(_options.layers, 1);
+    _options.effectMS = std::max(_options.effectMS, _options.frameMS);
+    _options.densityPercent = std::clamp(_options.densityPercent, 1, 100);
+    _options.channelsPerUniverse = std::clamp(_options.channelsPerUniverse, 3, 512);
+    _options.universesPerController = std::max(_options.universesPerController, 1);
+    _options.polyLinePoints = std::max(_options.polyLinePoints, 2);
+
+    _effectMix = _options.effectMix;
+    if (_effectMix.empty()) {
+        for (const auto& t : EffectTemplates()) {
+            _effectMix.push_back({ t.name, 1 });
+        }
+    }
+    for (const auto& it : _effectMix) {
+        if (FindTemplate(it.first) == nullptr) {
+            spdlog::warn("ShowGenerator: Effect '{}' is not one the generator knows, it will be added with default settings.", it.first);
+        }
+        _effectWeight += std::max(it.second, 0);
+    }
+}
+#pragma endregion
+
+#pragma region Static Functions
+std::vector<std::pair<std::string, int>> ShowGenerator::ParseEffectMix(const std::string& mix) {
+
+    std::vector<std::pair<std::string, int>> res;
+    size_t start = 0;
+    while (start <= mix.size()) {
+        size_t end = mix.find(',', start);
+        if (end == std::string::npos) end = mix.size();
+        std::string item = mix.substr(start, end - start);
+        start = end + 1;
+
+        int weight = 1;
+        auto colon = item.rfind(':');
+        if (colon != std::string::npos) {
+            weight = (int)std::strtol(item.c_str() + colon + 1, nullptr, 10);
+            item = item.substr(0, colon);
+        }
+        while (!item.empty() && item.front() == ' ') item.erase(item.begin());
+        while (!item.empty() && item.back() == ' ') item.pop_back();
+        if (!item.empty() && weight > 0) {
+            res.push_back({ item, weight });
+        }
+    }
+    return res;
+}
+
+std::vector<std::string> ShowGenerator::GetKnownEffects() {
+
+    std::vector<std::string> res;
+    for (const auto& t : EffectTemplates()) {
+        res.push_back(t.name);
+    }
+    return res;
+}
+#pragma endregion
+
+#pragma region Generate
+bool ShowGenerator::Generate(const std::string& showDir) {
+
+    std::error_code ec;
+    std::filesystem::create_directories(showDir, ec);
+    if (!std::filesystem::is_directory(showDir, ec)) {
+        spdlog::error("ShowGenerator: Unable to create show folder '{}'.", showDir);
+        return false;
+    }
+
+    // reseed so calling Generate twice gives the same show
+    _rng.seed(_options.seed);
+    _sequenceFiles.clear();
+    _effects = 0;
+
+    BuildModels();
+
+    auto const dir = std::filesystem::path(showDir);
+    if (!WriteNetworks((dir / "xlights_networks.xml").string())) return false;
+    if (!WriteRGBEffects((dir / "xlights_rgbeffects.xml").string())) return false;
+
+    for (int i = 0; i < _options.sequences; i++) {
+        std::string const file = (dir / fmt::format("Synthetic_{}.xsq", i + 1)).string();
+        if (!WriteSequence(file)) return false;
+        _sequenceFiles.push_back(file);
+    }
+
+    spdlog::info("ShowGenerator: Wrote {} models, {} nodes, {} channels over {} universes and {} effects in {} sequences to {}.",
+        _models.size(), _nodes, GetChannelCount(), _universes, _effects, _sequenceFiles.size(), showDir);
+    return true;
+}
+
+int ShowGenerator::Random(int lo, int hi) {
+
+    if (hi <= lo) return lo;
+    return lo + (int)(((uint64_t)_rng() * (uint64_t)(hi - lo + 1)) >> 32);
+}
+
+void ShowGenerator::BuildModels() {
+
+    _models.clear();
+    _groups.clear();
+    _nodes = 0;
+
+    auto add = [this](const std::string& prefix, int count, const std::string& type, int strings, int nodesPerString) {
+        for (int i = 0; i < count; i++) {
+            GeneratedModel m;
+            m.name = fmt::format("{} {}", prefix, i + 1);
+            m.type = type;
+            m.strings = std::max(strings, 1);
+            m.nodesPerString = std::max(nodesPerString, 1);
+            m.nodes = m.strings * m.nodesPerString;
+            _models.push_back(m);
+        }
+    };
+    add("Matrix", _options.matrices, "Matrix", _options.matrixStrings, _options.matrixNodesPerString);
+    add("Tree", _options.trees, "Tree", _options.treeStrings, _options.treeNodesPerString);
+    add("PolyLine", _options.polyLines, "Poly Line", 1, _options.polyLineNodes);
+    for (int i = 0; i < _options.customs; i++) {
+        GeneratedModel m;
+        m.name = fmt::format("Custom {}", i + 1);
+        m.type = "Custom";
+        m.width = std::max(_options.customWidth, 1);
+        m.height = std::max(_options.customHeight, 1);
+        _models.push_back(m);
+    }
+
+    // lay the models out on a square grid and give them consecutive channels
+    int const columns = std::max(1, (int)std::ceil(std::sqrt((double)_models.size())));
+    uint64_t channel = 1;
+    for (size_t i = 0; i < _models.size(); i++) {
+        auto& m = _models[i];
+        m.x = (float)(i % columns) * SHOWGEN_SPACING;
+        m.y = (float)(i / columns) * SHOWGEN_SPACING;
+        if (m.type == "Custom") {
+            m.customData = CustomModelData(m.width, m.height, m.nodes);
+        }
+        m.startChannel = channel;
+        channel += (uint64_t)m.nodes * 3;
+        _nodes += m.nodes;
+
+        int const parts = std::min(_options.subModelsPerModel, m.nodes);
+        for (int p = 0; p < parts; p++) {
+            m.subModels.push_back(fmt::format("Part {}", p + 1));
+        }
+    }
+
+    if (!_models.empty()) {
+        std::vector<std::string> all;
+        for (const auto& m : _models) {
+            all.push_back(m.name);
+        }
+        _groups.push_back({ "All Models", all });
+
+        int const size = std::clamp(_options.groupSize, 1, (int)_models.size());
+        for (int g = 0; g < _options.groups; g++) {
+            // partial Fisher-Yates on our own generator to pick distinct members
+            std::vector<size_t> order(_models.size());
+            for (size_t i = 0; i < order.size(); i++) order[i] = i;
+            std::vector<std::string> members;
+            for (int i = 0; i < size; i++) {
+                int const j = Random(i, (int)order.size() - 1);
+                std::swap(order[i], order[j]);
+                members.push_back(_models[order[i]].name);
+            }
+            _groups.push_back({ fmt::format("Group {}", g + 1), members });
+        }
+    }
+
+    uint64_t const universeSize = (uint64_t)_options.channelsPerUniverse;
+    _universes = (int)((GetChannelCount() + universeSize - 1) / universeSize);
+}
+#pragma endregion
+
+#pragma region Networks
+bool ShowGenerator::WriteNetworks(const std::string& file) {
+
+    pugi::xml_document doc;
+    auto decl = doc.prepend_child(pugi::node_declaration);
+    decl.append_attribute("version") = "1.0";
+    decl.append_attribute("encoding") = "UTF-8";
+
+    auto root = doc.append_child("Networks");
+    root.append_attribute("computer") = "ShowGenerator";
+
+    std::string protocol = _options.protocol;
+    if (protocol != "ArtNet" && protocol != "DDP") protocol = "E131";
+
+    int const controllers = (_universes + _options.universesPerController - 1) / _options.universesPerController;
+    int universe = protocol == "ArtNet" ? 0 : 1;
+    int remaining = _universes;
+    for (int c = 0; c < controllers; c++) {
+        std::string const ip = fmt::format("10.{}.{}.{}", 100 + c / (254 * 256), (c / 254) % 256, c % 254 + 1);
+        int const count = std::min(remaining, _options.universesPerController);
+        remaining -= count;
+
+        auto node = root.append_child("Controller");
+        node.append_attribute("Id") = 64001 + c;
+        node.append_attribute("Name") = fmt::format("Controller {}", c + 1).c_str();
+        node.append_attribute("Description") = "";
+        node.append_attribute("Type") = "Ethernet";
+        node.append_attribute("Vendor") = "";
+        node.append_attribute("Model") = "";
+        node.append_attribute("Variant") = "";
+        node.append_attribute("AutoSize") = "0";
+        node.append_attribute("FromBase") = "0";
+        node.append_attribute("ActiveState") = "Active";
+        node.append_attribute("AutoLayout") = "0";
+        node.append_attribute("AutoUpload") = "0";
+        node.append_attribute("SuppressDuplicates") = "0";
+        node.append_attribute("Monitor") = "1";
+
+        if (protocol == "DDP") {
+            auto n = node.append_child("network");
+            n.append_attribute("ChannelsPerPacket") = 1440;
+            n.append_attribute("KeepChannelNumbers") = "1";
+            n.append_attribute("ComPort") = ip.c_str();
+            n.append_attribute("BaudRate") = 64001 + c;
+            n.append_attribute("NetworkType") = protocol.c_str();
+            n.append_attribute("MaxChannels") = count * _options.channelsPerUniverse;
+            n.append_attribute("Enabled") = "Yes";
+        } else {
+            for (int u = 0; u < count; u++) {
+                auto n = node.append_child("network");
+                n.append_attribute("ComPort") = ip.c_str();
+                n.append_attribute("BaudRate") = universe++;
+                n.append_attribute("NetworkType") = protocol.c_str();
+                n.append_attribute("MaxChannels") = _options.channelsPerUniverse;
+                n.append_attribute("Enabled") = "Yes";
+            }
+        }
+
+        node.append_attribute("IP") = ip.c_str();
+        node.append_attribute("Protocol") = protocol.c_str();
+        node.append_attribute("FPPProxy") = "";
+        node.append_attribute("Priority") = 100;
+        node.append_attribute("Version") = 1;
+        node.append_attribute("Expanded") = "FALSE";
+        node.append_attribute("UPS") = "FALSE";
+        node.append_attribute("ForceLocalIP") = "";
+    }
+
+    return SaveDocument(doc, file);
+}
+#pragma endregion
+
+#pragma region Models
+std::string ShowGenerator::CustomModelData(int width, int height, int& nodes) {
+
+    // rows separated by ';' and cells by ',' holding the node number or nothing
+    std::string data;
+    data.reserve((size_t)width * height * 4);
+    nodes = 0;
+    for (int r = 0; r < height; r++) {
+        if (r != 0) data += ';';
+        for (int c = 0; c < width; c++) {
+            if (c != 0) data += ',';
+            if (Random(1, 100) <= _options.customFillPercent) {
+                data += std::to_string(++nodes);
+            }
+        }
+    }
+    if (nodes == 0) {
+        // a model needs at least one node
+        data = "1" + data;
+        nodes = 1;
+    }
+    return data;
+}
+
+void ShowGenerator::AddModelNode(pugi::xml_node models, const GeneratedModel& m) {
+
+    auto node = models.append_child("model");
+    node.append_attribute("name") = m.name.c_str();
+    node.append_attribute("DisplayAs") = m.type.c_str();
+    node.append_attribute("LayoutGroup") = "Default";
+    node.append_attribute("StringType") = "RGB Nodes";
+    node.append_attribute("StartSide") = "B";
+    node.append_attribute("Dir") = "L";
+    node.append_attribute("Antialias") = "1";
+    node.append_attribute("PixelSize") = "2";
+    node.append_attribute("Transparency") = "0";
+    node.append_attribute("StartChannel") = std::to_string(m.startChannel).c_str();
+    node.append_attribute("WorldPosX") = fmt::format("{:f}", m.x).c_str();
+    node.append_attribute("WorldPosY") = fmt::format("{:f}", m.y).c_str();
+    node.append_attribute("WorldPosZ") = "0.000000";
+
+    if (m.type == "Poly Line") {
+        node.append_attribute("ScaleX") = "100.000000";
+        node.append_attribute("ScaleY") = "100.000000";
+        node.append_attribute("ScaleZ") = "100.000000";
+        node.append_attribute("NodesPerString") = m.nodes;
+        node.append_attribute("LightsPerNode") = 1;
+        node.append_attribute("PolyStrings") = 1;
+        // a zig zag across the model's cell
+        std::string points;
+        for (int p = 0; p < _options.polyLinePoints; p++) {
+            float const x = -0.5f + (float)p / (float)(_options.polyLinePoints - 1);
+            float const y = (float)Random(-40, 40) / 100.0f;
+            if (p != 0) points += ',';
+            points += fmt::format("{:f},{:f},{:f}", x, y, 0.0f);
+        }
+        node.append_attribute("NumPoints") = _options.polyLinePoints;
+        node.append_attribute("PointData") = points.c_str();
+        node.append_attribute("cPointData") = "";
+    } else {
+        node.append_attribute("ScaleX") = "1.000000";
+        node.append_attribute("ScaleY") = "1.000000";
+        node.append_attribute("ScaleZ") = "1.000000";
+        node.append_attribute("RotateX") = "0.000000";
+        node.append_attribute("RotateY") = "0.000000";
+        node.append_attribute("RotateZ") = "0.000000";
+        if (m.type == "Custom") {
+            node.append_attribute("CustomWidth") = m.width;
+            node.append_attribute("CustomHeight") = m.height;
+            node.append_attribute("CustomModel") = m.customData.c_str();
+        } else {
+            node.append_attribute("NumStrings") = m.strings;
+            node.append_attribute("NodesPerString") = m.nodesPerString;
+            node.append_attribute("StrandsPerString") = 1;
+            if (m.type == "Tree") {
+                node.append_attribute("TreeType") = 0;
+                node.append_attribute("TreeDegrees") = 360;
+            }
+        }
+    }
+
+    // contiguous node ranges
+    int const parts = (int)m.subModels.size();
+    for (int p = 0; p < parts; p++) {
+        int const first = 1 + (int)((int64_t)m.nodes * p / parts);
+        int const last = (int)((int64_t)m.nodes * (p + 1) / parts);
+        auto sm = node.append_child("subModel");
+        sm.append_attribute("name") = m.subModels[p].c_str();
+        sm.append_attribute("layout") = "horizontal";
+        sm.append_attribute("type") = "ranges";
+        sm.append_attribute("bufferstyle") = "Default";
+        sm.append_attribute("line0") = (first == last ? std::to_string(first) : fmt::format("{}-{}", first, last)).c_str();
+    }
+}
+
+bool ShowGenerator::WriteRGBEffects(const std::string& file) {
+
+    pugi::xml_document doc;
+    auto decl = doc.prepend_child(pugi::node_declaration);
+    decl.append_attribute("version") = "1.0";
+    decl.append_attribute("encoding") = "UTF-8";
+
+    auto root = doc.append_child("xrgb");
+    auto models = root.append_child("models");
+    for (const auto& m : _models) {
+        AddModelNode(models, m);
+    }
+
+    auto groups = root.append_child("modelGroups");
+    for (const auto& g : _groups) {
+        std::string members;
+        for (const auto& it : g.second) {
+            if (!members.empty()) members += ',';
+            members += it;
+        }
+        auto node = groups.append_child("modelGroup");
+        node.append_attribute("name") = g.first.c_str();
+        node.append_attribute("selected") = "0";
+        node.append_attribute("layout") = "minimalGrid";
+        node.append_attribute("GridSize") = 400;
+        node.append_attribute("LayoutGroup") = "Default";
+        node.append_attribute("models") = members.c_str();
+    }
+
+    root.append_child("view_objects");
+    root.append_child("effects");
+    root.append_child("views");
+    root.append_child("palettes");
+    auto settings = root.append_child("settings");
+    auto w = settings.append_child("previewWidth");
+    w.append_attribute("value") = "1280";
+    auto h = settings.append_child("previewHeight");
+    h.append_attribute("value") = "720";
+
+    return SaveDocument(doc, file);
+}
+#pragma endregion
+
+#pragma region Sequence
+std::string ShowGenerator::Palette() {
+
+    static const char* colours[] = { "#FF0000", "#00FF00", "#0000FF", "#FFFF00", "#FF00FF", "#00FFFF", "#FFFFFF", "#FF8000" };
+
+    int const active = Random(1, 4);
+    std::string res;
+    for (int i = 1; i <= 8; i++) {
+        if (!res.empty()) res += ',';
+        res += fmt::format("C_BUTTON_Palette{}={}", i, colours[Random(0, 7)]);
+        if (i <= active) {
+            res += fmt::format(",C_CHECKBOX_Palette{}=1", i);
+        }
+    }
+    return res;
+}
+
+std::string ShowGenerator::EffectSettings(const std::string& effect) {
+
+    std::string res;
+    auto t = FindTemplate(effect);
+    if (t == nullptr) return res;
+    for (const auto& p : t->params) {
+        if (!res.empty()) res += ',';
+        if (!p.choices.empty()) {
+            res += fmt::format("{}={}", p.key, p.choices[Random(0, (int)p.choices.size() - 1)]);
+        } else {
+            res += fmt::format("{}={}", p.key, Random(p.lo, p.hi));
+        }
+    }
+    return res;
+}
+
+void ShowGenerator::AddEffects(pugi::xml_node layer, SequenceTables& tables) {
+
+    auto const round = [this](int ms) {
+        return std::max(_options.frameMS, ms / _options.frameMS * _options.frameMS);
+    };
+
+    int t = 0;
+    while (t < _options.durationMS) {
+        int const length = round(Random(_options.effectMS / 2, _options.effectMS * 3 / 2));
+        int const meanGap = length * (100 - _options.densityPercent) / _options.densityPercent;
+        int const gap = meanGap == 0 ? 0 : Random(0, meanGap * 2) / _options.frameMS * _options.frameMS;
+        int const start = t + gap;
+        int const end = std::min(start + length, _options.durationMS);
+        if (start >= end) break;
+
+        // pick from the weighted mix
+        std::string name = _effectMix.front().first;
+        int w = Random(1, std::max(_effectWeight, 1));
+        for (const auto& it : _effectMix) {
+            w -= std::max(it.second, 0);
+            if (w <= 0) {
+                name = it.first;
+                break;
+            }
+        }
+
+        std::string const settings = EffectSettings(name);
+        auto ref = tables.effectStrings.find(settings);
+        if (ref == tables.effectStrings.end()) {
+            ref = tables.effectStrings.emplace(settings, (int)tables.effectStrings.size()).first;
+            tables.effectDB.append_child("Effect").text().set(settings.c_str());
+        }
+        std::string const palette = tables.palettes[Random(0, (int)tables.palettes.size() - 1)];
+        auto pal = tables.paletteRefs.find(palette);
+        if (pal == tables.paletteRefs.end()) {
+            pal = tables.paletteRefs.emplace(palette, (int)tables.paletteRefs.size()).first;
+            tables.colorPalettes.append_child("ColorPalette").text().set(palette.c_str());
+        }
+
+        auto e = layer.append_child("Effect");
+        e.append_attribute("ref") = ref->second;
+        e.append_attribute("name") = name.c_str();
+        e.append_attribute("startTime") = start;
+        e.append_attribute("endTime") = end;
+        e.append_attribute("palette") = pal->second;
+        _effects++;
+
+        t = end;
+    }
+}
+
+bool ShowGenerator::WriteSequence(const std::string& file) {
+
+    pugi::xml_document doc;
+    auto decl = doc.prepend_child(pugi::node_declaration);
+    decl.append_attribute("version") = "1.0";
+    decl.append_attribute("encoding") = "UTF-8";
+
+    auto root = doc.append_child("xsequence");
+    root.append_attribute("BaseChannel") = "0";
+    root.append_attribute("ChanCtrlBasic") = "0";
+    root.append_attribute("ChanCtrlColor") = "0";
+    root.append_attribute("FixedPointTiming") = "1";
+    root.append_attribute("ModelBlending") = "true";
+
+    auto head = root.append_child("head");
+    head.append_child("version").text().set(xlights_version_string.c_str());
+    head.append_child("author").text().set("ShowGenerator");
+    head.append_child("comment").text().set(fmt::format("Synthetic sequence, seed {}", _options.seed).c_str());
+    head.append_child("sequenceTiming").text().set(fmt::format("{} ms", _options.frameMS).c_str());
+    head.append_child("sequenceType").text().set("Animation");
+    head.append_child("mediaFile").text().set("");
+    head.append_child("sequenceDuration").text().set(fmt::format("{:.3f}", _options.durationMS / 1000.0).c_str());
+
+    // loading resolves effect and palette references in document order so
+    // these have to come before the effects
+    SequenceTables tables;
+    tables.colorPalettes = root.append_child("ColorPalettes");
+    tables.effectDB = root.append_child("EffectDB");
+    for (int i = 0; i < 32; i++) {
+        tables.palettes.push_back(Palette());
+    }
+    root.append_child("DataLayers");
+    auto display = root.append_child("DisplayElements");
+    auto elements = root.append_child("ElementEffects");
+
+    auto addElement = [&](const std::string& name, const std::vector<std::string>* subModels, bool effects) {
+        auto d = display.append_child("Element");
+        d.append_attribute("collapsed") = "0";
+        d.append_attribute("type") = "model";
+        d.append_attribute("name") = name.c_str();
+        d.append_attribute("visible") = "1";
+
+        auto e = elements.append_child("Element");
+        e.append_attribute("type") = "model";
+        e.append_attribute("name") = name.c_str();
+        for (int l = 0; l < _options.layers; l++) {
+            auto layer = e.append_child("EffectLayer");
+            if (effects) {
+                AddEffects(layer, tables);
+            }
+        }
+        if (subModels != nullptr) {
+            for (const auto& sm : *subModels) {
+                if (Random(1, 100) > _options.subModelEffectPercent) continue;
+                auto layer = e.append_child("SubModelEffectLayer");
+                layer.append_attribute("name") = sm.c_str();
+                AddEffects(layer, tables);
+            }
+        }
+    };
+
+    for (const auto& g : _groups) {
+        addElement(g.first, nullptr, _options.groupEffects);
+    }
+    for (const auto& m : _models) {
+        addElement(m.name, &m.subModels, true);
+    }
+
+    return SaveDocument(doc, file);
+}
+#pragma endregion
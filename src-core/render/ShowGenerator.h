@@ -0,0 +1,134 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <pugixml.hpp>
+
+struct ShowGeneratorOptions {
+    uint32_t seed = 1;
+
+    // models ... sizes are strings x nodes per string (custom is width x height)
+    int matrices = 4;
+    int matrixStrings = 32;
+    int matrixNodesPerString = 100;
+    int trees = 4;
+    int treeStrings = 16;
+    int treeNodesPerString = 100;
+    int customs = 8;
+    int customWidth = 40;
+    int customHeight = 30;
+    int customFillPercent = 60; // share of the custom grid that has a node
+    int polyLines = 16;
+    int polyLineNodes = 300;
+    int polyLinePoints = 4;
+    int subModelsPerModel = 2; // node range submodels added to every model
+    int groups = 4;            // random groups of groupSize models, plus one of everything
+    int groupSize = 8;
+
+    // outputs
+    std::string protocol = "E131"; // E131, ArtNet or DDP
+    int channelsPerUniverse = 510;
+    int universesPerController = 64;
+
+    // sequences
+    int sequences = 1;
+    int durationMS = 60000;
+    int frameMS = 50;
+    int layers = 2;                    // effect layers per element
+    int effectMS = 2000;               // mean effect length
+    int densityPercent = 80;           // share of each layer's timeline covered by effects
+    bool groupEffects = true;          // put effects on the groups as well as the models
+    int subModelEffectPercent = 25;    // chance a submodel gets its own effect layer
+    // effect name and relative weight, empty for an even mix of every effect the generator knows
+    std::vector<std::pair<std::string, int>> effectMix;
+};
+
+// Writes a synthetic but valid show folder ... xlights_networks.xml,
+// xlights_rgbeffects.xml and one or more .xsq sequences ... at whatever scale
+// is asked for so render, load and output performance can be measured on shows
+// no one could ship as test data. Output depends only on the options: the same
+// seed gives byte identical files on every platform.
+class ShowGenerator
+{
+public:
+    ShowGenerator(const ShowGeneratorOptions& options);
+
+    // Creates showDir if needed. Existing show files in it are overwritten.
+    bool Generate(const std::string& showDir);
+
+    // Parses "Bars:3,Butterfly,On:2" into an effect mix (weight defaults to 1)
+    static std::vector<std::pair<std::string, int>> ParseEffectMix(const std::string& mix);
+    static std::vector<std::string> GetKnownEffects();
+
+    const std::vector<std::string>& GetSequenceFiles() const { return _sequenceFiles; }
+    size_t GetModelCount() const { return _models.size(); }
+    uint64_t GetNodeCount() const { return _nodes; }
+    uint64_t GetChannelCount() const { return _nodes * 3; }
+    int GetUniverseCount() const { return _universes; }
+    uint64_t GetEffectCount() const { return _effects; }
+
+private:
+    struct GeneratedModel {
+        std::string name;
+        std::string type;
+        int nodes = 0;
+        int strings = 1;
+        int nodesPerString = 0;
+        int width = 0;
+        int height = 0;
+        uint64_t startChannel = 1;
+        float x = 0;
+        float y = 0;
+        std::string customData; // CustomModel attribute
+        std::vector<std::string> subModels;
+    };
+
+    // effect settings and palettes are written once per sequence and referenced by index
+    struct SequenceTables {
+        pugi::xml_node effectDB;
+        pugi::xml_node colorPalettes;
+        std::unordered_map<std::string, int> effectStrings;
+        std::unordered_map<std::string, int> paletteRefs;
+        std::vector<std::string> palettes; // pool effects draw from
+    };
+
+    void BuildModels();
+    bool WriteNetworks(const std::string& file);
+    bool WriteRGBEffects(const std::string& file);
+    bool WriteSequence(const std::string& file);
+
+    void AddModelNode(pugi::xml_node models, const GeneratedModel& m);
+    std::string CustomModelData(int width, int height, int& nodes);
+    void AddEffects(pugi::xml_node layer, SequenceTables& tables);
+    std::string EffectSettings(const std::string& effect);
+    std::string Palette();
+
+    // platform independent, unlike the std distributions
+    int Random(int lo, int hi);
+
+    ShowGeneratorOptions _options;
+    std::mt19937 _rng;
+    std::vector<GeneratedModel> _models;
+    std::vector<std::pair<std::string, std::vector<std::string>>> _groups;
+    std::vector<std::pair<std::string, int>> _effectMix;
+    int _effectWeight = 0;
+    std::vector<std::string> _sequenceFiles;
+    uint64_t _nodes = 0;
+    int _universes = 0;
+    uint64_t _effects = 0;
+};
@@ -232,6 +232,8 @@ void xLightsShowContext::EnsureSequenceDataSized() {
         spdlog::error("xLightsShowContext: could not abort in-flight render; skipping the seqData resize");
         return;
     }
+    // the output thread may be reading the old frames
+    _outputScheduler.ClearPlayPosition();
     _seqData.init(numChannels, numFrames, frameTime);
 }
 
@@ -245,6 +247,7 @@ bool xLightsShowContext::CloseSequence() {
         spdlog::error("xLightsShowContext: could not abort in-flight render; leaving the sequence data allocated rather than freeing it under a live render job");
         return false;
     }
+    _outputScheduler.ClearPlayPosition();
     _sequenceElements.Clear();
     _seqData.Cleanup();
     _sequenceDoc.reset();
@@ -12,6 +12,7 @@
 
 #include "render/RenderContext.h"
 #include "outputs/OutputManager.h"
+#include "outputs/OutputScheduler.h"
 #include "models/OutputModelManager.h"
 #include "models/ModelManager.h"
 #include "models/ViewObjectManager.h"
@@ -103,6 +104,10 @@ public:
     // The render engine's output buffer (frames × channels).
     SequenceData _seqData;
 
+    // Optional dedicated output thread. Declared after _seqData and _outputManager
+    // so it is stopped before either is destroyed.
+    OutputScheduler _outputScheduler{ &_outputManager };
+
     // 3D viewpoints/cameras (loaded from the show's <Viewpoints>), used by
     // "Per Preview" 3D effect rendering via GetNamedCamera3D.
     ViewpointMgr viewpoint_mgr;
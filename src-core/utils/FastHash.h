@@ -0,0 +1,62 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <cstdint>
+#include <cstring>
+
+// Non cryptographic content hash for spotting repeated channel data (duplicate
+// output frames, identical render cache frames). Not stable across versions
+// unless noted where it is stored.
+namespace FastHash {
+
+// Four lane 64 bit multiply/xorshift over 32 byte blocks, folded two different
+// ways. The lanes keep several multiplies in flight and let the compiler
+// vectorise the loop where the target can. The render cache stores these in
+// its packs so changing them costs sharing with frames already stored.
+inline void Hash128(const uint8_t* data, size_t length, uint64_t& hash1, uint64_t& hash2) {
+
+    constexpr uint64_t PRIME = 0x9E3779B97F4A7C15ULL;
+    constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+    uint64_t lanes[4] = { length, PRIME, ~PRIME, PRIME2 };
+
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        for (int l = 0; l < 4; ++l) {
+            uint64_t w;
+            memcpy(&w, data + i + l * 8, sizeof(w));
+            lanes[l] = (lanes[l] ^ w) * PRIME;
+            lanes[l] ^= lanes[l] >> 29;
+        }
+    }
+    for (int l = 0; i < length; ++i, l = (l + 1) & 3) {
+        lanes[l] = (lanes[l] ^ data[i]) * PRIME2;
+    }
+
+    auto rotl = [](uint64_t v, int r) { return (v << r) | (v >> (64 - r)); };
+    auto mix = [](uint64_t h, uint64_t m) {
+        h ^= h >> 32;
+        h *= m;
+        h ^= h >> 29;
+        return h;
+    };
+    hash1 = mix(lanes[0] ^ rotl(lanes[1], 17) ^ rotl(lanes[2], 31) ^ rotl(lanes[3], 47), PRIME);
+    hash2 = mix(rotl(lanes[0], 23) + lanes[1] * 3 + rotl(lanes[2], 7) * 5 + lanes[3] * 7, PRIME2);
+}
+
+inline uint64_t Hash64(const uint8_t* data, size_t length) {
+    uint64_t hash1;
+    uint64_t hash2;
+    Hash128(data, length, hash1, hash2);
+    return hash1;
+}
+
+} // namespace FastHash
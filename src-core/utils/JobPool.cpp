@@ -37,6 +37,7 @@
 #include <spdlog/fmt/std.h>
 #include "string_utils.h"
 
+#include "../utils/PerfTrace.h"
 #include "../utils/TraceLog.h"
 #include "../utils/xlExceptionDescribe.h"
 using namespace TraceLog;
@@ -53,10 +54,44 @@ const std::string Job::GetName() const {
 // this replaces could not name a Cocoa NSException, so a Metal/AVFoundation
 // raise on a render thread was logged as "non-std exception type".
 
+// One worker's deque.  A mutex per shard rather than a lock free deque: jobs
+// are coarse (a render job slice is a frame or more) so what matters is that
+// the workers no longer share one lock, and both owner and thieves take from
+// the front so each lane stays FIFO - render jobs are queued in dependency
+// order and running a downstream row first only parks it.  The sizes are
+// read without the lock to skip empty shards; the counters are per shard so
+// keeping them does not put a shared cache line back.
+struct alignas(64) JobQueueShard {
+    std::mutex lock;
+    std::deque<Job*> high;
+    std::deque<Job*> normal;
+    std::atomic_int highSize{ 0 };
+    std::atomic_int normalSize{ 0 };
+    int index = 0;
+    bool owned = false; // guarded by the pool's threadLock
+
+    std::atomic<uint64_t> pushed{ 0 };
+    std::atomic<uint64_t> popped{ 0 };
+    std::atomic<uint64_t> stolen{ 0 };
+    std::atomic<uint64_t> contended{ 0 };
+
+    void Lock() {
+        if (!lock.try_lock()) {
+            contended.fetch_add(1, std::memory_order_relaxed);
+            lock.lock();
+        }
+    }
+};
+
+// the shard of the pool worker running on this thread, if it is one
+static thread_local JobQueueShard* tlsShard = nullptr;
+static thread_local const JobPool* tlsPool = nullptr;
+
 
 class JobPoolWorker
 {
     JobPool *pool;
+    JobQueueShard *shard;
     std::atomic_bool stopped;
     std::atomic<Job  *> currentJob;
     enum STATUS_TYPE {
@@ -92,6 +127,7 @@ public:
     std::string GetStatus();
     
     std::string GetThreadName() const;
+    JobQueueShard *GetShard() const { return shard; }
 };
 
 static void startFunc(JobPoolWorker *jpw) {
@@ -115,7 +151,7 @@ static void startFunc(JobPoolWorker *jpw) {
 }
 
 JobPoolWorker::JobPoolWorker(JobPool *p) :
-    pool(p), stopped(false), currentJob(nullptr), status(STARTING), tid(0), m_logger(spdlog::get("job") ? spdlog::get("job") : spdlog::default_logger()) {
+    pool(p), shard(p->ClaimShard()), stopped(false), currentJob(nullptr), status(STARTING), tid(0), m_logger(spdlog::get("job") ? spdlog::get("job") : spdlog::default_logger()) {
 #ifdef __APPLE__
     pthread_attr_t attr;
     pthread_attr_init(&attr);
@@ -193,6 +229,7 @@ void JobPoolWorker::Stop()
     status = STOPPED;
     stopped = true;
 
+    std::unique_lock<std::mutex> lock(pool->idleLock);
     pool->signal.notify_all();
 }
 
@@ -280,11 +317,14 @@ void JobPoolWorker::Entry()
 
     try {
         SetThreadName(pool->threadNameBase);
+        PerfTrace::NameThread(pool->threadNameBase);
         SetThreadQOS(0);
+        tlsShard = shard;
+        tlsPool = pool;
         while ( !stopped ) {
             status = IDLE;
 
-            Job *job = pool->GetNextJob();
+            Job *job = pool->GetNextJob(shard);
             if (job != nullptr) {
                 m_logger->debug("JobPoolWorker::Entry processing job.   {}", fmt::ptr(this));
                 status = RUNNING_JOB;
@@ -370,11 +410,16 @@ void JobPoolWorker::ProcessJob(Job *job)
 	}
 }
 
-JobPool::JobPool(const std::string &n) : threadLock(), queueLock(), signal(), queue(), numThreads(0), idleThreads(0), threadNameBase(n), inFlight(0), maxNumThreads(8), minNumThreads(2)
+JobPool::JobPool(const std::string &n) : threadLock(), numShards(0), nextShard(0), highQueued(0), foregroundQueued(0), backgroundQueued(0), sleeps(0), numThreads(0), idleThreads(0), threadNameBase(n), inFlight(0), maxNumThreads(8), minNumThreads(2)
 {
+    // jobs pushed before the first worker exists need somewhere to go
+    shards[0] = new JobQueueShard();
+    numShards = 1;
 }
-JobPool::JobPool(const std::string &n, int min, int max) : threadLock(), queueLock(), signal(), queue(), numThreads(0), idleThreads(0), threadNameBase(n), inFlight(0), maxNumThreads(max), minNumThreads(min)
+JobPool::JobPool(const std::string &n, int min, int max) : threadLock(), numShards(0), nextShard(0), highQueued(0), foregroundQueued(0), backgroundQueued(0), sleeps(0), numThreads(0), idleThreads(0), threadNameBase(n), inFlight(0), maxNumThreads(max), minNumThreads(min)
 {
+    shards[0] = new JobQueueShard();
+    numShards = 1;
 }
 
 void JobPool::SetMaxThreadCount(int maxThreads)
@@ -386,19 +431,30 @@ void JobPool::SetMaxThreadCount(int maxThreads)
 JobPool::~JobPool()
 {
     //
-    if ( !queue.empty() || !highPriorityQueue.empty() ) {
-        for (auto* job : queue) {
-            delete job;
+    if ( foregroundQueued > 0 || !backgroundQueue.empty() ) {
+        for (int i = 0; i < numShards; i++) {
+            for (auto* job : shards[i]->high) {
+                delete job;
+            }
+            for (auto* job : shards[i]->normal) {
+                delete job;
+            }
+            shards[i]->high.clear();
+            shards[i]->normal.clear();
         }
-        for (auto* job : highPriorityQueue) {
+        for (auto* job : backgroundQueue) {
             delete job;
         }
         auto logger = spdlog::get("job") ? spdlog::get("job") : spdlog::default_logger();
         logger->debug("Clearing JobPool queue.");
-        queue.clear();
-        highPriorityQueue.clear();
+        backgroundQueue.clear();
+        foregroundQueued = 0;
     }
     Stop();
+    for (int i = 0; i < numShards; i++) {
+        delete shards[i];
+        shards[i] = nullptr;
+    }
 }
 
 void JobPool::LockThreads() {
@@ -410,58 +466,184 @@ void JobPool::UnlockThreads() {
     threadLock.unlock();
 }
 
+JobQueueShard *JobPool::ClaimShard() {
+    int count = numShards;
+    for (int i = 0; i < count; i++) {
+        if (!shards[i]->owned) {
+            shards[i]->owned = true;
+            return shards[i];
+        }
+    }
+    if (count < MAX_JOBPOOLSHARDS) {
+        JobQueueShard *shard = new JobQueueShard();
+        shard->index = count;
+        shard->owned = true;
+        shards[count] = shard;
+        numShards.store(count + 1, std::memory_order_release);
+        return shard;
+    }
+    // more workers than shards, double up
+    return shards[numThreads % MAX_JOBPOOLSHARDS];
+}
+
+void JobPool::ReleaseShard(JobQueueShard *shard) {
+    shard->owned = false;
+}
+
 void JobPool::RemoveWorker(JobPoolWorker *w) {
     LockThreads();
     auto loc = std::find(threads.begin(), threads.end(), w);
     if (loc != threads.end()) {
         threads.erase(loc);
     }
+    ReleaseShard(w->GetShard());
     UnlockThreads();
 }
 
-Job *JobPool::GetNextJob() {
-    std::unique_lock<std::mutex> mutLock(queueLock);
-    Job *req = nullptr;
-    if (queue.empty() && highPriorityQueue.empty()) {
-        SetThreadQOS(0);
+// Takes the front job of one lane of a shard, nullptr if there is none.
+Job *JobPool::TakeJob(JobQueueShard *shard, bool high, bool steal) {
+    std::atomic_int &size = high ? shard->highSize : shard->normalSize;
+    if (size.load(std::memory_order_relaxed) == 0) {
+        return nullptr;
+    }
+    shard->Lock();
+    std::deque<Job*> &lane = high ? shard->high : shard->normal;
+    Job *job = nullptr;
+    if (!lane.empty()) {
+        job = lane.front();
+        lane.pop_front();
+        --size;
+        (steal ? shard->stolen : shard->popped).fetch_add(1, std::memory_order_relaxed);
+    }
+    shard->lock.unlock();
+    if (job != nullptr) {
+        if (high) {
+            --highQueued;
+        }
+        --foregroundQueued;
+    }
+    return job;
+}
+
+Job *JobPool::TryGetJob(JobQueueShard *own) {
+    // Strict priority, deliberately no aging/fairness: interactive jobs may
+    // starve queued background rows, and the dirty-range machinery re-renders
+    // anything they invalidate.  Background (cache warming) jobs only get a
+    // thread nothing else wants.  Priority is per lane across every shard: a
+    // worker steals high priority work before it runs its own normal lane.
+    int const count = numShards.load(std::memory_order_acquire);
+    for (int pass = 0; pass < 2; pass++) {
+        bool const high = pass == 0;
+        if (high && highQueued <= 0) {
+            continue;
+        }
+        if (Job *job = TakeJob(own, high, false)) {
+            return job;
+        }
+        for (int i = 1; i < count; i++) {
+            JobQueueShard *victim = shards[(own->index + i) % count];
+            if (Job *job = TakeJob(victim, high, true)) {
+                return job;
+            }
+        }
+    }
+    if (backgroundQueued > 0) {
+        std::unique_lock<std::mutex> lock(backgroundLock);
+        if (!backgroundQueue.empty()) {
+            Job *job = backgroundQueue.front();
+            backgroundQueue.pop_front();
+            --backgroundQueued;
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+Job *JobPool::GetNextJob(JobQueueShard *own) {
+    Job *req = TryGetJob(own);
+    while (req == nullptr) {
+        std::unique_lock<std::mutex> lock(idleLock);
         ++idleThreads;
-        signal.wait_for(mutLock, std::chrono::milliseconds(30000));
+        // rechecked under idleLock, a push in between notifies after this
+        if (foregroundQueued <= 0 && backgroundQueued <= 0) {
+            SetThreadQOS(0);
+            ++sleeps;
+            signal.wait_for(lock, std::chrono::milliseconds(30000));
+        }
         --idleThreads;
-    }
-    // Strict two-level priority, deliberately no aging/fairness: interactive
-    // jobs may starve queued background rows, and the dirty-range machinery
-    // re-renders anything they invalidate.
-    if ( !highPriorityQueue.empty() ) {
-        req = highPriorityQueue.front();
-        highPriorityQueue.pop_front();
-    } else if ( !queue.empty() ) {
-        req = queue.front();
-        queue.pop_front();
+        lock.unlock();
+        req = TryGetJob(own);
+        // the counts go up before the job is on a deque, so a job that is
+        // counted but not found yet is still being pushed
+        if (req == nullptr && foregroundQueued <= 0 && backgroundQueued <= 0) {
+            break;
+        }
     }
     if (req) {
-        SetThreadQOS(10);
+        SetThreadQOS(req->IsBackground() ? 0 : 10);
     }
     return req;
 }
 
-void JobPool::PushJob(Job *job)
-{
-	std::unique_lock<std::mutex> locker(queueLock);
-    if (job->IsHighPriority()) {
-        highPriorityQueue.push_back(job);
-    } else {
-        queue.push_back(job);
+// The pushing worker's own shard, else the next shard round robin
+JobQueueShard *JobPool::PushShard() {
+    if (tlsPool == this && tlsShard != nullptr) {
+        return tlsShard;
     }
+    int const count = numShards.load(std::memory_order_acquire);
+    return shards[nextShard++ % count];
+}
+
+void JobPool::QueueJob(Job *job) {
     ++inFlight;
+    if (job->IsBackground() && !job->IsHighPriority()) {
+        std::unique_lock<std::mutex> lock(backgroundLock);
+        backgroundQueue.push_back(job);
+        ++backgroundQueued;
+        return;
+    }
+    JobQueueShard *shard = PushShard();
+    bool const high = job->IsHighPriority();
+    // counted first so a worker never sees the job without the count
+    if (high) {
+        ++highQueued;
+    }
+    ++foregroundQueued;
+    shard->Lock();
+    (high ? shard->high : shard->normal).push_back(job);
+    ++(high ? shard->highSize : shard->normalSize);
+    shard->pushed.fetch_add(1, std::memory_order_relaxed);
+    shard->lock.unlock();
+}
 
-    int count = inFlight;
-    count -= idleThreads;
-    count -= numThreads;
-    count = std::min(count, maxNumThreads - numThreads);
-    locker.unlock();
+void JobPool::PromoteJob(Job *job) {
+    {
+        std::unique_lock<std::mutex> locker(backgroundLock);
+        auto it = std::find(backgroundQueue.begin(), backgroundQueue.end(), job);
+        if (it == backgroundQueue.end()) {
+            return;
+        }
+        backgroundQueue.erase(it);
+        --backgroundQueued;
+    }
+    JobQueueShard *shard = PushShard();
+    ++foregroundQueued;
+    shard->Lock();
+    shard->normal.push_front(job);
+    ++shard->normalSize;
+    shard->lock.unlock();
+    WakeWorkers(1);
+}
 
+// Starts a worker for every queued or running job no idle worker can take.
+// Workers push too, so the count is worked out again under threadLock.
+void JobPool::AddWorkers() {
+    if (inFlight - idleThreads - numThreads <= 0 || numThreads >= maxNumThreads) {
+        return;
+    }
+    LockThreads();
+    int count = std::min(inFlight - idleThreads - numThreads, maxNumThreads - numThreads);
     if (count > 0) {
-        LockThreads();
         if (numThreads == 0 && count < MIN_JOBPOOLTHREADS && MIN_JOBPOOLTHREADS < maxNumThreads) {
             //when we create first thread, assume we'll need extras real soon
             count = MIN_JOBPOOLTHREADS;
@@ -470,42 +652,36 @@ void JobPool::PushJob(Job *job)
             threads.push_back(new JobPoolWorker(this));
             ++numThreads;
         }
-        UnlockThreads();
     }
-    signal.notify_one();
+    UnlockThreads();
 }
-void JobPool::PushJobs(const std::list<Job *> &jobs) {
-    std::unique_lock<std::mutex> locker(queueLock);
-    for (auto job : jobs) {
-        if (job->IsHighPriority()) {
-            highPriorityQueue.push_back(job);
+
+void JobPool::WakeWorkers(int count) {
+    // idleThreads is raised under idleLock before the queue counts are
+    // rechecked, and the counts were raised before this read, so either the
+    // worker sees the job or this sees the worker
+    if (idleThreads > 0) {
+        std::unique_lock<std::mutex> lock(idleLock);
+        if (count > 1) {
+            signal.notify_all();
         } else {
-            queue.push_back(job);
+            signal.notify_one();
         }
-        ++inFlight;
     }
-    int count = inFlight;
-    count -= idleThreads;
-    count -= numThreads;
-    count = std::min(count, maxNumThreads - numThreads);
-    locker.unlock();
-    if (count > 0) {
-        LockThreads();
-        if (numThreads == 0 && count < MIN_JOBPOOLTHREADS && MIN_JOBPOOLTHREADS < maxNumThreads) {
-            //when we create first thread, assume we'll need extras real soon
-            count = MIN_JOBPOOLTHREADS;
-        }
-        for (int i = 0; i < count; i++) {
-            threads.push_back(new JobPoolWorker(this));
-            ++numThreads;
-        }
-        UnlockThreads();
-    }
-    if (jobs.size() > 1) {
-        signal.notify_all();
-    } else {
-        signal.notify_one();
+}
+
+void JobPool::PushJob(Job *job)
+{
+    QueueJob(job);
+    AddWorkers();
+    WakeWorkers(1);
+}
+void JobPool::PushJobs(const std::list<Job *> &jobs) {
+    for (auto job : jobs) {
+        QueueJob(job);
     }
+    AddWorkers();
+    WakeWorkers((int)jobs.size());
 }
 bool JobPool::isEmpty() const {
     return inFlight == 0;
@@ -538,9 +714,24 @@ void JobPool::Stop()
     UnlockThreads();
 }
 
+JobPoolStats JobPool::GetStats() const {
+    JobPoolStats stats;
+    int const count = numShards.load(std::memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        stats.pushed += shards[i]->pushed.load(std::memory_order_relaxed);
+        stats.popped += shards[i]->popped.load(std::memory_order_relaxed);
+        stats.stolen += shards[i]->stolen.load(std::memory_order_relaxed);
+        stats.contended += shards[i]->contended.load(std::memory_order_relaxed);
+    }
+    stats.sleeps = sleeps;
+    return stats;
+}
+
 std::string JobPool::GetThreadStatus() {
     std::stringstream ret;
-    ret << "\n";
+    JobPoolStats const stats = GetStats();
+    ret << "\nQueues: " << numShards << " shards, " << stats.pushed << " pushed, " << stats.popped << " popped, "
+        << stats.stolen << " stolen, " << stats.contended << " contended, " << stats.sleeps << " sleeps\n";
     LockThreads();
     for (JobPoolWorker *worker : threads) {
         /*
@@ -10,6 +10,7 @@
  * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <cstdint>
 #include <deque>
 #include <vector>
 #include <list>
@@ -35,21 +36,56 @@ public:
     bool IsHighPriority() const { return highPriority; }
     void SetHighPriority(bool hp) { highPriority = hp; }
 
+    // Background jobs (render cache warming) only run on threads that would
+    // otherwise be idle: they are taken after both other queues are empty and
+    // are expected to hand their thread back via HasForegroundJobsQueued().
+    bool IsBackground() const { return background; }
+    void SetBackground(bool bg) { background = bg; }
+
 private:
     bool highPriority = false;
+    bool background = false;
 };
 
 
+// Scheduling counters, cumulative since the pool was created.
+struct JobPoolStats {
+    uint64_t pushed = 0;
+    uint64_t popped = 0;    // taken by the worker whose deque it was on
+    uint64_t stolen = 0;    // taken from another worker's deque
+    uint64_t contended = 0; // deque lock acquisitions that had to wait
+    uint64_t sleeps = 0;    // a worker found nothing to run and went idle
+};
+
 class JobPoolWorker;
+struct JobQueueShard;
 class JobPool
 {
     const int MIN_JOBPOOLTHREADS = 4;
+    static constexpr int MAX_JOBPOOLSHARDS = 256;
     std::mutex threadLock;
-    std::mutex queueLock;
-    std::condition_variable signal;
     std::vector<JobPoolWorker*> threads;
-    std::deque<Job*> queue;
-    std::deque<Job*> highPriorityQueue;
+
+    // Every worker owns a deque (a shard, high priority and normal lanes)
+    // that it pushes to and takes from, and steals from the others when
+    // its own is empty.  Jobs pushed from outside the pool are spread over
+    // the shards.  Shards outlive the worker that owned them, a new worker
+    // reuses a free one, so jobs left on a shard are stolen rather than
+    // migrated.  Background jobs are rare and have one queue of their own.
+    JobQueueShard* shards[MAX_JOBPOOLSHARDS] = {};
+    std::atomic_int numShards;
+    std::atomic_uint nextShard;
+    std::atomic_int highQueued;
+    std::atomic_int foregroundQueued;
+    std::mutex backgroundLock;
+    std::deque<Job*> backgroundQueue;
+    std::atomic_int backgroundQueued;
+
+    // idle workers wait on signal, queue counts are rechecked under idleLock
+    std::mutex idleLock;
+    std::condition_variable signal;
+    std::atomic<uint64_t> sleeps;
+
     std::atomic_int numThreads;
     std::atomic_int idleThreads;
     std::string threadNameBase;
@@ -66,6 +102,10 @@ public:
     
     void PushJob(Job *job);
     void PushJobs(const std::list<Job *> &jobs);
+    // Moves a queued background job to the front of a normal lane so it
+    // runs now (used to let an aborted background job bail promptly).
+    void PromoteJob(Job *job);
+    bool HasForegroundJobsQueued() const { return foregroundQueued > 0; }
     int size() const { return (int)threads.size(); }
     int maxSize() const { return maxNumThreads; }
     virtual void Start(size_t poolSize = 1, size_t minPoolSize = 0);
@@ -73,6 +113,7 @@ public:
     void SetMaxThreadCount(int maxThreads);
 
     virtual std::string GetThreadStatus();
+    JobPoolStats GetStats() const;
     
     bool isEmpty() const;
 private:
@@ -80,5 +121,14 @@ private:
     void RemoveWorker(JobPoolWorker*);
     void LockThreads();
     void UnlockThreads();
-    Job *GetNextJob();
+    Job *GetNextJob(JobQueueShard *own);
+    Job *TryGetJob(JobQueueShard *own);
+    Job *TakeJob(JobQueueShard *shard, bool high, bool steal);
+    void QueueJob(Job *job);
+    JobQueueShard *PushShard();
+    void AddWorkers();
+    void WakeWorkers(int count);
+    // threadLock must be held
+    JobQueueShard *ClaimShard();
+    void ReleaseShard(JobQueueShard *shard);
 };
@@ -0,0 +1,245 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "utils/PerfTrace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include <log.h>
+
+namespace {
+    // 64K events is a few MB per thread and a good few seconds of a busy render thread
+    constexpr uint64_t RING_SIZE = 64 * 1024;
+    // Slots just ahead of the writer may be mid overwrite while a dump is read
+    // from another thread, so a wrapped ring drops this many of its oldest
+    constexpr uint64_t RING_GUARD = 64;
+
+    struct TraceEvent {
+        const char* cat;
+        const char* name;
+        const char* arg1Name;
+        const char* arg2Name;
+        int64_t arg1;
+        int64_t arg2;
+        uint64_t start;
+        uint64_t end;
+    };
+
+    struct ThreadRing {
+        uint32_t tid = 0;
+        std::string name;
+        std::atomic<uint64_t> count = 0;
+        TraceEvent events[RING_SIZE];
+    };
+
+    const std::chrono::steady_clock::time_point TRACE_EPOCH = std::chrono::steady_clock::now();
+
+    std::string TraceFile() {
+        const char* f = getenv("XL_TRACE");
+        return (f != nullptr) ? f : "";
+    }
+
+    // Rings are never freed: a thread can be recording into its ring right up
+    // to process exit and the dump at exit still wants what it recorded.
+    class TraceHolder {
+    public:
+        std::mutex lock;
+        std::vector<ThreadRing*> rings;
+        std::set<std::string> strings;
+        std::string file = TraceFile();
+        uint32_t nextTid = 1;
+
+        ~TraceHolder();
+    };
+
+    TraceHolder& Holder() {
+        static TraceHolder holder;
+        return holder;
+    }
+
+    thread_local ThreadRing* threadRing = nullptr;
+
+    bool WriteTrace(TraceHolder& h, const std::string& fn, bool log);
+
+    // the loggers may already be gone at exit so this write is a quiet one
+    TraceHolder::~TraceHolder() {
+        if (!file.empty()) {
+            PerfTrace::detail::enabled = false;
+            WriteTrace(*this, file, false);
+        }
+    }
+
+    ThreadRing* GetThreadRing() {
+        if (threadRing == nullptr) {
+            auto& h = Holder();
+            std::unique_lock<std::mutex> lock(h.lock);
+            threadRing = new ThreadRing();
+            threadRing->tid = h.nextTid++;
+            h.rings.push_back(threadRing);
+        }
+        return threadRing;
+    }
+
+    void AppendEscaped(std::string& out, const char* s) {
+        for (; *s != 0; ++s) {
+            unsigned char c = (unsigned char)*s;
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += (char)c;
+            } else if (c < 0x20) {
+                char buf[8];
+                snprintf(buf, sizeof(buf), "\\u%04x", c);
+                out += buf;
+            } else {
+                out += (char)c;
+            }
+        }
+    }
+
+    // ts and dur are microseconds, keep the nanoseconds as the fraction
+    void AppendMicros(std::string& out, uint64_t ns) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%llu.%03u", (unsigned long long)(ns / 1000), (unsigned)(ns % 1000));
+        out += buf;
+    }
+
+    void AppendEvent(std::string& out, uint32_t tid, const TraceEvent& e) {
+        out += "{\"ph\":\"X\",\"pid\":1,\"tid\":";
+        out += std::to_string(tid);
+        out += ",\"cat\":\"";
+        AppendEscaped(out, e.cat);
+        out += "\",\"name\":\"";
+        AppendEscaped(out, e.name);
+        out += "\",\"ts\":";
+        AppendMicros(out, e.start);
+        out += ",\"dur\":";
+        AppendMicros(out, e.end > e.start ? e.end - e.start : 0);
+        if (e.arg1Name != nullptr) {
+            out += ",\"args\":{\"";
+            AppendEscaped(out, e.arg1Name);
+            out += "\":";
+            out += std::to_string(e.arg1);
+            if (e.arg2Name != nullptr) {
+                out += ",\"";
+                AppendEscaped(out, e.arg2Name);
+                out += "\":";
+                out += std::to_string(e.arg2);
+            }
+            out += "}";
+        }
+        out += "}";
+    }
+}
+
+namespace PerfTrace {
+
+    namespace detail {
+        std::atomic<bool> enabled = !Holder().file.empty();
+
+        uint64_t Now() {
+            return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - TRACE_EPOCH).count();
+        }
+
+        void Record(const char* cat, const char* name, uint64_t start, uint64_t end,
+                    const char* arg1Name, int64_t arg1, const char* arg2Name, int64_t arg2) {
+            ThreadRing* ring = GetThreadRing();
+            uint64_t n = ring->count.load(std::memory_order_relaxed);
+            TraceEvent& e = ring->events[n % RING_SIZE];
+            e.cat = cat;
+            e.name = name;
+            e.arg1Name = arg1Name;
+            e.arg2Name = arg2Name;
+            e.arg1 = arg1;
+            e.arg2 = arg2;
+            e.start = start;
+            e.end = end;
+            ring->count.store(n + 1, std::memory_order_release);
+        }
+    }
+
+    const char* Intern(const std::string& s) {
+        auto& h = Holder();
+        std::unique_lock<std::mutex> lock(h.lock);
+        return h.strings.insert(s).first->c_str();
+    }
+
+    void NameThread(const std::string& name) {
+        if (!IsEnabled()) {
+            return;
+        }
+        ThreadRing* ring = GetThreadRing();
+        std::unique_lock<std::mutex> lock(Holder().lock);
+        ring->name = name;
+    }
+
+    bool Write(const std::string& file) {
+        auto& h = Holder();
+        return WriteTrace(h, file.empty() ? h.file : file, true);
+    }
+}
+
+namespace {
+    bool WriteTrace(TraceHolder& h, const std::string& fn, bool log) {
+        if (fn.empty()) {
+            return false;
+        }
+
+        std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        uint64_t events = 0;
+        uint64_t dropped = 0;
+        {
+            std::unique_lock<std::mutex> lock(h.lock);
+            for (auto ring : h.rings) {
+                if (!ring->name.empty()) {
+                    if (!first) out += ",\n";
+                    first = false;
+                    out += "{\"ph\":\"M\",\"pid\":1,\"tid\":";
+                    out += std::to_string(ring->tid);
+                    out += ",\"name\":\"thread_name\",\"args\":{\"name\":\"";
+                    AppendEscaped(out, ring->name.c_str());
+                    out += "\"}}";
+                }
+                uint64_t end = ring->count.load(std::memory_order_acquire);
+                uint64_t begin = 0;
+                if (end > RING_SIZE) {
+                    begin = end - RING_SIZE + RING_GUARD;
+                    dropped += begin;
+                }
+                for (uint64_t i = begin; i < end; ++i) {
+                    if (!first) out += ",\n";
+                    first = false;
+                    AppendEvent(out, ring->tid, ring->events[i % RING_SIZE]);
+                    ++events;
+                }
+            }
+        }
+        out += "\n]}\n";
+
+        FILE* f = fopen(fn.c_str(), "wb");
+        if (f == nullptr) {
+            if (log) {
+                spdlog::warn("PerfTrace: unable to write trace file {}", fn);
+            }
+            return false;
+        }
+        bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+        fclose(f);
+        if (log) {
+            spdlog::info("PerfTrace: wrote {} events ({} overwritten) to {}", events, dropped, fn);
+        }
+        return ok;
+    }
+}
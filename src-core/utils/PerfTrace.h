@@ -0,0 +1,80 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Timeline tracing across render, decode and output threads.
+//
+// Set XL_TRACE=<file> to turn it on. Each thread records spans into its own
+// fixed size ring (the oldest are overwritten once it is full) so recording
+// takes no locks, and when the process exits, or Write is called, every ring
+// is dumped as Chrome trace-event JSON that chrome://tracing or
+// ui.perfetto.dev can open. With XL_TRACE unset a Span costs one relaxed load.
+//
+// Names and categories are stored as pointers: pass string literals or the
+// result of Intern, never a temporary.
+namespace PerfTrace {
+
+    namespace detail {
+        extern std::atomic<bool> enabled;
+        uint64_t Now();
+        void Record(const char* cat, const char* name, uint64_t start, uint64_t end,
+                    const char* arg1Name, int64_t arg1, const char* arg2Name, int64_t arg2);
+    }
+
+    inline bool IsEnabled() { return detail::enabled.load(std::memory_order_relaxed); }
+
+    // Returns a pointer to a copy of s that lives for the rest of the process.
+    // Takes a lock so look it up once (per job, per pool) rather than per span.
+    const char* Intern(const std::string& s);
+
+    // Labels the calling thread's row in the trace
+    void NameThread(const std::string& name);
+
+    // Writes everything recorded so far. An empty file uses XL_TRACE.
+    bool Write(const std::string& file = "");
+
+    class Span {
+    public:
+        Span(const char* cat, const char* name,
+             const char* arg1Name = nullptr, int64_t arg1 = 0,
+             const char* arg2Name = nullptr, int64_t arg2 = 0) {
+            if (IsEnabled() && name != nullptr) {
+                _cat = cat;
+                _name = name;
+                _arg1Name = arg1Name;
+                _arg1 = arg1;
+                _arg2Name = arg2Name;
+                _arg2 = arg2;
+                _start = detail::Now();
+            }
+        }
+        ~Span() {
+            if (_cat != nullptr) {
+                detail::Record(_cat, _name, _start, detail::Now(), _arg1Name, _arg1, _arg2Name, _arg2);
+            }
+        }
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        const char* _cat = nullptr;
+        const char* _name = nullptr;
+        const char* _arg1Name = nullptr;
+        const char* _arg2Name = nullptr;
+        int64_t _arg1 = 0;
+        int64_t _arg2 = 0;
+        uint64_t _start = 0;
+    };
+}
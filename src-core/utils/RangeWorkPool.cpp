@@ -11,6 +11,7 @@
 #include "RangeWorkPool.h"
 
 #include "AutoReleasePool.h"
+#include "PerfTrace.h"
 
 #include <algorithm>
 #include <sstream>
@@ -31,7 +32,7 @@ void NameThisThread(const std::string& name) {
 } // namespace
 
 RangeWorkPool::RangeWorkPool(const std::string& name, int workers) :
-    poolName(name), numWorkers(std::max(workers, 1)) {
+    poolName(name), traceName(PerfTrace::Intern(name)), numWorkers(std::max(workers, 1)) {
     for (int x = 0; x < numWorkers; ++x) {
         // Detached: the pool outlives any single render and, like JobPool's
         // workers, must not become a join dependency of static destruction.
@@ -139,6 +140,7 @@ void RangeWorkPool::RunOne(Item* it, int idx, std::unique_lock<std::mutex>& lk)
         // whole frames through here. Push/pop are both on this thread inside
         // this scope, so the runtime's LIFO + affinity rules hold.
         AutoReleasePool pool;
+        PerfTrace::Span span("pool", traceName, "index", idx);
         it->fn(idx);
     } catch (...) {
         // Matches parallel_for: one bad index must not take a worker down.
@@ -161,6 +163,7 @@ void RangeWorkPool::RunOne(Item* it, int idx, std::unique_lock<std::mutex>& lk)
 
 void RangeWorkPool::WorkerLoop() {
     NameThisThread(poolName);
+    PerfTrace::NameThread(poolName);
     std::unique_lock<std::mutex> lk(mtx);
     while (!stopping) {
         Item* it = nullptr;
@@ -150,6 +150,7 @@ private:
     void WakeWorkers(int wake, bool all);
 
     const std::string poolName;
+    const char* const traceName; // poolName as PerfTrace holds it
     const int numWorkers;
 
     std::mutex mtx;
@@ -42,6 +42,10 @@
 #include <sys/sysinfo.h>
 #endif
 
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
 #include <log.h>
 
 #if defined(_MSC_VER) // Visual studio
@@ -696,6 +700,29 @@ uint64_t GetProcessMemoryUsageMB() {
 #endif
 }
 
+uint64_t GetProcessPeakMemoryUsageMB() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS mc;
+    mc.cb = sizeof(mc);
+    if (::GetProcessMemoryInfo(::GetCurrentProcess(), &mc, sizeof(mc)) != 0) {
+        return (uint64_t)mc.PeakWorkingSetSize / (1024 * 1024);
+    }
+    return 0;
+#elif defined(__APPLE__) || defined(__linux__)
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) == 0) {
+#if defined(__APPLE__)
+        return (uint64_t)ru.ru_maxrss / (1024 * 1024); // bytes
+#else
+        return (uint64_t)ru.ru_maxrss / 1024; // KB
+#endif
+    }
+    return 0;
+#else
+    return 0;
+#endif
+}
+
 uint64_t GetProcessMemoryLimitMB() {
 #if defined(__APPLE__)
     // limit_bytes_remaining is what os_proc_available_memory() reports (that
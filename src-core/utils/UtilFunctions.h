@@ -174,6 +174,10 @@ uint64_t GetPhysicalMemorySizeMB();
 // jetsam kills on), Windows the private working set, Linux RSS.
 uint64_t GetProcessMemoryUsageMB();
 
+// The most memory this process has had resident at any point, in MB, or 0 if
+// the platform won't tell us. Windows reports the peak working set.
+uint64_t GetProcessPeakMemoryUsageMB();
+
 // The ceiling the OS will kill this process at, in MB, or 0 when there isn't
 // one below installed RAM. iOS/iPadOS impose a per-app dirty-memory limit well
 // under the device's RAM, so anything budgeting against physical memory is far
@@ -1903,7 +1903,7 @@ static std::optional<HEADER_INFO_TYPES> headerTypeFromString(NSString* key) {
     // Data buffer only contains the model's channels (0..modelChans-1).
     v2->m_sparseRanges[0] = std::pair<uint32_t, uint32_t>(0, modelChans);
     for (uint32_t fr = startFrame; fr < endFrame; ++fr) {
-        v2->addFrame(fr - startFrame, &modelData[fr][0]);
+        v2->addFrame(fr - startFrame, modelData.Read(fr)[0]);
     }
     v2->finalize();
     return YES;
@@ -2728,7 +2728,7 @@ static int ConvertDataRowToEffects(EffectLayer* layer, xlColorVector& colors, in
         const int32_t startChan = ssModel.NodeStartChannel(0);
         if (startChan < 0 || (size_t)startChan >= seqData.NumChannels()) return;
         for (size_t f = 0; f < numFrames; ++f) {
-            ssModel.SetNodeChannelValues(0, &seqData[f][startChan]);
+            ssModel.SetNodeChannelValues(0, seqData.Read(f)[startChan]);
             colors.push_back(ssModel.GetNodeColor(0));
         }
         total += ConvertDataRowToEffects(layer, colors, frameTime, false);
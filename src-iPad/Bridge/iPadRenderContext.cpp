@@ -2513,7 +2513,7 @@ void iPadRenderContext::SetModelColorsUnlocked(int frameMS) {
     int frame = frameMS / _seqData.FrameTime();
     if (frame < 0 || (unsigned int)frame >= _seqData.NumFrames()) return;
 
-    auto& fd = _seqData[frame];
+    auto fd = _seqData.Read(frame);
     // Iterate the manager rather than AllModels.GetModels(), which returns the
     // map BY VALUE — a full red-black tree + key-string copy. This runs once per
     // preview draw (XLMetalBridge drawModelsForDocument:), i.e. at display
@@ -2523,7 +2523,7 @@ void iPadRenderContext::SetModelColorsUnlocked(int frameMS) {
         for (size_t n = 0; n < model->GetNodeCount(); n++) {
             int32_t startChan = model->NodeStartChannel(n);
             if (startChan >= 0 && (unsigned int)startChan + chansPerNode <= _seqData.NumChannels()) {
-                model->SetNodeChannelValues(n, &fd[startChan]);
+                model->SetNodeChannelValues(n, fd[startChan]);
             }
         }
     }
@@ -2744,7 +2744,7 @@ std::vector<std::shared_ptr<xlImage>> iPadRenderContext::RenderEffectToFrames(
     for (size_t i = 0; i < numFrames; i++) {
         auto img = std::make_shared<xlImage>(width, height);
         FillXlImagePreset(*img, matrixModel,
-                           (uint8_t*)&seqData[i][0], 1, true);
+                           (uint8_t*)seqData.Read(i)[0], 1, true);
         result.push_back(img);
     }
 
@@ -669,10 +669,10 @@ void xLightsFrame::WriteFalconPiModelFile(const wxString& filename, long numChan
         buf[19] = (wxUint8)((modelSize >> 24) & 0xFF);
         f.Write(buf, ESEQ_HEADER_LENGTH);
 
-        size_t size = dataBuf->NumFrames();
-        size *= stepSize;
-
-        f.Write(&(*dataBuf)[0][0], size);
+        // frames are not contiguous when the sequence data is held in compressed blocks
+        for (unsigned int x = 0; x < dataBuf->NumFrames(); x++) {
+            f.Write(dataBuf->Read(x)[0], stepSize);
+        }
 
         f.Close();
     }
@@ -713,7 +713,7 @@ std::vector<std::shared_ptr<xlImage>> xLightsFrame::RenderEffectToFrames(
 
     for (size_t i = 0; i < numFrames; i++) {
         auto img = std::make_shared<xlImage>(width, height);
-        ModelVideoExporter::FillXlImage(*img, matrixModel, (uint8_t*)&seqData[i][0], 1, true);
+        ModelVideoExporter::FillXlImage(*img, matrixModel, (uint8_t*)seqData.Read(i)[0], 1, true);
         result.push_back(img);
     }
 
@@ -23,6 +23,14 @@
 
 #include <log.h>
 
+#ifdef XLDO_PLAYER
+#include <csignal>
+#include <filesystem>
+
+#include "outputs/OutputManager.h"
+#include "outputs/FSEQPlayer.h"
+#endif
+
 #ifdef xlDO
 static int GetxFadePort(int xfp)
 {
@@ -306,11 +314,70 @@ static const wxCmdLineEntryDesc cmdLineDesc[] =
     { wxCMD_LINE_OPTION, "p9", "Parameter9", "Ninth template substitution parameter.",
       wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_NEEDS_SEPARATOR },
 
+#ifdef XLDO_PLAYER
+    { wxCMD_LINE_OPTION, "", "play", "Play an fseq file directly to the outputs without xLights.",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_NEEDS_SEPARATOR },
+    { wxCMD_LINE_OPTION, "", "show", "Show folder containing xlights_networks.xml. Defaults to the folder holding the fseq.",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_NEEDS_SEPARATOR },
+    { wxCMD_LINE_SWITCH, "", "loop", "Loop the fseq until interrupted.",
+      wxCMD_LINE_VAL_NONE, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_OPTION, "", "prefetch", "Number of frames to decode ahead of playback.",
+      wxCMD_LINE_VAL_NUMBER, wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_NEEDS_SEPARATOR },
+#endif
+
     wxCMD_LINE_DESC_END
 };
 
 
 
+#ifdef XLDO_PLAYER
+static FSEQPlayer* _activePlayer = nullptr;
+
+static void StopPlayer(int)
+{
+    if (_activePlayer != nullptr) {
+        _activePlayer->Stop();
+    }
+}
+
+int PlayFSEQ(bool verbose, const std::string& fseq, const std::string& showDir, bool loop, int prefetch)
+{
+    std::string dir = showDir;
+    if (dir.empty()) {
+        dir = std::filesystem::path(fseq).parent_path().string();
+    }
+
+    OutputManager outputManager;
+    if (!outputManager.Load(dir)) {
+        spdlog::error("Unable to load the networks from '{}'.", dir);
+        return 1;
+    }
+    if (verbose) {
+        spdlog::info("Loaded {} channels of outputs from '{}'.", outputManager.GetTotalChannels(), dir);
+    }
+
+    FSEQPlayer player(&outputManager);
+    if (!player.Open(fseq, prefetch)) {
+        return 1;
+    }
+    if (verbose && player.GetChannelCount() != (uint32_t)outputManager.GetTotalChannels()) {
+        spdlog::warn("fseq has {} channels but the outputs have {}.", player.GetChannelCount(), outputManager.GetTotalChannels());
+    }
+
+    _activePlayer = &player;
+    auto oldInt = std::signal(SIGINT, StopPlayer);
+    auto oldTerm = std::signal(SIGTERM, StopPlayer);
+
+    bool res = player.Play(loop);
+
+    std::signal(SIGINT, oldInt);
+    std::signal(SIGTERM, oldTerm);
+    _activePlayer = nullptr;
+
+    return res ? 0 : 1;
+}
+#endif
+
 int DoXLDoCommands(int argc, char **argv) {
     bool verbose = false;
     wxString ip = "127.0.0.1";
@@ -320,6 +387,11 @@ int DoXLDoCommands(int argc, char **argv) {
     std::vector<wxString> parameters;
     parameters.resize(9);
     wxString script;
+#ifdef XLDO_PLAYER
+    wxString play;
+    wxString showDir;
+    long prefetch = 20;
+#endif
     
     wxMessageOutput::Set(new wxMessageOutputStderr);
     wxCmdLineParser parser(cmdLineDesc, argc, argv);
@@ -401,6 +473,17 @@ int DoXLDoCommands(int argc, char **argv) {
                 }
             }
 
+#ifdef XLDO_PLAYER
+            if (parser.Found("play", &play)) {
+                parser.Found("show", &showDir);
+                parser.Found("prefetch", &prefetch);
+                if (verbose) {
+                    spdlog::info("Playing: {}.", play.ToStdString());
+                }
+                return PlayFSEQ(verbose, play.ToStdString(), showDir.ToStdString(), parser.Found("loop"), (int)prefetch);
+            }
+#endif
+
             break;
 
         default:
@@ -17,5 +17,8 @@
 int Automation(bool verbose, const std::string& ip, int ab, const std::string& templateFile,
                const std::string& command, const std::vector<wxString>& parameters, const std::string& script);
 
+#ifdef XLDO_PLAYER
+int PlayFSEQ(bool verbose, const std::string& fseq, const std::string& showDir, bool loop, int prefetch);
+#endif
 
 int DoXLDoCommands(int argc, char **argv);
@@ -1035,6 +1035,11 @@ bool xLightsFrame::ProcessAutomation(std::vector<std::string> &paths,
         }
         controllers = "[" + controllers + "]";
         return sendResponse(controllers, "controllers", 200, true);
+    } else if (cmd == "getOutputTimingStats") {
+        return sendResponse(_outputScheduler.GetStatsJSON().dump(), "stats", 200, true);
+    } else if (cmd == "resetOutputTimingStats") {
+        _outputScheduler.ResetStats();
+        return sendResponse("Output timing stats reset.", "msg", 200, false);
     } else if (cmd == "getControllerIPs") {
         std::string ipAddresses;
         for (const auto& it : _outputManager.GetControllers()) {
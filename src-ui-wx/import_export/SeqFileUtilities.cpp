@@ -794,6 +794,12 @@ void xLightsFrame::OpenSequence(const wxString& passed_filename, ConvertLogDialo
         EnableSequenceControls(true);
         Notebook1->SetSelection(Notebook1->GetPageIndex(PanelSequencer));
 
+        // fill the render cache in the background so the first renders after
+        // opening are mostly cache hits
+        if (loaded_xml && !_renderMode && !_checkSequenceMode && !_suspendRender && _renderEngine->IsRenderDone()) {
+            _renderEngine->WarmRenderCache(_sequenceElements, _seqData, modelsChangeCount);
+        }
+
         AddToMRU(filename);
         UpdateRecentFilesList(false);
 
@@ -943,7 +949,8 @@ bool xLightsFrame::CloseSequence()
         }
         if (dlg->GetSaveChanges()) {
             SaveSequence();
-            // must wait for the rendering to complete
+            // must wait for the rendering to complete, but not for cache warming
+            _renderEngine->AbortBackgroundRenders();
             while (!_renderEngine->IsRenderDone()) {
                 wxMilliSleep(10);
                 wxYield();
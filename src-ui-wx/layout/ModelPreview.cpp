@@ -307,7 +307,7 @@ void ModelPreview::OnZoomGesture(wxZoomGestureEvent& event) {
                 Refresh();
                 Update();
                 if (xlights->GetPlayStatus() == PLAY_TYPE_MODEL_PAUSED || xlights->GetPlayStatus() == PLAY_TYPE_EFFECT_PAUSED) {
-                    Render(xlights->GetCurrentPlayTime(), &xlights->_seqData[xlights->GetCurrentPlayTime() / xlights->_seqData.FrameTime()][0]);
+                    Render(xlights->GetCurrentPlayTime(), xlights->_seqData.Read(xlights->GetCurrentPlayTime() / xlights->_seqData.FrameTime())[0]);
                 }
             }
         }
@@ -397,7 +397,7 @@ void ModelPreview::mouseMoved(wxMouseEvent& event) {
                 Refresh();
                 Update();
                 if (xlights->GetPlayStatus() == PLAY_TYPE_MODEL_PAUSED || xlights->GetPlayStatus() == PLAY_TYPE_EFFECT_PAUSED) {
-                    Render(xlights->GetCurrentPlayTime(), &xlights->_seqData[xlights->GetCurrentPlayTime() / xlights->_seqData.FrameTime()][0]);
+                    Render(xlights->GetCurrentPlayTime(), xlights->_seqData.Read(xlights->GetCurrentPlayTime() / xlights->_seqData.FrameTime())[0]);
                 }
             }
         }
@@ -447,7 +447,7 @@ void ModelPreview::mouseMoved(wxMouseEvent& event) {
                 Refresh();
                 Update();
                 if (xlights->GetPlayStatus() == PLAY_TYPE_MODEL_PAUSED || xlights->GetPlayStatus() == PLAY_TYPE_EFFECT_PAUSED) {
-                    Render(xlights->GetCurrentPlayTime(), &xlights->_seqData[xlights->GetCurrentPlayTime() / xlights->_seqData.FrameTime()][0]);
+                    Render(xlights->GetCurrentPlayTime(), xlights->_seqData.Read(xlights->GetCurrentPlayTime() / xlights->_seqData.FrameTime())[0]);
                 }
             }
         }
@@ -721,7 +721,7 @@ void ModelPreview::mouseWheelMoved(wxMouseEvent& event) {
             Refresh();
             Update();
             if (xlights->GetPlayStatus() == PLAY_TYPE_MODEL_PAUSED || xlights->GetPlayStatus() == PLAY_TYPE_EFFECT_PAUSED) {
-                Render(xlights->GetCurrentPlayTime(), &xlights->_seqData[xlights->GetCurrentPlayTime() / xlights->_seqData.FrameTime()][0]);
+                Render(xlights->GetCurrentPlayTime(), xlights->_seqData.Read(xlights->GetCurrentPlayTime() / xlights->_seqData.FrameTime())[0]);
             }
         }
     }
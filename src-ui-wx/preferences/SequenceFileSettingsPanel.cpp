@@ -39,6 +39,7 @@ const long SequenceFileSettingsPanel::ID_CHECKBOX6 = wxNewId();
 const long SequenceFileSettingsPanel::ID_DIRPICKERCTRL3 = wxNewId();
 const long SequenceFileSettingsPanel::ID_STATICTEXT3 = wxNewId();
 const long SequenceFileSettingsPanel::ID_CHOICE5 = wxNewId();
+const long SequenceFileSettingsPanel::ID_CHECKBOX7 = wxNewId();
 const long SequenceFileSettingsPanel::ID_CHECKBOX5 = wxNewId();
 const long SequenceFileSettingsPanel::ID_DIRPICKERCTRL2 = wxNewId();
 const long SequenceFileSettingsPanel::ID_LISTBOX_MEDIA = wxNewId();
@@ -46,6 +47,7 @@ const long SequenceFileSettingsPanel::ID_BUTTON_ADDMEDIA = wxNewId();
 const long SequenceFileSettingsPanel::ID_BUTTON_REMOVE_MEDIA = wxNewId();
 const long SequenceFileSettingsPanel::ID_STATICTEXT2 = wxNewId();
 const long SequenceFileSettingsPanel::ID_CHOICE_VIEW_DEFAULT = wxNewId();
+const long SequenceFileSettingsPanel::ID_CHECKBOX8 = wxNewId();
 //*)
 
 BEGIN_EVENT_TABLE(SequenceFileSettingsPanel,wxPanel)
@@ -135,6 +137,11 @@ SequenceFileSettingsPanel::SequenceFileSettingsPanel(wxWindow* parent,xLightsFra
 	Choice_MaximumRenderCache->Append(_("100 GB"));
 	Choice_MaximumRenderCache->Append(_("200 GB"));
 	FlexGridSizer3->Add(Choice_MaximumRenderCache, 1, wxALL|wxALIGN_LEFT|wxALIGN_CENTER_VERTICAL, 5);
+	CheckBox_ShareRenderCache = new wxCheckBox(this, ID_CHECKBOX7, _("Share Across Sequences"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_CHECKBOX7"));
+	CheckBox_ShareRenderCache->SetValue(false);
+	CheckBox_ShareRenderCache->SetToolTip(_("Effects with identical settings on the same model at the same time reuse one render in every sequence of the show."));
+	FlexGridSizer3->Add(CheckBox_ShareRenderCache, 1, wxALL|wxALIGN_LEFT|wxALIGN_CENTER_VERTICAL, 5);
+	FlexGridSizer3->Add(-1,-1,1, wxALL|wxALIGN_CENTER_HORIZONTAL|wxALIGN_CENTER_VERTICAL, 5);
 	StaticBoxSizer3->Add(FlexGridSizer3, 1, wxALL|wxEXPAND, 5);
 	GridBagSizer1->Add(StaticBoxSizer3, wxGBPosition(5, 0), wxGBSpan(1, 2), wxALL|wxEXPAND, 5);
 	StaticBoxSizer2 = new wxStaticBoxSizer(wxHORIZONTAL, this, _("FSEQ Directory"));
@@ -165,6 +172,10 @@ SequenceFileSettingsPanel::SequenceFileSettingsPanel(wxWindow* parent,xLightsFra
 	ViewDefaultChoice->SetMinSize(wxSize(200,-1));
 	ViewDefaultChoice->SetToolTip(_("This option is used to select which models will populate the master view when a new sequence is created."));
 	GridBagSizer1->Add(ViewDefaultChoice, wxGBPosition(3, 1), wxDefaultSpan, wxALL|wxEXPAND, 5);
+	CheckBox_RenderAhead = new wxCheckBox(this, ID_CHECKBOX8, _("Render Ahead During Playback"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_CHECKBOX8"));
+	CheckBox_RenderAhead->SetValue(false);
+	CheckBox_RenderAhead->SetToolTip(_("While a sequence plays, edits re-render the frames just ahead of the play position first and the frames already played last."));
+	GridBagSizer1->Add(CheckBox_RenderAhead, wxGBPosition(11, 0), wxGBSpan(1, 2), wxALL|wxALIGN_LEFT|wxALIGN_CENTER_VERTICAL, 5);
 	SetSizer(GridBagSizer1);
 	GridBagSizer1->Fit(this);
 	GridBagSizer1->SetSizeHints(this);
@@ -179,12 +190,14 @@ SequenceFileSettingsPanel::SequenceFileSettingsPanel(wxWindow* parent,xLightsFra
 	Connect(ID_CHECKBOX6,wxEVT_COMMAND_CHECKBOX_CLICKED,(wxObjectEventFunction)&SequenceFileSettingsPanel::OnCheckBox_RenderCacheClick);
 	Connect(ID_DIRPICKERCTRL3,wxEVT_COMMAND_DIRPICKER_CHANGED,(wxObjectEventFunction)&SequenceFileSettingsPanel::OnDirPickerCtrl_RenderCacheDirChanged);
 	Connect(ID_CHOICE5,wxEVT_COMMAND_CHOICE_SELECTED,(wxObjectEventFunction)&SequenceFileSettingsPanel::OnChoice_MaximumRenderCacheSelect);
+	Connect(ID_CHECKBOX7,wxEVT_COMMAND_CHECKBOX_CLICKED,(wxObjectEventFunction)&SequenceFileSettingsPanel::OnCheckBox_ShareRenderCacheClick);
 	Connect(ID_CHECKBOX5,wxEVT_COMMAND_CHECKBOX_CLICKED,(wxObjectEventFunction)&SequenceFileSettingsPanel::OnCheckBox_FSEQClick);
 	Connect(ID_DIRPICKERCTRL2,wxEVT_COMMAND_DIRPICKER_CHANGED,(wxObjectEventFunction)&SequenceFileSettingsPanel::OnDirPickerCtrl_FSEQDirChanged);
 	Connect(ID_LISTBOX_MEDIA,wxEVT_COMMAND_LISTBOX_SELECTED,(wxObjectEventFunction)&SequenceFileSettingsPanel::OnMediaDirectoryListSelect);
 	Connect(ID_BUTTON_ADDMEDIA,wxEVT_COMMAND_BUTTON_CLICKED,(wxObjectEventFunction)&SequenceFileSettingsPanel::OnAddMediaButtonClick);
 	Connect(ID_BUTTON_REMOVE_MEDIA,wxEVT_COMMAND_BUTTON_CLICKED,(wxObjectEventFunction)&SequenceFileSettingsPanel::OnRemoveMediaButtonClick);
 	Connect(ID_CHOICE_VIEW_DEFAULT,wxEVT_COMMAND_CHOICE_SELECTED,(wxObjectEventFunction)&SequenceFileSettingsPanel::OnViewDefaultChoiceSelect);
+	Connect(ID_CHECKBOX8,wxEVT_COMMAND_CHECKBOX_CLICKED,(wxObjectEventFunction)&SequenceFileSettingsPanel::OnCheckBox_RenderAheadClick);
 	//*)
 
 	GridBagSizer1->Fit(this);
@@ -244,6 +257,8 @@ bool SequenceFileSettingsPanel::TransferDataFromWindow() {
 
     frame->SetDefaultSeqView(ViewDefaultChoice->GetStringSelection());
     frame->SetRenderCacheMaximumSizeMB(DecodeMaxRenderCache(Choice_MaximumRenderCache->GetStringSelection()));
+    frame->SetRenderCacheShared(CheckBox_ShareRenderCache->IsChecked());
+    frame->SetRenderAheadPlayback(CheckBox_RenderAhead->IsChecked());
 
     return true;
 }
@@ -361,6 +376,8 @@ bool SequenceFileSettingsPanel::TransferDataToWindow() {
     DirPickerCtrl_RenderCache->SetPath(folder);
     CheckBox_LowDefinitionRender->SetValue(frame->IsLowDefinitionRender());
     Choice_MaximumRenderCache->SetStringSelection(EncodeMaxRenderCache(frame->RenderCacheMaximumSizeMB()));
+    CheckBox_ShareRenderCache->SetValue(frame->RenderCacheShared());
+    CheckBox_RenderAhead->SetValue(frame->RenderAheadPlayback());
 
     ViewDefaultChoice->Clear();
     ViewDefaultChoice->Append(wxString());
@@ -542,3 +559,17 @@ void SequenceFileSettingsPanel::OnChoice_MaximumRenderCacheSelect(wxCommandEvent
         TransferDataFromWindow();
     }
 }
+
+void SequenceFileSettingsPanel::OnCheckBox_ShareRenderCacheClick(wxCommandEvent& event)
+{
+    if (wxPreferencesEditor::ShouldApplyChangesImmediately()) {
+        TransferDataFromWindow();
+    }
+}
+
+void SequenceFileSettingsPanel::OnCheckBox_RenderAheadClick(wxCommandEvent& event)
+{
+    if (wxPreferencesEditor::ShouldApplyChangesImmediately()) {
+        TransferDataFromWindow();
+    }
+}
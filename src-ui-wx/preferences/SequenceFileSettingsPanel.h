@@ -42,7 +42,9 @@ class SequenceFileSettingsPanel: public wxPanel
 		wxButton* RemoveMediaButton;
 		wxCheckBox* CheckBox_FSEQ;
 		wxCheckBox* CheckBox_LowDefinitionRender;
+		wxCheckBox* CheckBox_RenderAhead;
 		wxCheckBox* CheckBox_RenderCache;
+		wxCheckBox* CheckBox_ShareRenderCache;
 		wxCheckBox* FSEQSaveCheckBox;
 		wxCheckBox* RenderOnSaveCheckBox;
 		wxChoice* AutoSaveIntervalChoice;
@@ -77,6 +79,7 @@ class SequenceFileSettingsPanel: public wxPanel
 		static const long ID_DIRPICKERCTRL3;
 		static const long ID_STATICTEXT3;
 		static const long ID_CHOICE5;
+		static const long ID_CHECKBOX7;
 		static const long ID_CHECKBOX5;
 		static const long ID_DIRPICKERCTRL2;
 		static const long ID_LISTBOX_MEDIA;
@@ -84,6 +87,7 @@ class SequenceFileSettingsPanel: public wxPanel
 		static const long ID_BUTTON_REMOVE_MEDIA;
 		static const long ID_STATICTEXT2;
 		static const long ID_CHOICE_VIEW_DEFAULT;
+		static const long ID_CHECKBOX8;
 		//*)
 
 	private:
@@ -109,6 +113,8 @@ class SequenceFileSettingsPanel: public wxPanel
 		void OnViewDefaultChoiceSelect(wxCommandEvent& event);
 		void OnCheckBox_LowDefinitionRenderClick(wxCommandEvent& event);
 		void OnChoice_MaximumRenderCacheSelect(wxCommandEvent& event);
+		void OnCheckBox_ShareRenderCacheClick(wxCommandEvent& event);
+		void OnCheckBox_RenderAheadClick(wxCommandEvent& event);
 		//*)
 
 		DECLARE_EVENT_TABLE()
@@ -239,7 +239,8 @@ void xLightsFrame::UpdateRenderStatus()
             }
         }
 
-        if (countFrames > 0 && countModels > 0) {
+        // cache warming runs unasked for, keep it off the progress bar
+        if (!rpi->background && countFrames > 0 && countModels > 0) {
             int pct = (countFrames * 80) / (countModels * frames);
             static int lastVal = 0;
             if (lastVal != pct) {
@@ -260,8 +261,10 @@ void xLightsFrame::UpdateRenderStatus()
                 wxBell();
             }
             rpi->CleanupJobs();
-            _appProgress->SetValue(0);
-            _appProgress->Reset();
+            if (!rpi->background) {
+                _appProgress->SetValue(0);
+                _appProgress->Reset();
+            }
             RenderDone();
             rpi->callback(_renderEngine->GetAbortedRenderJobs() > 0);
             delete rpi;
@@ -1057,16 +1057,16 @@ void xLightsFrame::Scrub(wxCommandEvent& event)
         int nn = playModel->GetNodeCount();
         for (int node = 0; node < nn; node++) {
             int start = playModel->NodeStartChannel(node);
-            playModel->SetNodeChannelValues(node, &_seqData[frame][start]);
+            playModel->SetNodeChannelValues(node, _seqData.Read(frame)[start]);
         }
         _modelPreviewPanel->setCurrentFrameTime(ms);
         playModel->DisplayEffectOnWindow(_modelPreviewPanel, mPointSize);
     }
-    _housePreviewPanel->GetModelPreview()->Render(ms, &_seqData[frame][0]);
+    _housePreviewPanel->GetModelPreview()->Render(ms, _seqData.Read(frame)[0]);
     for (const auto& it : PreviewWindows) {
         ModelPreview* preview = it;
         if (preview->GetActive()) {
-            preview->Render(ms, &_seqData[frame][0]);
+            preview->Render(ms, _seqData.Read(frame)[0]);
         }
     }
 }
@@ -2091,6 +2091,7 @@ void xLightsFrame::DoStopSequence()
     }
     playCurFrame = -1;
 	mLoopAudio = false;
+    _outputScheduler.ClearPlayPosition();
     if( playType == PLAY_TYPE_MODEL || playType == PLAY_TYPE_MODEL_PAUSED ) {
         if( CurrentSeqXmlFile->GetSequenceType() == "Media" ) {
 			AudioManager* playAudio = GetPlaybackAudio();
@@ -2714,6 +2715,14 @@ void xLightsFrame::SetPlayStatus(int status) {
         StartOutputTimer();
         //printf("Timer started - SetPlayStatus %d\n", status);
     }
+    // paused too, an edit made while paused plays from the same spot
+    if (_renderAheadPlayback && (playType == PLAY_TYPE_MODEL || playType == PLAY_TYPE_MODEL_PAUSED)) {
+        if (!_renderEngine->IsRenderAheadActive()) {
+            _renderEngine->StartRenderAhead(std::max(playStartTime, 0) / _seqData.FrameTime(), _seqData.FrameTime());
+        }
+    } else {
+        _renderEngine->StopRenderAhead();
+    }
 }
 void xLightsFrame::StartOutputTimer() {
     GPURenderUtils::prioritizeGraphics(true);
@@ -2852,10 +2861,20 @@ bool xLightsFrame::TimerRgbSeq(long msec)
         return true;
     }
     playCurFrame = frame;
+    if (playType == PLAY_TYPE_MODEL && _renderEngine->IsRenderAheadActive()) {
+        // the frame goes out regardless, audio does not wait
+        _renderEngine->SetRenderAheadPlayhead(frame);
+        if (!_renderEngine->IsFrameReady(frame)) {
+            _renderEngine->ReportUnderrun(frame);
+        }
+    }
     
-    if (_outputManager.IsOutputting()) {
+    bool const sendFrame = _outputManager.IsOutputting() && !_outputScheduler.IsRunning();
+    if (sendFrame) {
         _outputManager.StartFrame(msec);
     }
+    // held until EndFrame as zero copy outputs reference the sequence data directly
+    auto playFrame = _seqData.Read(frame);
     std::vector<bool> didRender(8);
     if (frame < (int)_seqData.NumFrames()) {
         //spdlog::debug("Outputting Frame {}", frame);
@@ -2866,18 +2885,18 @@ bool xLightsFrame::TimerRgbSeq(long msec)
             for (int node = 0; node < nn; node++) {
                 int start = playModel->NodeStartChannel(node);
                 wxASSERT(start < (int)_seqData.NumChannels());
-                playModel->SetNodeChannelValues(node, &_seqData[frame][start]);
+                playModel->SetNodeChannelValues(node, playFrame[start]);
             }
             _modelPreviewPanel->setCurrentFrameTime(curt);
             playModel->DisplayEffectOnWindow(_modelPreviewPanel, mPointSize);
         }
         if (!_presetRendering && NeedToRenderFrame(_housePreviewPanel->GetModelPreview(), OutputTimer, didRender)) {
-            _housePreviewPanel->GetModelPreview()->Render(curt, &_seqData[frame][0]);
+            _housePreviewPanel->GetModelPreview()->Render(curt, playFrame[0]);
         }
 
         for (const auto& it : PreviewWindows) {
             if (!_presetRendering && it->GetActive() && NeedToRenderFrame(it, OutputTimer, didRender)) {
-                it->Render(curt, &_seqData[frame][0]);
+                it->Render(curt, playFrame[0]);
             }
         }
     }
@@ -2931,7 +2950,7 @@ bool xLightsFrame::TimerRgbSeq(long msec)
         }
     }
 #endif
-    if (_outputManager.IsOutputting()) {
+    if (sendFrame) {
         _outputManager.EndFrame();
     }
     return true;
@@ -4308,7 +4327,7 @@ void xLightsFrame::ConvertDataRowToEffects(wxCommandEvent& event)
                         ssModel->Reset(1, *model, i, j);
 
                         for (size_t f = 0; f < _seqData.NumFrames(); ++f) {
-                            ssModel->SetNodeChannelValues(0, &_seqData[f][ssModel->NodeStartChannel(0)]);
+                            ssModel->SetNodeChannelValues(0, _seqData.Read(f)[ssModel->NodeStartChannel(0)]);
                             xlColor c = ssModel->GetNodeColor(0);
                             colors.push_back(c);
                         }
@@ -4336,7 +4355,7 @@ void xLightsFrame::ConvertDataRowToEffects(wxCommandEvent& event)
                     ssModel->Reset(1, *model, strand, i);
 
                     for (size_t f = 0; f < _seqData.NumFrames(); ++f) {
-                        ssModel->SetNodeChannelValues(0, &_seqData[f][ssModel->NodeStartChannel(0)]);
+                        ssModel->SetNodeChannelValues(0, _seqData.Read(f)[ssModel->NodeStartChannel(0)]);
                         xlColor c = ssModel->GetNodeColor(0);
                         colors.push_back(c);
                     }
@@ -4354,7 +4373,7 @@ void xLightsFrame::ConvertDataRowToEffects(wxCommandEvent& event)
                 ssModel->Reset(1, *model, strand, node);
 
                 for (size_t f = 0; f < _seqData.NumFrames(); ++f) {
-                    ssModel->SetNodeChannelValues(0, &_seqData[f][ssModel->NodeStartChannel(0)]);
+                    ssModel->SetNodeChannelValues(0, _seqData.Read(f)[ssModel->NodeStartChannel(0)]);
                     xlColor c = ssModel->GetNodeColor(0);
                     colors.push_back(c);
                 }
@@ -15,6 +15,7 @@
 //(*AppHeaders
 #include "xLightsMain.h"
 #include "render/HeadlessRenderContext.h"
+#include "render/RenderBenchmark.h"
 #include "render/TextDrawingContext.h"
 #include "graphics/wxTextDrawingContext.h"
 #include "graphics/GLContextManager.h"
@@ -1069,6 +1070,11 @@ bool xLightsApp::OnInit()
         { wxCMD_LINE_SWITCH, "h", "help", "displays help on the command line parameters", wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
         { wxCMD_LINE_SWITCH, "r", "render", "render files and exit"},
         { wxCMD_LINE_SWITCH, "hl", "headless", "render sequence(s) to fseq with no window and exit" },
+        { wxCMD_LINE_SWITCH, "bm", "benchmark", "render sequence(s) repeatedly with no window, output a JSON render profile and exit" },
+        { wxCMD_LINE_OPTION, "bi", "iterations", "render passes per sequence for --benchmark (default 3)", wxCMD_LINE_VAL_NUMBER },
+        { wxCMD_LINE_OPTION, "bj", "benchjson", "file to write the --benchmark JSON to; default: stdout" },
+        { wxCMD_LINE_SWITCH, "bnc", "benchnocache", "run --benchmark with the render cache disabled" },
+        { wxCMD_LINE_SWITCH, "bsc", "benchsharedcache", "run --benchmark with the render cache shared across sequences" },
         { wxCMD_LINE_SWITCH, "fc", "fseqcmp", "compare two .fseq files channel-for-channel and exit (0=identical)" },
         { wxCMD_LINE_SWITCH, "st", "shadertranslate", "assemble every .fs shader in the show dir to GLSL (spike) and exit" },
         { wxCMD_LINE_SWITCH, "cs", "checksequence", "run check sequence and exit" },
@@ -1257,7 +1263,7 @@ bool xLightsApp::OnInit()
             sequenceFiles.Clear();
         }
 
-        if (!parser.Found("cs") && !parser.Found("r") && !parser.Found("o") && !parser.Found("hl") && !parser.Found("fc") && !parser.Found("st") && !info.empty() && readOnlyZipFile == "")
+        if (!parser.Found("cs") && !parser.Found("r") && !parser.Found("o") && !parser.Found("hl") && !parser.Found("bm") && !parser.Found("fc") && !parser.Found("st") && !info.empty() && readOnlyZipFile == "")
         {
             wxMessageBox(info, "Information", wxICON_INFORMATION | wxOK); // pre-frame: callback not yet registered
         }
@@ -1740,9 +1746,11 @@ bool xLightsApp::OnInit()
     // ---- Headless render: no window at all. Load the show + sequence(s),
     // render to fseq, and exit. Proof that xLightsShowContext carries a full
     // render without an xLightsFrame. See HeadlessRenderContext / AGENTS.md.
-    if (parser.Found("hl")) {
+    // --benchmark shares the headless setup so it renders exactly as --headless does.
+    const bool benchmark = parser.Found("bm");
+    if (parser.Found("hl") || benchmark) {
         if (showDir.IsEmpty() || sequenceFiles.IsEmpty()) {
-            spdlog::error("--headless requires a show directory (-s <dir>) and at least one sequence file");
+            spdlog::error("{} requires a show directory (-s <dir>) and at least one sequence file", benchmark ? "--benchmark" : "--headless");
             return false;
         }
 #ifdef __APPLE__
@@ -1829,6 +1837,48 @@ bool xLightsApp::OnInit()
             mediaFolders.push_back(mediaDir.ToStdString());
         }
 
+        if (benchmark) {
+            RenderBenchmarkOptions options;
+            options.showDir = showDir.ToStdString();
+            options.mediaFolders = mediaFolders;
+            for (const auto& seq : sequenceFiles) {
+                options.sequences.push_back(seq.ToStdString());
+            }
+            long iterations = 0;
+            if (parser.Found("bi", &iterations) && iterations > 0) {
+                options.iterations = (int)iterations;
+            }
+            options.renderCache = !parser.Found("bnc");
+            options.sharedRenderCache = parser.Found("bsc");
+
+            bool ok = false;
+            std::string json;
+            {
+                RenderBenchmark bench(options);
+                ok = bench.Run();
+                json = bench.GetResults().dump(2);
+            }
+
+            wxString jsonFile;
+            if (parser.Found("bj", &jsonFile) && !jsonFile.IsEmpty()) {
+                ObtainAccessToURL(jsonFile.ToStdString(), true);
+                FILE* f = fopen(jsonFile.ToStdString().c_str(), "w");
+                if (f == nullptr) {
+                    spdlog::error("--benchmark: unable to write {}", jsonFile.ToStdString());
+                    std::exit(2);
+                }
+                fprintf(f, "%s\n", json.c_str());
+                fclose(f);
+                spdlog::info("--benchmark: wrote {}", jsonFile.ToStdString());
+            } else {
+                printf("%s\n", json.c_str());
+                fflush(stdout);
+            }
+            spdlog::info("--benchmark: done ({})", ok ? "success" : "with errors");
+            ShaderBuildStats::Dump();
+            std::exit(ok ? 0 : 1);
+        }
+
         bool allOk = true;
         {
             // Scoped so the context (render engine + job pool) tears down cleanly
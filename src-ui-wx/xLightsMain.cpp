@@ -1805,6 +1805,13 @@ xLightsFrame::xLightsFrame(wxWindow* parent, int ab, wxWindowID id, bool renderO
     spdlog::debug("Render Cache Maximum Size: {}MB.", _renderCacheMaximumSizeMB);
     _renderCache.SetMaximumSizeMB(_renderCacheMaximumSizeMB);
 
+    config->Read("xLightsRenderCacheShared", &_renderCacheShared, false);
+    spdlog::debug("Render Cache Shared Across Sequences: {}.", toStr(_renderCacheShared));
+    _renderCache.SetShareAcrossSequences(_renderCacheShared);
+
+    config->Read("xLightsRenderAheadPlayback", &_renderAheadPlayback, false);
+    spdlog::debug("Render Ahead During Playback: {}.", toStr(_renderAheadPlayback));
+
     config->Read("xLightsAutoSavePerspectives", &_autoSavePerspecive, false);
     MenuItem_PerspectiveAutosave->Check(_autoSavePerspecive);
     spdlog::debug("Autosave perspectives: {}.", toStr(_autoSavePerspecive));
@@ -2272,6 +2279,8 @@ xLightsFrame::~xLightsFrame()
     config->Write("xLightsShowACRamps", _showACRamps);
     config->Write("xLightsEnableRenderCache", _enableRenderCache);
     config->Write("xLightsRenderCacheMaxSizeMB", _renderCacheMaximumSizeMB);
+    config->Write("xLightsRenderCacheShared", _renderCacheShared);
+    config->Write("xLightsRenderAheadPlayback", _renderAheadPlayback);
     config->Write("xLightsPlayControlsOnPreview", _playControlsOnPreview);
     config->Write("xLightsShowBaseFolder", _showBaseShowFolder);
     config->Write("xLightsAutoShowHousePreview", _autoShowHousePreview);
@@ -2746,6 +2755,8 @@ void xLightsFrame::OnOutputTimerTrigger(wxTimerEvent& event)
         default:
             if (_outputManager.IsOutputting()) {
                 needTimer = true;
+                // the output thread is already sending frames
+                if (_outputScheduler.IsRunning()) break;
                 _outputManager.StartFrame(curtime);
                 _outputManager.EndFrame();
             }
@@ -3017,6 +3028,10 @@ bool xLightsFrame::ForceEnableOutputs(bool startTimer, bool skipAutoUpload)
         DisableSleepModes();
         outputting = _outputManager.StartOutput();
         if (outputting) SetConfigBool("OutputActive", true);
+        if (outputting && ::Lower(SpecialOptions::GetOption("OutputThread", "false")) == "true") {
+            // output is sent from a dedicated thread paced on absolute deadlines rather than the UI timer
+            _outputScheduler.Start(&_seqData, _seqData.FrameTime() > 0 ? _seqData.FrameTime() : 50);
+        }
         if (startTimer) {
             StartOutputTimer();
         }
@@ -3045,6 +3060,7 @@ bool xLightsFrame::EnableOutputs(bool ignoreCheck)
 bool xLightsFrame::DisableOutputs()
 {
     if (_outputManager.IsOutputting()) {
+        _outputScheduler.Stop();
         _outputManager.AllOff();
         _outputManager.StopOutput();
         SetConfigBool("OutputActive", false);
@@ -3826,7 +3842,7 @@ bool xLightsFrame::ExportVideoPreview(wxString const& path, int desiredWidth, in
             videoExporter.setGetAudioCallback(audioLambda);
         }
         auto videoLambda = [=, this](VideoWriterFrame& frame, unsigned frameIndex) {
-            const SequenceData::FrameData& frameData(this->_seqData[frameIndex]);
+            auto frameData = this->_seqData.Read(frameIndex);
             const uint8_t* data = frameData[0];
             housePreview->captureNextFrame(width * contentScaleFactor, height * contentScaleFactor);
             housePreview->Render(frameIndex * this->_seqData.FrameTime(), data, false);
@@ -6691,7 +6707,11 @@ void xLightsFrame::OnMenuItem_CleanupFileLocationsSelected(wxCommandEvent& event
 void xLightsFrame::TimerOutput(int period)
 {
     if (CheckBoxLightOutput->IsChecked()) {
-        _outputManager.SetManyChannels(0, &_seqData[period][0], _seqData.NumChannels());
+        if (_outputScheduler.IsRunning()) {
+            _outputScheduler.SetPlayPosition(period * _seqData.FrameTime(), playType == PLAY_TYPE_MODEL || playType == PLAY_TYPE_EFFECT);
+        } else {
+            _outputManager.SetManyChannels(0, (unsigned char*)_seqData.Read(period)[0], _seqData.NumChannels());
+        }
     }
 }
 
@@ -7549,13 +7569,13 @@ void xLightsFrame::OnMenuItem_GenerateLyricsSelected(wxCommandEvent& event)
             for (auto it = face.begin(); it != face.end(); ++it) {
                 bool match = true;
                 for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
-                    if (_seqData[i][*it2 - 1] == 0) {
+                    if (*_seqData.Read(i)[*it2 - 1] == 0) {
                         match = false;
                         break;
                     }
                 }
                 for (auto it2 = notface[it->first].begin(); it2 != notface[it->first].end(); ++it2) {
-                    if (_seqData[i][*it2 - 1] != 0) {
+                    if (*_seqData.Read(i)[*it2 - 1] != 0) {
                         match = false;
                         break;
                     }
@@ -8170,6 +8190,7 @@ void xLightsFrame::OnMenuItemUserDictSelected(wxCommandEvent& event)
 void xLightsFrame::OnMenuItem_PurgeRenderCacheSelected(wxCommandEvent& event)
 {
     _renderCache.Purge(&_sequenceElements, true);
+    _renderCache.PurgeShared();
 }
 
 void xLightsFrame::SetEnableRenderCache(const wxString& t)
@@ -8196,6 +8217,19 @@ void xLightsFrame::SetRenderCacheMaximumSizeMB(size_t maxSizeMB)
     _renderCache.SetMaximumSizeMB(maxSizeMB);
 }
 
+void xLightsFrame::SetRenderCacheShared(bool shared)
+{
+    if (_renderCacheShared == shared) return;
+    _renderCacheShared = shared;
+    _renderCache.SetShareAcrossSequences(shared);
+
+    if (_renderCache.IsEnabled() && CurrentSeqXmlFile != nullptr) {
+        // reopen the cache so the shared pack is opened or closed, effects drop what they hold first
+        _renderCache.Purge(&_sequenceElements, false);
+        _renderCache.SetSequence(renderCacheDirectory, CurrentSeqXmlFile->GetName());
+    }
+}
+
 bool xLightsFrame::HandleAllKeyBinding(wxKeyEvent& event)
 {
     if (mainSequencer == nullptr)
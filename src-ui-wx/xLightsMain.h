@@ -1081,6 +1081,8 @@ public:
     std::vector<std::pair<wxString, wxMenuItem*>> _toolbarMenuItems;
     wxString _enableRenderCache;
     size_t _renderCacheMaximumSizeMB = 0;
+    bool _renderCacheShared = false;
+    bool _renderAheadPlayback = false;
     bool _playControlsOnPreview = true;
     bool _showBaseShowFolder = false;
     bool _autoShowHousePreview = false;
@@ -1309,6 +1311,19 @@ public:
     {
         return _renderCacheMaximumSizeMB;
     }
+    void SetRenderCacheShared(bool shared);
+    bool RenderCacheShared() const
+    {
+        return _renderCacheShared;
+    }
+    void SetRenderAheadPlayback(bool b)
+    {
+        _renderAheadPlayback = b;
+    }
+    bool RenderAheadPlayback() const
+    {
+        return _renderAheadPlayback;
+    }
 
     bool RenderOnSave() const { return mRenderOnSave; }
     void SetRenderOnSave(bool b);
@@ -0,0 +1,118 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#ifndef _WIN32
+
+#include "../../src-core/outputs/SerialWriter.h"
+#include "../../src-core/outputs/serial.h"
+
+#include <chrono>
+#include <fcntl.h>
+#include <poll.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#ifdef __APPLE__
+#include <util.h>
+#else
+#include <pty.h>
+#endif
+
+// Drives a SerialWriter through a pty pair: the writer owns the slave end as
+// if it were a real port and the test reads what arrives at the master end.
+struct Serial_Writer_Tests : public ::testing::Test {
+    int master = -1;
+    SerialPort port;
+
+    void SetUp() override {
+        int slave = -1;
+        char name[256];
+        ASSERT_EQ(openpty(&master, &slave, name, nullptr, nullptr), 0);
+        ASSERT_GE(port.Open(name, 115200), 0);
+        close(slave);
+        fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+    }
+
+    void TearDown() override {
+        port.Close();
+        if (master >= 0) close(master);
+    }
+
+    // reads until count bytes have arrived or nothing has for timeoutMS
+    std::vector<uint8_t> ReadMaster(size_t count, int timeoutMS = 2000) {
+        std::vector<uint8_t> got;
+        uint8_t buf[4096];
+        while (got.size() < count) {
+            pollfd p = { master, POLLIN, 0 };
+            if (poll(&p, 1, timeoutMS) <= 0) break;
+            ssize_t n = read(master, buf, sizeof(buf));
+            if (n <= 0) break;
+            got.insert(got.end(), buf, buf + n);
+        }
+        return got;
+    }
+};
+
+TEST_F(Serial_Writer_Tests, WritesFramesInOrder) {
+    SerialWriter writer(&port, "pty");
+
+    std::vector<uint8_t> expected;
+    for (uint8_t f = 1; f <= 3; f++) {
+        std::vector<uint8_t> frame(100 * f, f);
+        EXPECT_TRUE(writer.Push(frame.data(), frame.size()));
+        expected.insert(expected.end(), frame.begin(), frame.end());
+    }
+
+    EXPECT_EQ(ReadMaster(expected.size()), expected);
+    EXPECT_EQ(writer.GetFramesDropped(), 0u);
+}
+
+TEST_F(Serial_Writer_Tests, DropsOldestWhenPortStalls) {
+    SerialWriter writer(&port, "pty", 2);
+
+    // frames much bigger than the pty buffer so the writer stalls on the first
+    // one while nothing reads the master end, and the ring fills up behind it
+    const size_t frameSize = 64 * 1024;
+    const int frames = 8;
+    bool anyDropped = false;
+    for (int f = 1; f <= frames; f++) {
+        std::vector<uint8_t> frame(frameSize, (uint8_t)f);
+        anyDropped |= !writer.Push(frame.data(), frame.size());
+    }
+    EXPECT_TRUE(anyDropped);
+    EXPECT_GT(writer.GetFramesDropped(), 0u);
+
+    const size_t sent = (frames - writer.GetFramesDropped()) * frameSize;
+    std::vector<uint8_t> got = ReadMaster(sent);
+    ASSERT_EQ(got.size(), sent);
+
+    // every frame that went out went out whole, oldest first, ending with the newest
+    uint8_t last = 0;
+    for (size_t i = 0; i < got.size(); i += frameSize) {
+        EXPECT_GT(got[i], last);
+        last = got[i];
+        for (size_t j = i; j < i + frameSize; j++) {
+            ASSERT_EQ(got[j], last);
+        }
+    }
+    EXPECT_EQ(last, frames);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (writer.IsBusy() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_FALSE(writer.IsBusy());
+    EXPECT_EQ(writer.GetFramesWritten() + writer.GetFramesDropped(), (uint64_t)frames);
+}
+
+#endif